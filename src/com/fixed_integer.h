@@ -0,0 +1,230 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace ns
+{
+// Signed integer of a fixed number of bits in two's complement.
+// No memory allocations, unlike mpz_class. Overflow is not checked
+template <std::size_t BITS>
+class FixedInteger final
+{
+        static_assert(BITS > 128 && BITS % 64 == 0);
+
+        static constexpr std::size_t SIZE = BITS / 64;
+
+        using Words = std::array<std::uint64_t, SIZE>;
+
+        Words words_;
+
+        static constexpr void negate(Words* const words)
+        {
+                std::uint64_t carry = 1;
+                for (std::uint64_t& w : *words)
+                {
+                        w = ~w + carry;
+                        carry = (carry != 0 && w == 0) ? 1 : 0;
+                }
+        }
+
+        [[nodiscard]] static constexpr std::size_t used_size(const Words& words)
+        {
+                std::size_t res = SIZE;
+                while (res > 0 && words[res - 1] == 0)
+                {
+                        --res;
+                }
+                return res;
+        }
+
+        [[nodiscard]] constexpr bool negative() const
+        {
+                return (words_[SIZE - 1] >> 63) != 0;
+        }
+
+        [[nodiscard]] constexpr Words magnitude() const
+        {
+                Words res = words_;
+                if (negative())
+                {
+                        negate(&res);
+                }
+                return res;
+        }
+
+public:
+        static constexpr std::size_t BIT_COUNT = BITS;
+
+        constexpr FixedInteger() = default;
+
+        template <typename T>
+                requires (
+                        std::is_integral_v<T> || std::is_same_v<std::remove_cv_t<T>, signed __int128>
+                        || std::is_same_v<std::remove_cv_t<T>, unsigned __int128>)
+        constexpr FixedInteger(const T value)
+        {
+                constexpr std::size_t VALUE_SIZE = sizeof(T) > 8 ? 2 : 1;
+
+                words_[0] = static_cast<std::uint64_t>(value);
+                if constexpr (VALUE_SIZE == 2)
+                {
+                        words_[1] = static_cast<std::uint64_t>(static_cast<unsigned __int128>(value) >> 64);
+                }
+
+                const std::uint64_t fill = (static_cast<T>(-1) < T{0} && value < 0) ? ~std::uint64_t{0} : 0;
+                for (std::size_t i = VALUE_SIZE; i < SIZE; ++i)
+                {
+                        words_[i] = fill;
+                }
+        }
+
+        template <typename T>
+                requires (std::is_floating_point_v<T>)
+        [[nodiscard]] explicit constexpr operator T() const
+        {
+                const Words m = magnitude();
+                T res = 0;
+                for (std::size_t i = SIZE; i > 0; --i)
+                {
+                        res = res * T{0x1p64} + static_cast<T>(m[i - 1]);
+                }
+                return negative() ? -res : res;
+        }
+
+        // Least significant word first
+        [[nodiscard]] constexpr const Words& words() const
+        {
+                return words_;
+        }
+
+        constexpr FixedInteger& operator+=(const FixedInteger& v)
+        {
+                std::uint64_t carry = 0;
+                for (std::size_t i = 0; i < SIZE; ++i)
+                {
+                        const unsigned __int128 s = static_cast<unsigned __int128>(words_[i]) + v.words_[i] + carry;
+                        words_[i] = static_cast<std::uint64_t>(s);
+                        carry = static_cast<std::uint64_t>(s >> 64);
+                }
+                return *this;
+        }
+
+        constexpr FixedInteger& operator-=(const FixedInteger& v)
+        {
+                std::uint64_t borrow = 0;
+                for (std::size_t i = 0; i < SIZE; ++i)
+                {
+                        const std::uint64_t a = words_[i];
+                        const std::uint64_t b = v.words_[i];
+                        words_[i] = a - b - borrow;
+                        borrow = (a < b || (a == b && borrow != 0)) ? 1 : 0;
+                }
+                return *this;
+        }
+
+        constexpr FixedInteger& operator*=(const FixedInteger& v)
+        {
+                *this = *this * v;
+                return *this;
+        }
+
+        [[nodiscard]] constexpr FixedInteger operator-() const
+        {
+                FixedInteger res = *this;
+                negate(&res.words_);
+                return res;
+        }
+
+        [[nodiscard]] friend constexpr FixedInteger operator+(FixedInteger a, const FixedInteger& b)
+        {
+                a += b;
+                return a;
+        }
+
+        [[nodiscard]] friend constexpr FixedInteger operator-(FixedInteger a, const FixedInteger& b)
+        {
+                a -= b;
+                return a;
+        }
+
+        // Products of magnitudes, only the used words
+        [[nodiscard]] friend constexpr FixedInteger operator*(const FixedInteger& a, const FixedInteger& b)
+        {
+                const Words x = a.magnitude();
+                const Words y = b.magnitude();
+                const std::size_t x_size = used_size(x);
+                const std::size_t y_size = used_size(y);
+
+                FixedInteger res(0);
+                for (std::size_t i = 0; i < x_size; ++i)
+                {
+                        std::uint64_t carry = 0;
+                        for (std::size_t j = 0; j < y_size && i + j < SIZE; ++j)
+                        {
+                                const unsigned __int128 p =
+                                        static_cast<unsigned __int128>(x[i]) * y[j] + res.words_[i + j] + carry;
+                                res.words_[i + j] = static_cast<std::uint64_t>(p);
+                                carry = static_cast<std::uint64_t>(p >> 64);
+                        }
+                        if (i + y_size < SIZE)
+                        {
+                                res.words_[i + y_size] = carry;
+                        }
+                }
+
+                if (a.negative() != b.negative())
+                {
+                        negate(&res.words_);
+                }
+                return res;
+        }
+
+        [[nodiscard]] friend constexpr bool operator==(const FixedInteger& a, const FixedInteger& b)
+        {
+                return a.words_ == b.words_;
+        }
+
+        [[nodiscard]] friend constexpr std::strong_ordering operator<=>(const FixedInteger& a, const FixedInteger& b)
+        {
+                if (a.negative() != b.negative())
+                {
+                        return a.negative() ? std::strong_ordering::less : std::strong_ordering::greater;
+                }
+                for (std::size_t i = SIZE; i > 0; --i)
+                {
+                        if (a.words_[i - 1] != b.words_[i - 1])
+                        {
+                                return a.words_[i - 1] <=> b.words_[i - 1];
+                        }
+                }
+                return std::strong_ordering::equal;
+        }
+};
+
+template <typename T>
+inline constexpr bool IS_FIXED_INTEGER = false;
+
+template <std::size_t BITS>
+inline constexpr bool IS_FIXED_INTEGER<FixedInteger<BITS>> = true;
+}
@@ -0,0 +1,581 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Open addressing with groups of control bytes, the design of
+Abseil Swiss tables and Facebook F14 hash tables.
+
+The control bytes of a group are compared at once in a 64-bit word
+(SIMD within a register), the groups are aligned and are probed
+by triangular numbers.
+*/
+
+#pragma once
+
+#include "error.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ns
+{
+namespace flat_hash_map_implementation
+{
+using Group = std::uint64_t;
+
+inline constexpr std::size_t GROUP_SIZE = sizeof(Group);
+
+inline constexpr Group LSB = 0x0101'0101'0101'0101;
+inline constexpr Group MSB = 0x8080'8080'8080'8080;
+
+// full slots have the 7 low bits of the hash
+inline constexpr std::uint8_t EMPTY = 0b1000'0000;
+inline constexpr std::uint8_t DELETED = 0b1111'1110;
+
+[[nodiscard]] constexpr bool is_full(const std::uint8_t control)
+{
+        return (control & 0b1000'0000) == 0;
+}
+
+[[nodiscard]] inline std::size_t mix(const std::size_t hash)
+{
+        const std::uint64_t h = static_cast<std::uint64_t>(hash) * 0x9E37'79B9'7F4A'7C15;
+        return h ^ (h >> 32);
+}
+
+[[nodiscard]] constexpr std::size_t h1(const std::size_t hash)
+{
+        return hash >> 7;
+}
+
+[[nodiscard]] constexpr std::uint8_t h2(const std::size_t hash)
+{
+        return hash & 0b0111'1111;
+}
+
+// the first control byte is the low byte
+[[nodiscard]] inline Group load_group(const std::uint8_t* const control)
+{
+        Group res = 0;
+        for (std::size_t i = 0; i < GROUP_SIZE; ++i)
+        {
+                res |= static_cast<Group>(control[i]) << (8 * i);
+        }
+        return res;
+}
+
+// the high bits of the bytes equal to h2.
+// False positives are possible only for full slots
+[[nodiscard]] constexpr Group match(const Group group, const std::uint8_t h2)
+{
+        const Group v = group ^ (LSB * h2);
+        return (v - LSB) & ~v & MSB;
+}
+
+[[nodiscard]] constexpr Group match_empty(const Group group)
+{
+        return group & ~(group << 6) & MSB;
+}
+
+[[nodiscard]] constexpr Group match_empty_or_deleted(const Group group)
+{
+        return group & ~(group << 7) & MSB;
+}
+
+[[nodiscard]] constexpr std::size_t first_index(const Group mask)
+{
+        return std::countr_zero(mask) / 8;
+}
+
+[[nodiscard]] constexpr Group remove_first(const Group mask)
+{
+        return mask & (mask - 1);
+}
+
+class ProbeSequence final
+{
+        std::size_t group_mask_;
+        std::size_t group_;
+        std::size_t step_ = 0;
+
+public:
+        ProbeSequence(const std::size_t hash, const std::size_t group_mask)
+                : group_mask_(group_mask),
+                  group_(hash & group_mask)
+        {
+        }
+
+        [[nodiscard]] std::size_t offset() const
+        {
+                return group_ * GROUP_SIZE;
+        }
+
+        void next()
+        {
+                ++step_;
+                group_ = (group_ + step_) & group_mask_;
+                ASSERT(step_ <= group_mask_);
+        }
+};
+
+[[nodiscard]] constexpr std::size_t max_load(const std::size_t capacity)
+{
+        return capacity - capacity / 8;
+}
+
+[[nodiscard]] constexpr std::size_t capacity_for_size(const std::size_t size)
+{
+        std::size_t res = GROUP_SIZE;
+        while (max_load(res) < size)
+        {
+                res *= 2;
+        }
+        return res;
+}
+}
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class FlatHashMap final
+{
+public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<const Key, Value>;
+        using size_type = std::size_t;
+
+private:
+        template <bool CONST>
+        class Iterator final
+        {
+                friend FlatHashMap;
+
+                template <bool>
+                friend class Iterator;
+
+                using Map = std::conditional_t<CONST, const FlatHashMap, FlatHashMap>;
+
+                Map* map_ = nullptr;
+                std::size_t index_ = 0;
+
+                Iterator(Map* const map, const std::size_t index)
+                        : map_(map),
+                          index_(index)
+                {
+                }
+
+                void skip_free()
+                {
+                        while (index_ < map_->capacity_
+                               && !flat_hash_map_implementation::is_full(map_->control_[index_]))
+                        {
+                                ++index_;
+                        }
+                }
+
+        public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = FlatHashMap::value_type;
+                using difference_type = std::ptrdiff_t;
+                using pointer = std::conditional_t<CONST, const value_type*, value_type*>;
+                using reference = std::conditional_t<CONST, const value_type&, value_type&>;
+
+                Iterator() = default;
+
+                operator Iterator<true>() const
+                        requires (!CONST)
+                {
+                        return {map_, index_};
+                }
+
+                [[nodiscard]] reference operator*() const
+                {
+                        return map_->slots_[index_];
+                }
+
+                [[nodiscard]] pointer operator->() const
+                {
+                        return &map_->slots_[index_];
+                }
+
+                Iterator& operator++()
+                {
+                        ++index_;
+                        skip_free();
+                        return *this;
+                }
+
+                Iterator operator++(int)
+                {
+                        Iterator res = *this;
+                        ++*this;
+                        return res;
+                }
+
+                template <bool C>
+                [[nodiscard]] bool operator==(const Iterator<C>& iter) const
+                {
+                        return index_ == iter.index_;
+                }
+        };
+
+public:
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+private:
+        std::vector<std::uint8_t> control_;
+        value_type* slots_ = nullptr;
+        std::size_t capacity_ = 0;
+        std::size_t size_ = 0;
+        std::size_t growth_left_ = 0;
+        [[no_unique_address]] Hash hasher_;
+
+        [[nodiscard]] std::size_t hash(const Key& key) const
+        {
+                return flat_hash_map_implementation::mix(hasher_(key));
+        }
+
+        [[nodiscard]] std::size_t group_mask() const
+        {
+                return capacity_ / flat_hash_map_implementation::GROUP_SIZE - 1;
+        }
+
+        [[nodiscard]] std::size_t find_index(const Key& key, const std::size_t hash) const
+        {
+                namespace impl = flat_hash_map_implementation;
+
+                if (capacity_ == 0)
+                {
+                        return capacity_;
+                }
+
+                const std::uint8_t h2 = impl::h2(hash);
+
+                impl::ProbeSequence probe(impl::h1(hash), group_mask());
+                while (true)
+                {
+                        const std::size_t offset = probe.offset();
+                        const impl::Group group = impl::load_group(&control_[offset]);
+
+                        for (impl::Group m = impl::match(group, h2); m != 0; m = impl::remove_first(m))
+                        {
+                                const std::size_t index = offset + impl::first_index(m);
+                                if (slots_[index].first == key)
+                                {
+                                        return index;
+                                }
+                        }
+
+                        if (impl::match_empty(group) != 0)
+                        {
+                                return capacity_;
+                        }
+
+                        probe.next();
+                }
+        }
+
+        [[nodiscard]] std::size_t find_free_index(const std::size_t hash) const
+        {
+                namespace impl = flat_hash_map_implementation;
+
+                impl::ProbeSequence probe(impl::h1(hash), group_mask());
+                while (true)
+                {
+                        const std::size_t offset = probe.offset();
+                        const impl::Group mask = impl::match_empty_or_deleted(impl::load_group(&control_[offset]));
+                        if (mask != 0)
+                        {
+                                return offset + impl::first_index(mask);
+                        }
+                        probe.next();
+                }
+        }
+
+        void destroy()
+        {
+                if (!slots_)
+                {
+                        return;
+                }
+
+                if constexpr (!std::is_trivially_destructible_v<value_type>)
+                {
+                        for (std::size_t i = 0; i < capacity_; ++i)
+                        {
+                                if (flat_hash_map_implementation::is_full(control_[i]))
+                                {
+                                        std::destroy_at(&slots_[i]);
+                                }
+                        }
+                }
+
+                std::allocator<value_type>().deallocate(slots_, capacity_);
+                slots_ = nullptr;
+        }
+
+        void rehash(const std::size_t capacity)
+        {
+                namespace impl = flat_hash_map_implementation;
+
+                ASSERT(std::has_single_bit(capacity) && capacity >= impl::GROUP_SIZE);
+                ASSERT(impl::max_load(capacity) >= size_);
+
+                const std::vector<std::uint8_t> old_control =
+                        std::exchange(control_, std::vector<std::uint8_t>(capacity, impl::EMPTY));
+                value_type* const old_slots = std::exchange(slots_, std::allocator<value_type>().allocate(capacity));
+                const std::size_t old_capacity = std::exchange(capacity_, capacity);
+
+                for (std::size_t i = 0; i < old_capacity; ++i)
+                {
+                        if (!impl::is_full(old_control[i]))
+                        {
+                                continue;
+                        }
+                        const std::size_t index = find_free_index(hash(old_slots[i].first));
+                        control_[index] = old_control[i];
+                        std::construct_at(&slots_[index], std::move(old_slots[i]));
+                        std::destroy_at(&old_slots[i]);
+                }
+
+                if (old_slots)
+                {
+                        std::allocator<value_type>().deallocate(old_slots, old_capacity);
+                }
+
+                growth_left_ = impl::max_load(capacity_) - size_;
+        }
+
+        void prepare_insert()
+        {
+                namespace impl = flat_hash_map_implementation;
+
+                if (growth_left_ > 0)
+                {
+                        return;
+                }
+
+                if (capacity_ > 0 && 2 * (size_ + 1) <= impl::max_load(capacity_))
+                {
+                        // most of the used slots are deleted
+                        rehash(capacity_);
+                        return;
+                }
+
+                rehash(impl::capacity_for_size(std::max(size_ + 1, 2 * capacity_)));
+        }
+
+public:
+        FlatHashMap() = default;
+
+        explicit FlatHashMap(const std::size_t expected_size)
+        {
+                reserve(expected_size);
+        }
+
+        FlatHashMap(const FlatHashMap&) = delete;
+        FlatHashMap& operator=(const FlatHashMap&) = delete;
+
+        FlatHashMap(FlatHashMap&& map) noexcept
+                : control_(std::move(map.control_)),
+                  slots_(std::exchange(map.slots_, nullptr)),
+                  capacity_(std::exchange(map.capacity_, 0)),
+                  size_(std::exchange(map.size_, 0)),
+                  growth_left_(std::exchange(map.growth_left_, 0)),
+                  hasher_(std::move(map.hasher_))
+        {
+        }
+
+        FlatHashMap& operator=(FlatHashMap&& map) noexcept
+        {
+                if (this != &map)
+                {
+                        destroy();
+                        control_ = std::move(map.control_);
+                        slots_ = std::exchange(map.slots_, nullptr);
+                        capacity_ = std::exchange(map.capacity_, 0);
+                        size_ = std::exchange(map.size_, 0);
+                        growth_left_ = std::exchange(map.growth_left_, 0);
+                        hasher_ = std::move(map.hasher_);
+                }
+                return *this;
+        }
+
+        ~FlatHashMap()
+        {
+                destroy();
+        }
+
+        void reserve(const std::size_t size)
+        {
+                const std::size_t capacity = flat_hash_map_implementation::capacity_for_size(size);
+                if (capacity > capacity_)
+                {
+                        rehash(capacity);
+                }
+        }
+
+        [[nodiscard]] std::size_t size() const
+        {
+                return size_;
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+                return size_ == 0;
+        }
+
+        [[nodiscard]] iterator begin()
+        {
+                iterator res(this, 0);
+                res.skip_free();
+                return res;
+        }
+
+        [[nodiscard]] iterator end()
+        {
+                return {this, capacity_};
+        }
+
+        [[nodiscard]] const_iterator begin() const
+        {
+                const_iterator res(this, 0);
+                res.skip_free();
+                return res;
+        }
+
+        [[nodiscard]] const_iterator end() const
+        {
+                return {this, capacity_};
+        }
+
+        [[nodiscard]] const_iterator cbegin() const
+        {
+                return begin();
+        }
+
+        [[nodiscard]] const_iterator cend() const
+        {
+                return end();
+        }
+
+        [[nodiscard]] iterator find(const Key& key)
+        {
+                return {this, find_index(key, hash(key))};
+        }
+
+        [[nodiscard]] const_iterator find(const Key& key) const
+        {
+                return {this, find_index(key, hash(key))};
+        }
+
+        [[nodiscard]] bool contains(const Key& key) const
+        {
+                return find_index(key, hash(key)) != capacity_;
+        }
+
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+        {
+                namespace impl = flat_hash_map_implementation;
+
+                const std::size_t key_hash = hash(key);
+
+                const std::size_t found = find_index(key, key_hash);
+                if (found != capacity_)
+                {
+                        return {iterator(this, found), false};
+                }
+
+                prepare_insert();
+
+                const std::size_t index = find_free_index(key_hash);
+                if (control_[index] == impl::EMPTY)
+                {
+                        ASSERT(growth_left_ > 0);
+                        --growth_left_;
+                }
+                std::construct_at(
+                        &slots_[index], std::piecewise_construct, std::forward_as_tuple(key),
+                        std::forward_as_tuple(std::forward<Args>(args)...));
+                control_[index] = impl::h2(key_hash);
+                ++size_;
+
+                return {iterator(this, index), true};
+        }
+
+        template <typename V>
+        std::pair<iterator, bool> emplace(const Key& key, V&& value)
+        {
+                return try_emplace(key, std::forward<V>(value));
+        }
+
+        void erase(const const_iterator iter)
+        {
+                namespace impl = flat_hash_map_implementation;
+
+                const std::size_t index = iter.index_;
+
+                ASSERT(index < capacity_ && impl::is_full(control_[index]));
+
+                std::destroy_at(&slots_[index]);
+                --size_;
+
+                // the groups are aligned, a probe sequence ends
+                // at a group with an empty slot
+                const std::size_t offset = index - index % impl::GROUP_SIZE;
+                if (impl::match_empty(impl::load_group(&control_[offset])) != 0)
+                {
+                        control_[index] = impl::EMPTY;
+                        ++growth_left_;
+                }
+                else
+                {
+                        control_[index] = impl::DELETED;
+                }
+        }
+
+        std::size_t erase(const Key& key)
+        {
+                const const_iterator iter = find(key);
+                if (iter == cend())
+                {
+                        return 0;
+                }
+                erase(iter);
+                return 1;
+        }
+
+        void clear()
+        {
+                destroy();
+                control_.clear();
+                capacity_ = 0;
+                size_ = 0;
+                growth_left_ = 0;
+        }
+};
+}
@@ -0,0 +1,75 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "memory.h"
+
+#ifdef __linux__
+
+#include <src/com/error.h>
+
+#include <cstddef>
+
+#include <unistd.h>
+
+namespace ns
+{
+std::size_t physical_memory_size()
+{
+        const long pages = ::sysconf(_SC_PHYS_PAGES);
+        if (pages <= 0)
+        {
+                error("error sysconf _SC_PHYS_PAGES");
+        }
+
+        const long page_size = ::sysconf(_SC_PAGE_SIZE);
+        if (page_size <= 0)
+        {
+                error("error sysconf _SC_PAGE_SIZE");
+        }
+
+        return static_cast<std::size_t>(pages) * static_cast<std::size_t>(page_size);
+}
+}
+
+#elifdef _WIN32
+
+#include <src/com/error.h>
+
+#include <cstddef>
+
+#include <windows.h>
+
+namespace ns
+{
+std::size_t physical_memory_size()
+{
+        MEMORYSTATUSEX status;
+        status.dwLength = sizeof(status);
+        if (!::GlobalMemoryStatusEx(&status))
+        {
+                error("error GlobalMemoryStatusEx");
+        }
+
+        return status.ullTotalPhys;
+}
+}
+
+#else
+
+#error This operating system is not supported
+
+#endif
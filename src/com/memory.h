@@ -17,17 +17,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
-#include <src/model/mesh.h>
-#include <src/model/mesh_object.h>
-#include <src/numerical/vector.h>
-
 #include <cstddef>
-#include <optional>
 
-namespace ns::painter::shapes::mesh
+namespace ns
 {
-template <std::size_t N, typename T>
-[[nodiscard]] model::mesh::Mesh<N> optimize_mesh(
-        const model::mesh::Reading<N>& mesh_object,
-        const std::optional<numerical::Vector<N + 1, T>>& clip_plane_equation);
+[[nodiscard]] std::size_t physical_memory_size();
 }
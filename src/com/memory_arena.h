@@ -75,6 +75,8 @@ class MemoryArena final
                 return new (block->data(index)) T(std::forward<Args>(args)...);
         }
 
+        inline static thread_local MemoryArena* thread_arena_ = nullptr;
+
         const std::thread::id thread_id_ = std::this_thread::get_id();
 
         std::vector<std::unique_ptr<Block>> blocks_;
@@ -88,8 +90,42 @@ class MemoryArena final
         }
 
 public:
+        // Objects created in the scope are allocated in the specified arena
+        // instead of the thread local arena
+        class Scope final
+        {
+                MemoryArena* previous_;
+
+        public:
+                explicit Scope(MemoryArena* const memory_arena)
+                        : previous_(thread_arena_)
+                {
+                        ASSERT(memory_arena && std::this_thread::get_id() == memory_arena->thread_id_);
+                        thread_arena_ = memory_arena;
+                }
+
+                ~Scope()
+                {
+                        thread_arena_ = previous_;
+                }
+
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+                Scope(Scope&&) = delete;
+                Scope& operator=(Scope&&) = delete;
+        };
+
+        [[nodiscard]] static std::unique_ptr<MemoryArena> create()
+        {
+                return std::unique_ptr<MemoryArena>(new MemoryArena());
+        }
+
         static MemoryArena& thread_local_instance()
         {
+                if (thread_arena_)
+                {
+                        return *thread_arena_;
+                }
                 static thread_local MemoryArena memory_arena;
                 return memory_arena;
         }
@@ -50,6 +50,16 @@ public:
 
         explicit PCG(result_type value);
 
+        // PCG stream selection, no allocation and no seed sequence
+        PCG(const std::uint64_t seed, const std::uint64_t stream)
+                : state_(0),
+                  increment_((stream << 1) | 1)
+        {
+                operator()();
+                state_ += seed;
+                operator()();
+        }
+
         [[nodiscard]] result_type operator()()
         {
                 constexpr std::uint64_t MULTIPLIER = 6'364136'223846'793005;
@@ -0,0 +1,129 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <src/com/error.h>
+#include <src/com/fixed_integer.h>
+#include <src/com/print.h>
+#include <src/com/random/pcg.h>
+#include <src/com/set_mpz.h>
+#include <src/test/test.h>
+
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include <cmath>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+namespace ns
+{
+namespace
+{
+template <std::size_t BITS>
+mpz_class to_mpz(const FixedInteger<BITS>& v)
+{
+        mpz_class res;
+        mpz_import(res.get_mpz_t(), v.words().size(), -1, sizeof(std::uint64_t), 0, 0, v.words().data());
+        if (mpz_tstbit(res.get_mpz_t(), BITS - 1))
+        {
+                mpz_class power;
+                mpz_ui_pow_ui(power.get_mpz_t(), 2, BITS);
+                res -= power;
+        }
+        return res;
+}
+
+template <std::size_t BITS>
+void compare(const std::string& name, const FixedInteger<BITS>& v, const mpz_class& mpz)
+{
+        if (to_mpz(v) != mpz)
+        {
+                error("Fixed integer " + name + " error, " + to_mpz(v).get_str() + " is not equal to "
+                      + mpz.get_str());
+        }
+}
+
+// Random value with the bit count less than half of the integer
+template <std::size_t BITS>
+FixedInteger<BITS> random_value(PCG& engine)
+{
+        const int bit_count = std::uniform_int_distribution<int>(0, BITS / 2 - 33)(engine);
+
+        FixedInteger<BITS> res(0);
+        for (int i = 0; i < bit_count; i += 32)
+        {
+                res *= FixedInteger<BITS>(std::uint64_t{1} << 32);
+                res += FixedInteger<BITS>(engine());
+        }
+        return (engine() & 1) ? -res : res;
+}
+
+template <std::size_t BITS>
+void test(const int count)
+{
+        PCG engine;
+
+        for (int i = 0; i < count; ++i)
+        {
+                const FixedInteger<BITS> a = random_value<BITS>(engine);
+                const FixedInteger<BITS> b = random_value<BITS>(engine);
+                const mpz_class a_mpz = to_mpz(a);
+                const mpz_class b_mpz = to_mpz(b);
+
+                compare("sum", a + b, a_mpz + b_mpz);
+                compare("difference", a - b, a_mpz - b_mpz);
+                compare("product", a * b, a_mpz * b_mpz);
+                compare("negation", -a, -a_mpz);
+
+                if ((a <=> b) != (cmp(a_mpz, b_mpz) <=> 0))
+                {
+                        error("Fixed integer comparison error, " + a_mpz.get_str() + ", " + b_mpz.get_str());
+                }
+
+                const double d = static_cast<double>(a);
+                const double d_mpz = a_mpz.get_d();
+                if (!(std::abs(d - d_mpz) <= std::abs(d_mpz) * 1e-15))
+                {
+                        error("Fixed integer conversion error, " + to_string(d) + " is not equal to "
+                              + to_string(d_mpz));
+                }
+        }
+
+        {
+                const __int128 v = -(static_cast<__int128>(0x7000'FFFF'FFFF'FFFF) << 64);
+                mpz_class mpz;
+                set_mpz(&mpz, v);
+                compare("conversion", FixedInteger<BITS>(v), mpz);
+        }
+}
+
+void test_fixed_integer()
+{
+        constexpr int COUNT = 10'000;
+
+        test<192>(COUNT);
+        test<256>(COUNT);
+        test<384>(COUNT);
+        test<512>(COUNT);
+}
+
+TEST_SMALL("Fixed Integer", test_fixed_integer)
+}
+}
@@ -0,0 +1,131 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <src/com/error.h>
+#include <src/com/flat_hash_map.h>
+#include <src/com/print.h>
+#include <src/com/random/pcg.h>
+#include <src/test/test.h>
+
+#include <cstddef>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace ns
+{
+namespace
+{
+using Map = FlatHashMap<int, std::vector<int>>;
+using CheckMap = std::unordered_map<int, std::vector<int>>;
+
+void compare(const Map& map, const CheckMap& check_map)
+{
+        if (map.size() != check_map.size())
+        {
+                error("Map size " + to_string(map.size()) + " is not equal to " + to_string(check_map.size()));
+        }
+
+        std::size_t count = 0;
+        for (const auto& [key, value] : map)
+        {
+                const auto iter = check_map.find(key);
+                if (iter == check_map.cend() || iter->second != value)
+                {
+                        error("Map value error for key " + to_string(key));
+                }
+                ++count;
+        }
+
+        if (count != check_map.size())
+        {
+                error("Map iteration count " + to_string(count) + " is not equal to " + to_string(check_map.size()));
+        }
+}
+
+void test_map(const int key_count, const int operation_count, const std::size_t expected_size, PCG& engine)
+{
+        std::uniform_int_distribution<int> key_distribution(-key_count, key_count);
+        std::uniform_int_distribution<int> operation_distribution(0, 2);
+
+        Map map(expected_size);
+        CheckMap check_map;
+
+        for (int i = 0; i < operation_count; ++i)
+        {
+                const int key = key_distribution(engine);
+                switch (operation_distribution(engine))
+                {
+                case 0:
+                case 1:
+                {
+                        const auto [iter, inserted] = map.try_emplace(key, 1, i);
+                        const auto [check_iter, check_inserted] = check_map.try_emplace(key, 1, i);
+                        if (inserted != check_inserted || iter->first != key || iter->second != check_iter->second)
+                        {
+                                error("Map insertion error for key " + to_string(key));
+                        }
+                        iter->second.push_back(i);
+                        check_iter->second.push_back(i);
+                        break;
+                }
+                case 2:
+                {
+                        const auto iter = map.find(key);
+                        if ((iter == map.cend()) != !check_map.contains(key))
+                        {
+                                error("Map find error for key " + to_string(key));
+                        }
+                        if (iter != map.cend())
+                        {
+                                map.erase(iter);
+                                check_map.erase(key);
+                        }
+                        break;
+                }
+                }
+        }
+
+        compare(map, check_map);
+
+        for (const auto& [key, value] : check_map)
+        {
+                if (map.erase(key) != 1)
+                {
+                        error("Map erase error for key " + to_string(key));
+                }
+        }
+
+        if (!map.empty() || map.begin() != map.end())
+        {
+                error("Map is not empty after erasing all keys");
+        }
+}
+
+void test()
+{
+        PCG engine;
+
+        test_map(10, 1'000, 0, engine);
+        test_map(1'000, 100'000, 0, engine);
+        test_map(1'000, 100'000, 1'000, engine);
+        test_map(100'000, 1'000'000, 0, engine);
+}
+
+TEST_SMALL("Flat Hash Map", test)
+}
+}
@@ -16,9 +16,19 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <src/com/error.h>
+#include <src/com/print.h>
+#include <src/com/random/pcg.h>
+#include <src/com/thread.h>
 #include <src/com/union_find.h>
+#include <src/com/union_find_concurrent.h>
 #include <src/test/test.h>
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <random>
+#include <vector>
+
 namespace ns
 {
 namespace
@@ -39,20 +49,85 @@ void check_false(const bool v)
         }
 }
 
+template <typename T>
+void test_connections(T* const uf)
+{
+        check_true(uf->add_connection(0, 1));
+        check_true(uf->add_connection(1, 2));
+        check_true(uf->add_connection(2, 3));
+        check_true(uf->add_connection(4, 5));
+        check_true(uf->add_connection(6, 7));
+        check_true(uf->add_connection(2, 7));
+
+        check_false(uf->add_connection(1, 3));
+        check_false(uf->add_connection(0, 6));
+        check_false(uf->add_connection(1, 7));
+}
+
+// the number of connections is independent of the order
+void test_concurrent()
+{
+        constexpr int COUNT = 100'000;
+        constexpr std::size_t CHUNK_SIZE = 1'000;
+
+        const std::vector<std::array<int, 2>> pairs = []
+        {
+                PCG engine;
+                std::uniform_int_distribution<int> uid(0, COUNT - 1);
+                std::vector<std::array<int, 2>> res(COUNT);
+                for (std::array<int, 2>& pair : res)
+                {
+                        pair = {uid(engine), uid(engine)};
+                }
+                return res;
+        }();
+
+        int count = 0;
+        UnionFind<int> uf(COUNT);
+        for (const std::array<int, 2>& pair : pairs)
+        {
+                count += uf.add_connection(pair[0], pair[1]) ? 1 : 0;
+        }
+
+        std::atomic_int concurrent_count = 0;
+        UnionFindConcurrent<int> ufc(COUNT);
+        run_in_chunks(
+                pairs.size(), CHUNK_SIZE,
+                [&](const std::size_t begin, const std::size_t end)
+                {
+                        for (std::size_t i = begin; i < end; ++i)
+                        {
+                                if (ufc.add_connection(pairs[i][0], pairs[i][1]))
+                                {
+                                        ++concurrent_count;
+                                }
+                        }
+                });
+
+        if (count != concurrent_count)
+        {
+                error("Concurrent connection count " + to_string(concurrent_count.load())
+                      + " is not equal to connection count " + to_string(count));
+        }
+
+        for (const std::array<int, 2>& pair : pairs)
+        {
+                check_false(ufc.add_connection(pair[0], pair[1]));
+        }
+}
+
 void test()
 {
-        UnionFind<int> uf(10);
-
-        check_true(uf.add_connection(0, 1));
-        check_true(uf.add_connection(1, 2));
-        check_true(uf.add_connection(2, 3));
-        check_true(uf.add_connection(4, 5));
-        check_true(uf.add_connection(6, 7));
-        check_true(uf.add_connection(2, 7));
-
-        check_false(uf.add_connection(1, 3));
-        check_false(uf.add_connection(0, 6));
-        check_false(uf.add_connection(1, 7));
+        {
+                UnionFind<int> uf(10);
+                test_connections(&uf);
+        }
+        {
+                UnionFindConcurrent<int> uf(10);
+                test_connections(&uf);
+        }
+
+        test_concurrent();
 }
 
 TEST_SMALL("Union-Find", test)
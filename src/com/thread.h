@@ -194,6 +194,29 @@ void run_in_threads(const F& f, const std::size_t count)
         }
 }
 
+// The indices from 0 to size are divided into chunks,
+// the function is called with the begin and end of each chunk
+template <typename F>
+void run_in_chunks(const std::size_t size, const std::size_t chunk_size, const F& f)
+{
+        ASSERT(chunk_size > 0);
+
+        const std::size_t chunk_count = (size + chunk_size - 1) / chunk_size;
+
+        run_in_threads(
+                [&](std::atomic_size_t& task)
+                {
+                        std::size_t chunk = 0;
+                        while ((chunk = task++) < chunk_count)
+                        {
+                                const std::size_t begin = chunk * chunk_size;
+                                const std::size_t end = std::min(begin + chunk_size, size);
+                                f(begin, end);
+                        }
+                },
+                chunk_count);
+}
+
 inline void join_thread(std::thread* const thread) noexcept
 {
         ASSERT(thread);
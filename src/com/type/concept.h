@@ -17,6 +17,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <src/com/fixed_integer.h>
+
 #include <gmpxx.h>
 
 #include <type_traits>
@@ -26,7 +28,8 @@ namespace ns
 template <typename T>
 concept Integral =
         (std::is_integral_v<T>) || (std::is_same_v<std::remove_cv_t<T>, unsigned __int128>)
-        || (std::is_same_v<std::remove_cv_t<T>, signed __int128>) || (std::is_same_v<std::remove_cv_t<T>, mpz_class>);
+        || (std::is_same_v<std::remove_cv_t<T>, signed __int128>) || (std::is_same_v<std::remove_cv_t<T>, mpz_class>)
+        || (IS_FIXED_INTEGER<std::remove_cv_t<T>>);
 
 template <typename T>
 concept FloatingPoint = (std::is_floating_point_v<T>) || (std::is_same_v<std::remove_cv_t<T>, __float128>);
@@ -34,7 +37,8 @@ concept FloatingPoint = (std::is_floating_point_v<T>) || (std::is_same_v<std::re
 template <typename T>
 concept Signed =
         (std::is_signed_v<T>) || (std::is_same_v<std::remove_cv_t<T>, __int128>)
-        || (std::is_same_v<std::remove_cv_t<T>, __float128>) || (std::is_same_v<std::remove_cv_t<T>, mpz_class>);
+        || (std::is_same_v<std::remove_cv_t<T>, __float128>) || (std::is_same_v<std::remove_cv_t<T>, mpz_class>)
+        || (IS_FIXED_INTEGER<std::remove_cv_t<T>>);
 
 template <typename T>
 concept Unsigned = (std::is_unsigned_v<T>) || (std::is_same_v<std::remove_cv_t<T>, unsigned __int128>);
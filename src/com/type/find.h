@@ -17,6 +17,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <src/com/fixed_integer.h>
+
 #include <gmpxx.h>
 
 #include <cstdint>
@@ -32,7 +34,11 @@ using LeastSignedInteger =
         std::conditional_t<BIT_COUNT <=  31, std::int_least32_t,
         std::conditional_t<BIT_COUNT <=  63, std::int_least64_t,
         std::conditional_t<BIT_COUNT <= 127, signed __int128,
-        mpz_class>>>>>;
+        std::conditional_t<BIT_COUNT <= 191, FixedInteger<192>,
+        std::conditional_t<BIT_COUNT <= 255, FixedInteger<256>,
+        std::conditional_t<BIT_COUNT <= 383, FixedInteger<384>,
+        std::conditional_t<BIT_COUNT <= 511, FixedInteger<512>,
+        mpz_class>>>>>>>>>;
 
 template<unsigned BIT_COUNT>
 using LeastUnsignedInteger =
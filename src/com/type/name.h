@@ -19,6 +19,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "limit.h"
 
+#include <src/com/fixed_integer.h>
+
 #include <array>
 #include <bit>
 #include <cstddef>
@@ -285,6 +287,18 @@ template <typename T>
         }
 }
 
+template <typename T>
+        requires (IS_FIXED_INTEGER<std::remove_cv_t<T>>)
+[[nodiscard]] const char* type_bit_name()
+{
+        static constexpr std::size_t SIZE = T::BIT_COUNT;
+        static_assert(SIZE >= 100 && SIZE <= 999);
+
+        static constexpr std::array STR = std::to_array<char>(
+                {'i', 'n', 't', '0' + (SIZE / 100), '0' + ((SIZE % 100) / 10), '0' + (SIZE % 10), 0});
+        return STR.data();
+}
+
 //
 
 template <typename T>
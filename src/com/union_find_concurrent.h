@@ -0,0 +1,100 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Siddhartha V. Jayanti, Robert E. Tarjan.
+A Randomized Concurrent Algorithm for Disjoint Set Union.
+PODC 2016.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ns
+{
+// Linking by index with compare-and-swap and path halving.
+// The only shared data are the parent indices, so relaxed
+// memory order is sufficient.
+template <typename T>
+class UnionFindConcurrent final
+{
+        static_assert(std::is_integral_v<T>);
+        static_assert(std::atomic<T>::is_always_lock_free);
+
+        std::vector<std::atomic<T>> parent_;
+
+public:
+        explicit UnionFindConcurrent(const std::type_identity_t<T> count)
+                : parent_(count)
+        {
+                for (std::size_t i = 0; i < parent_.size(); ++i)
+                {
+                        parent_[i].store(i, std::memory_order_relaxed);
+                }
+        }
+
+        [[nodiscard]] T find(T p)
+        {
+                while (true)
+                {
+                        T parent = parent_[p].load(std::memory_order_relaxed);
+                        if (parent == p)
+                        {
+                                return p;
+                        }
+
+                        const T grandparent = parent_[parent].load(std::memory_order_relaxed);
+                        if (grandparent != parent)
+                        {
+                                parent_[p].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+                        }
+
+                        p = grandparent;
+                }
+        }
+
+        bool add_connection(T p, T q)
+        {
+                while (true)
+                {
+                        p = find(p);
+                        q = find(q);
+
+                        if (p == q)
+                        {
+                                return false;
+                        }
+
+                        if (p > q)
+                        {
+                                std::swap(p, q);
+                        }
+
+                        T expected = p;
+                        if (parent_[p].compare_exchange_strong(expected, q, std::memory_order_relaxed))
+                        {
+                                return true;
+                        }
+                }
+        }
+};
+}
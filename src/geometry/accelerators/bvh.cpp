@@ -19,19 +19,44 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "bvh_build.h"
 #include "bvh_object.h"
+#include "bvh_quantized.h"
+#include "bvh_ray.h"
+#include "bvh_report.h"
+#include "bvh_spatial_split.h"
 
+#include <src/com/enum.h>
 #include <src/com/error.h>
+#include <src/com/print.h>
+#include <src/geometry/spatial/bounding_box.h>
+#include <src/numerical/vector.h>
 #include <src/progress/progress.h>
 #include <src/settings/instantiation.h>
 
+#include <array>
 #include <cstddef>
 #include <span>
+#include <utility>
 #include <vector>
 
 namespace ns::geometry::accelerators
 {
 namespace
 {
+template <std::size_t N, typename T>
+[[nodiscard]] spatial::BoundingBox<N, typename BvhRay<N, T>::B> round_outward(const spatial::BoundingBox<N, T>& bounds)
+{
+        using B = BvhRay<N, T>::B;
+
+        numerical::Vector<N, B> min;
+        numerical::Vector<N, B> max;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                min[i] = bvh_ray_implementation::round_down<B>(bounds.min()[i]);
+                max[i] = bvh_ray_implementation::round_up<B>(bounds.max()[i]);
+        }
+        return {min, max};
+}
+
 template <std::size_t N, typename T, typename Node>
 unsigned make_depth_first_order(
         const BvhBuild<N, T>& build,
@@ -44,7 +69,7 @@ unsigned make_depth_first_order(
 
         const BvhBuildNode<N, T>& src = build.nodes()[src_index];
 
-        dst.bounds = src.bounds;
+        dst.bounds = round_outward(src.bounds);
         if (src.object_index_count == 0)
         {
                 dst.object_count = 0;
@@ -65,24 +90,199 @@ unsigned make_depth_first_order(
         }
         return dst_index;
 }
-}
 
-template <std::size_t N, typename T>
-Bvh<N, T>::Bvh(std::vector<BvhObject<N, T>>&& objects, progress::Ratio* const progress)
+template <std::size_t N, typename T, typename Node>
+void make_nodes(
+        const BvhBuild<N, T>& build,
+        std::vector<unsigned>* const object_indices,
+        std::vector<Node>* const nodes)
 {
-        const BvhBuild build(std::span(std::data(objects), std::size(objects)), progress);
-
         ASSERT(!build.object_indices().empty());
         ASSERT(!build.nodes().empty());
 
-        object_indices_.reserve(build.object_indices().size());
-        nodes_.reserve(build.nodes().size());
+        object_indices->reserve(build.object_indices().size());
+        nodes->reserve(build.nodes().size());
 
         constexpr unsigned ROOT = 0;
-        make_depth_first_order(build, ROOT, &object_indices_, &nodes_);
+        make_depth_first_order(build, ROOT, object_indices, nodes);
+
+        ASSERT(object_indices->size() == build.object_indices().size());
+        ASSERT(nodes->size() == build.nodes().size());
+}
+
+template <std::size_t N, typename T>
+[[nodiscard]] BvhReport make_report(
+        const std::vector<bvh_implementation::Node<N, T>>& nodes,
+        const std::vector<unsigned>& object_indices,
+        const T sah_cost)
+{
+        BvhReport res;
+
+        res.sah_cost = sah_cost;
+        res.node_count = nodes.size();
+        res.leaf_count = 0;
+        res.object_count = object_indices.size();
+        res.memory_size =
+                nodes.size() * sizeof(bvh_implementation::Node<N, T>) + object_indices.size() * sizeof(unsigned);
+
+        double overlap_sum = 0;
+        std::size_t interior_count = 0;
+
+        std::vector<std::pair<unsigned, unsigned>> stack;
+        stack.emplace_back(0, 0);
+        while (!stack.empty())
+        {
+                const auto [index, depth] = stack.back();
+                stack.pop_back();
+
+                const bvh_implementation::Node<N, T>& node = nodes[index];
+
+                if (node.object_count > 0)
+                {
+                        ++res.leaf_count;
+                        if (res.leaf_sizes.size() <= node.object_count)
+                        {
+                                res.leaf_sizes.resize(node.object_count + 1, 0);
+                        }
+                        ++res.leaf_sizes[node.object_count];
+                        if (res.leaf_depths.size() <= depth)
+                        {
+                                res.leaf_depths.resize(depth + 1, 0);
+                        }
+                        ++res.leaf_depths[depth];
+                        continue;
+                }
+
+                const unsigned first = index + 1;
+                const unsigned second = node.second_child_offset;
+
+                const auto surface = node.bounds.surface();
+                if (surface > 0)
+                {
+                        overlap_sum += bvh_overlap_surface(nodes[first].bounds, nodes[second].bounds) / surface;
+                }
+                ++interior_count;
+
+                stack.emplace_back(first, depth + 1);
+                stack.emplace_back(second, depth + 1);
+        }
+
+        res.overlap_ratio = interior_count > 0 ? overlap_sum / interior_count : 0;
+
+        return res;
+}
+
+template <std::size_t N, typename T>
+[[nodiscard]] std::vector<BvhQuantizedNode<N, T>> quantize_nodes(
+        const std::vector<bvh_implementation::Node<N, T>>& nodes)
+{
+        ASSERT(nodes.size() > 1);
+
+        // Quantized nodes are interior nodes in the same order
+        std::vector<unsigned> indices(nodes.size());
+        unsigned count = 0;
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
+                if (nodes[i].object_count == 0)
+                {
+                        indices[i] = count++;
+                }
+        }
+
+        std::vector<BvhQuantizedNode<N, T>> res(count);
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
+                const bvh_implementation::Node<N, T>& node = nodes[i];
+                if (node.object_count > 0)
+                {
+                        continue;
+                }
+
+                BvhQuantizedNode<N, T>& quantized = res[indices[i]];
+                quantized.axis = node.axis;
+
+                const std::array<unsigned, 2> children{static_cast<unsigned>(i + 1), node.second_child_offset};
+                for (std::size_t c = 0; c < 2; ++c)
+                {
+                        const bvh_implementation::Node<N, T>& child = nodes[children[c]];
+                        if (child.object_count > 0)
+                        {
+                                quantized.object_counts[c] = child.object_count;
+                                quantized.offsets[c] = child.object_offset;
+                        }
+                        else
+                        {
+                                quantized.object_counts[c] = 0;
+                                quantized.offsets[c] = indices[children[c]];
+                        }
+                }
+
+                bvh_quantize_bounds(node.bounds, {&nodes[children[0]].bounds, &nodes[children[1]].bounds}, &quantized);
+        }
+
+        ASSERT(!res.empty());
+        return res;
+}
+}
+
+template <std::size_t N, typename T>
+void Bvh<N, T>::set_node_format(const BvhNodeFormat format)
+{
+        report_ = make_report(nodes_, object_indices_, sah_cost_);
+
+        switch (format)
+        {
+        case BvhNodeFormat::FULL:
+                return;
+        case BvhNodeFormat::QUANTIZED:
+                if (nodes_.size() == 1)
+                {
+                        // The root is a leaf
+                        return;
+                }
+                quantized_nodes_ = quantize_nodes(nodes_);
+                nodes_.clear();
+                nodes_.shrink_to_fit();
+                report_.memory_size = quantized_nodes_.size() * sizeof(BvhQuantizedNode<N, T>)
+                                      + object_indices_.size() * sizeof(unsigned);
+                return;
+        }
+        error("Unknown BVH node format " + to_string(enum_to_int(format)));
+}
+
+template <std::size_t N, typename T>
+std::vector<unsigned> Bvh<N, T>::release_object_indices()
+{
+        report_.memory_size -= object_indices_.size() * sizeof(unsigned);
+        return std::exchange(object_indices_, {});
+}
+
+template <std::size_t N, typename T>
+Bvh<N, T>::Bvh(std::vector<BvhObject<N, T>>&& objects, const BvhNodeFormat format, progress::Ratio* const progress)
+{
+        const BvhBuild<N, T> build(std::span(std::data(objects), std::size(objects)), nullptr, progress);
+
+        make_nodes(build, &object_indices_, &nodes_);
+        bounding_box_ = build.nodes()[0].bounds;
+        sah_cost_ = build.sah_cost();
+
+        set_node_format(format);
+}
+
+template <std::size_t N, typename T>
+Bvh<N, T>::Bvh(
+        std::vector<BvhObject<N, T>>&& objects,
+        const BvhObjectSplit<N, T>& object_split,
+        const BvhNodeFormat format,
+        progress::Ratio* const progress)
+{
+        const BvhBuild<N, T> build(std::span(std::data(objects), std::size(objects)), &object_split, progress);
+
+        make_nodes(build, &object_indices_, &nodes_);
+        bounding_box_ = build.nodes()[0].bounds;
+        sah_cost_ = build.sah_cost();
 
-        ASSERT(object_indices_.size() == build.object_indices().size());
-        ASSERT(nodes_.size() == build.nodes().size());
+        set_node_format(format);
 }
 
 #define TEMPLATE(N, T) template class Bvh<(N), T>;
@@ -26,6 +26,10 @@ Elsevier, 2017.
 #pragma once
 
 #include "bvh_object.h"
+#include "bvh_quantized.h"
+#include "bvh_ray.h"
+#include "bvh_report.h"
+#include "bvh_spatial_split.h"
 #include "bvh_stack.h"
 
 #include <src/com/error.h>
@@ -34,9 +38,11 @@ Elsevier, 2017.
 #include <src/numerical/vector.h>
 #include <src/progress/progress.h>
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <ranges>
 #include <span>
 #include <type_traits>
 #include <utility>
@@ -44,12 +50,27 @@ Elsevier, 2017.
 
 namespace ns::geometry::accelerators
 {
+// Objects of a leaf when the objects are stored in the order of the leaves
+using BvhObjectRange = std::ranges::iota_view<unsigned, unsigned>;
+
 namespace bvh_implementation
 {
+// Leaves are passed to object_intersect as object indices if it accepts
+// them, otherwise as object ranges
+template <typename T, typename ObjectIntersect>
+inline constexpr bool OBJECT_INDICES =
+        std::is_invocable_v<const ObjectIntersect&, std::span<const unsigned>&&, const T&>;
+
+template <typename T, typename ObjectIntersect>
+using ObjectIntersectResult = std::invoke_result_t<
+        const ObjectIntersect&,
+        std::conditional_t<OBJECT_INDICES<T, ObjectIntersect>, std::span<const unsigned>&&, BvhObjectRange&&>,
+        const T&>;
+
 template <std::size_t N, typename T>
 struct Node final
 {
-        spatial::BoundingBox<N, T> bounds;
+        spatial::BoundingBox<N, typename BvhRay<N, T>::B> bounds;
 
         union
         {
@@ -61,29 +82,126 @@ struct Node final
         std::uint8_t axis;
 };
 
-template <std::size_t N, typename T, typename ObjectIntersect>
-class Intersect final
+// Leaf intersections and the result of the traversal
+template <typename T, typename ObjectIntersect, bool COUNT>
+class Leaves final
 {
-        using Result = std::invoke_result_t<ObjectIntersect, std::span<const unsigned>&&, const T&>;
+        using B = BvhRay<1, T>::B;
 
+public:
+        using Result = ObjectIntersectResult<T, ObjectIntersect>;
+
+private:
         static constexpr bool TERMINATE_ON_FIRST_HIT = std::is_same_v<Result, bool>;
 
         const std::vector<unsigned>* const object_indices_;
-        const std::vector<Node<N, T>>* const nodes_;
         const ObjectIntersect* const object_intersect_;
-        const numerical::Ray<N, T>* const ray_;
-
-        const numerical::Vector<N, T> dir_reciprocal_;
-        const numerical::Vector<N, bool> dir_negative_;
+        BvhCounters* const counters_;
 
         T distance_;
-        unsigned node_index_ = 0;
+        B node_distance_;
         Result result_{};
+
+public:
+        Leaves(const std::vector<unsigned>* const object_indices,
+               const T& max_distance,
+               const ObjectIntersect* const object_intersect,
+               BvhCounters* const counters)
+                : object_indices_(object_indices),
+                  object_intersect_(object_intersect),
+                  counters_(counters),
+                  distance_(max_distance),
+                  node_distance_(bvh_ray_implementation::round_up<B>(max_distance))
+        {
+                ASSERT(!COUNT || counters_);
+        }
+
+        void count_node()
+        {
+                if constexpr (COUNT)
+                {
+                        ++counters_->nodes;
+                }
+        }
+
+        // The distance for node intersections
+        [[nodiscard]] B node_distance() const
+        {
+                return node_distance_;
+        }
+
+        // Returns false if the traversal is terminated
+        [[nodiscard]] bool intersect(const std::uint32_t object_offset, const std::uint16_t object_count)
+        {
+                if constexpr (COUNT)
+                {
+                        ++counters_->leaves;
+                        counters_->objects += object_count;
+                }
+
+                auto info = [&]
+                {
+                        if constexpr (OBJECT_INDICES<T, ObjectIntersect>)
+                        {
+                                ASSERT(object_offset + object_count <= object_indices_->size());
+                                return (*object_intersect_)(
+                                        std::span(object_indices_->data() + object_offset, object_count),
+                                        std::as_const(distance_));
+                        }
+                        else
+                        {
+                                return (*object_intersect_)(
+                                        BvhObjectRange(object_offset, object_offset + object_count),
+                                        std::as_const(distance_));
+                        }
+                }();
+
+                static_assert(std::is_same_v<decltype(info), decltype(result_)>);
+
+                if constexpr (TERMINATE_ON_FIRST_HIT)
+                {
+                        if (info)
+                        {
+                                result_ = true;
+                                return false;
+                        }
+                }
+                else
+                {
+                        static_assert(std::is_same_v<T, std::remove_reference_t<decltype(std::get<0>(*info))>>);
+                        if (info)
+                        {
+                                ASSERT(std::get<0>(*info) < distance_);
+                                distance_ = std::get<0>(*info);
+                                node_distance_ = bvh_ray_implementation::round_up<B>(distance_);
+                                result_ = std::move(*info);
+                        }
+                }
+
+                return true;
+        }
+
+        [[nodiscard]] Result& result()
+        {
+                return result_;
+        }
+};
+
+template <std::size_t N, typename T, typename ObjectIntersect, bool COUNT = false>
+class Intersect final
+{
+        using Result = Leaves<T, ObjectIntersect, COUNT>::Result;
+
+        const std::vector<Node<N, T>>* const nodes_;
+        const BvhRay<N, T> ray_;
+
+        Leaves<T, ObjectIntersect, COUNT> leaves_;
+        unsigned node_index_ = 0;
         BvhStack stack_;
 
         void push(const Node<N, T>& node)
         {
-                if (dir_negative_[node.axis])
+                if (ray_.dir_negative(node.axis))
                 {
                         stack_.push(node_index_ + 1);
                         node_index_ = node.second_child_offset;
@@ -109,7 +227,9 @@ class Intersect final
         {
                 const Node<N, T>& node = (*nodes_)[node_index_];
 
-                if (!node.bounds.intersect(ray_->org(), dir_reciprocal_, dir_negative_, distance_))
+                leaves_.count_node();
+
+                if (!ray_.intersect(node.bounds, leaves_.node_distance()))
                 {
                         return pop();
                 }
@@ -120,48 +240,118 @@ class Intersect final
                         return true;
                 }
 
-                auto info = (*object_intersect_)(
-                        std::span(object_indices_->data() + node.object_offset, node.object_count),
-                        std::as_const(distance_));
+                if (!leaves_.intersect(node.object_offset, node.object_count))
+                {
+                        return false;
+                }
 
-                static_assert(std::is_same_v<decltype(info), decltype(result_)>);
+                return pop();
+        }
 
-                if constexpr (TERMINATE_ON_FIRST_HIT)
+public:
+        Intersect(
+                const std::vector<unsigned>* const object_indices,
+                const std::vector<Node<N, T>>* const nodes,
+                const numerical::Ray<N, T>* const ray,
+                const T& max_distance,
+                const ObjectIntersect* const object_intersect,
+                BvhCounters* const counters = nullptr)
+                : nodes_(nodes),
+                  ray_(*ray),
+                  leaves_(object_indices, max_distance, object_intersect, counters)
+        {
+        }
+
+        [[nodiscard]] Result compute()
+        {
+                while (traverse())
                 {
-                        if (info)
-                        {
-                                result_ = true;
-                                return false;
-                        }
                 }
-                else
+                return std::move(leaves_.result());
+        }
+};
+
+// Each node has the bounds of its two children
+// quantized relative to the bounds of the node
+template <std::size_t N, typename T, typename ObjectIntersect, bool COUNT = false>
+class QuantizedIntersect final
+{
+        using Result = Leaves<T, ObjectIntersect, COUNT>::Result;
+
+        const std::vector<BvhQuantizedNode<N, T>>* const nodes_;
+        const BvhRay<N, T> ray_;
+
+        Leaves<T, ObjectIntersect, COUNT> leaves_;
+        unsigned node_index_ = 0;
+        BvhStack stack_;
+
+        [[nodiscard]] bool pop()
+        {
+                if (stack_.empty())
                 {
-                        static_assert(std::is_same_v<T, std::remove_reference_t<decltype(std::get<0>(*info))>>);
-                        if (info)
+                        return false;
+                }
+                node_index_ = stack_.pop();
+                return true;
+        }
+
+        [[nodiscard]] bool traverse()
+        {
+                const BvhQuantizedNode<N, T>& node = (*nodes_)[node_index_];
+
+                const unsigned near = ray_.dir_negative(node.axis) ? 1 : 0;
+
+                std::array<unsigned, 2> interior;
+                unsigned interior_count = 0;
+
+                for (const unsigned child : {near, 1 - near})
+                {
+                        leaves_.count_node();
+
+                        const auto [min, max] = node.bounds(child);
+                        if (!ray_.intersect(min, max, leaves_.node_distance()))
                         {
-                                ASSERT(std::get<0>(*info) < distance_);
-                                distance_ = std::get<0>(*info);
-                                result_ = std::move(*info);
+                                continue;
+                        }
+
+                        if (node.object_counts[child] == 0)
+                        {
+                                interior[interior_count++] = node.offsets[child];
+                                continue;
+                        }
+
+                        if (!leaves_.intersect(node.offsets[child], node.object_counts[child]))
+                        {
+                                return false;
                         }
                 }
 
-                return pop();
+                switch (interior_count)
+                {
+                case 0:
+                        return pop();
+                case 1:
+                        node_index_ = interior[0];
+                        return true;
+                case 2:
+                        stack_.push(interior[1]);
+                        node_index_ = interior[0];
+                        return true;
+                }
+                error_fatal("Unknown child count");
         }
 
 public:
-        Intersect(
+        QuantizedIntersect(
                 const std::vector<unsigned>* const object_indices,
-                const std::vector<Node<N, T>>* const nodes,
+                const std::vector<BvhQuantizedNode<N, T>>* const nodes,
                 const numerical::Ray<N, T>* const ray,
                 const T& max_distance,
-                const ObjectIntersect* const object_intersect)
-                : object_indices_(object_indices),
-                  nodes_(nodes),
-                  object_intersect_(object_intersect),
-                  ray_(ray),
-                  dir_reciprocal_(ray->dir().reciprocal()),
-                  dir_negative_(ray->dir().negative_bool()),
-                  distance_(max_distance)
+                const ObjectIntersect* const object_intersect,
+                BvhCounters* const counters = nullptr)
+                : nodes_(nodes),
+                  ray_(*ray),
+                  leaves_(object_indices, max_distance, object_intersect, counters)
         {
         }
 
@@ -170,46 +360,139 @@ public:
                 while (traverse())
                 {
                 }
-                return result_;
+                return std::move(leaves_.result());
         }
 };
 }
 
+enum class BvhNodeFormat
+{
+        // Node bounds in the node type
+        FULL,
+        // Child bounds quantized to 8 bits relative to the node bounds
+        QUANTIZED
+};
+
 template <std::size_t N, typename T>
 class Bvh final
 {
         static_assert(
-                N != 3 || !(std::is_same_v<float, T>)
-                || sizeof(bvh_implementation::Node<N, T>) == 6 * sizeof(float) + 2 * sizeof(std::uint32_t));
+                N != 3 || sizeof(bvh_implementation::Node<N, T>) == 6 * sizeof(float) + 2 * sizeof(std::uint32_t));
+
+        static_assert(
+                N != 3
+                || sizeof(BvhQuantizedNode<N, T>)
+                           == 3 * sizeof(float) + 16 * sizeof(std::uint8_t) + 2 * sizeof(std::uint16_t)
+                                      + 2 * sizeof(std::uint32_t));
 
         std::vector<unsigned> object_indices_;
+        // One of the arrays is empty
         std::vector<bvh_implementation::Node<N, T>> nodes_;
+        std::vector<BvhQuantizedNode<N, T>> quantized_nodes_;
+        spatial::BoundingBox<N, T> bounding_box_;
+        T sah_cost_;
+        BvhReport report_;
+
+        void set_node_format(BvhNodeFormat format);
 
 public:
-        explicit Bvh(std::vector<BvhObject<N, T>>&& objects, progress::Ratio* progress);
+        Bvh(std::vector<BvhObject<N, T>>&& objects, BvhNodeFormat format, progress::Ratio* progress);
+
+        // Spatial splits with reference duplication
+        Bvh(std::vector<BvhObject<N, T>>&& objects,
+            const BvhObjectSplit<N, T>& object_split,
+            BvhNodeFormat format,
+            progress::Ratio* progress);
 
         [[nodiscard]] const spatial::BoundingBox<N, T>& bounding_box() const
         {
-                return nodes_[0].bounds;
+                return bounding_box_;
         }
 
+        // Surface area heuristic cost of the tree
+        [[nodiscard]] T sah_cost() const
+        {
+                return sah_cost_;
+        }
+
+        [[nodiscard]] const BvhReport& report() const
+        {
+                return report_;
+        }
+
+        // Leaves refer to consecutive elements of this array.
+        // With spatial splits, objects can be referenced more than once
+        [[nodiscard]] const std::vector<unsigned>& object_indices() const
+        {
+                return object_indices_;
+        }
+
+        // For the objects stored in the order of the object indices.
+        // The object_intersect function then takes object ranges
+        [[nodiscard]] std::vector<unsigned> release_object_indices();
+
         [[nodiscard]] std::optional<T> intersect_root(const numerical::Ray<N, T>& ray, const T& max_distance) const
         {
-                return nodes_[0].bounds.intersect_volume(ray, max_distance);
+                return bounding_box_.intersect_volume(ray, max_distance);
         }
 
         // The signature of the object_intersect function
         // std::optional<std::tuple<T, ...> f(const auto& indices, const auto& max_distance);
         // bool f(const auto& indices, const auto& max_distance);
+        // The indices are std::span<const unsigned> or BvhObjectRange
         template <typename ObjectIntersect>
-        [[nodiscard]] std::invoke_result_t<ObjectIntersect, std::span<const unsigned>&&, const T&> intersect(
+        [[nodiscard]] bvh_implementation::ObjectIntersectResult<T, ObjectIntersect> intersect(
                 const numerical::Ray<N, T>& ray,
                 const T& max_distance,
                 const ObjectIntersect& object_intersect) const
         {
+                if (!quantized_nodes_.empty())
+                {
+                        return bvh_implementation::QuantizedIntersect<N, T, ObjectIntersect>(
+                                       &object_indices_, &quantized_nodes_, &ray, max_distance, &object_intersect)
+                                .compute();
+                }
                 return bvh_implementation::Intersect<N, T, ObjectIntersect>(
                                &object_indices_, &nodes_, &ray, max_distance, &object_intersect)
                         .compute();
         }
+
+        // Node, leaf and object counts of the nearest intersections
+        // of the rays. The signature of the object_intersect function
+        // std::optional<std::tuple<T, ...> f(const auto& ray, const auto& indices, const auto& max_distance);
+        template <typename ObjectIntersect>
+        [[nodiscard]] BvhCounters traversal(
+                const std::span<const numerical::Ray<N, T>> rays,
+                const T& max_distance,
+                const ObjectIntersect& object_intersect) const
+        {
+                BvhCounters res;
+                for (const numerical::Ray<N, T>& ray : rays)
+                {
+                        const auto ray_intersect =
+                                [&](const auto& indices, const T& max) -> decltype(object_intersect(ray, indices, max))
+                        {
+                                return object_intersect(ray, indices, max);
+                        };
+                        ++res.rays;
+                        if (!quantized_nodes_.empty())
+                        {
+                                static_cast<void>(
+                                        bvh_implementation::QuantizedIntersect<N, T, decltype(ray_intersect), true>(
+                                                &object_indices_, &quantized_nodes_, &ray, max_distance,
+                                                &ray_intersect, &res)
+                                                .compute());
+                        }
+                        else
+                        {
+                                static_cast<void>(
+                                        bvh_implementation::Intersect<N, T, decltype(ray_intersect), true>(
+                                                &object_indices_, &nodes_, &ray, max_distance, &ray_intersect,
+                                                &res)
+                                                .compute());
+                        }
+                }
+                return res;
+        }
 };
 }
@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "bvh_functions.h"
 #include "bvh_object.h"
+#include "bvh_spatial_split.h"
 #include "bvh_split.h"
 
 #include <src/com/error.h>
@@ -30,9 +31,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <array>
 #include <cstddef>
 #include <deque>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <span>
+#include <type_traits>
 #include <vector>
 
 namespace ns::geometry::accelerators
@@ -45,6 +48,7 @@ struct BvhBuildNode final
         unsigned axis;
         unsigned object_index_offset;
         unsigned object_index_count;
+        T object_cost;
 
         BvhBuildNode()
         {
@@ -54,10 +58,12 @@ struct BvhBuildNode final
         BvhBuildNode(
                 const spatial::BoundingBox<N, T>& bounds,
                 const unsigned object_index_offset,
-                const unsigned object_index_count)
+                const unsigned object_index_count,
+                const T object_cost)
                 : bounds(bounds),
                   object_index_offset(object_index_offset),
-                  object_index_count(object_index_count)
+                  object_index_count(object_index_count),
+                  object_cost(object_cost)
         {
                 ASSERT(object_index_count > 0);
         }
@@ -71,7 +77,8 @@ struct BvhBuildNode final
                 : bounds(bounds),
                   children{child_0, child_1},
                   axis(axis),
-                  object_index_count(0)
+                  object_index_count(0),
+                  object_cost(0)
         {
         }
 };
@@ -87,27 +94,51 @@ class BvhBuild final
                 return 2 * object_count - 1;
         }
 
+        // Spatial splits are tried only for nodes with overlapping
+        // children of the object split, relative to the root surface
+        static constexpr double SPATIAL_SPLIT_OVERLAP = 1e-5;
+
+        // Maximum number of duplicated references relative to the object count
+        static constexpr double SPATIAL_SPLIT_REFERENCE_BUDGET = 0.3;
+
+        static std::size_t max_reference_count(const std::size_t object_count, const bool spatial_splits)
+        {
+                if (!spatial_splits)
+                {
+                        return object_count;
+                }
+                return object_count + static_cast<std::size_t>(SPATIAL_SPLIT_REFERENCE_BUDGET * object_count);
+        }
+
         struct Task final
         {
                 std::span<BvhObject<N, T>> objects;
                 spatial::BoundingBox<N, T> bounds;
                 BvhBuildNode<N, T>* node;
+                // Storage of the objects created by spatial splits
+                std::shared_ptr<std::vector<BvhObject<N, T>>> storage;
 
                 Task(const std::span<BvhObject<N, T>>& objects,
                      const spatial::BoundingBox<N, T>& bounds,
-                     BvhBuildNode<N, T>* const node)
+                     BvhBuildNode<N, T>* const node,
+                     std::shared_ptr<std::vector<BvhObject<N, T>>> storage)
                         : objects(objects),
                           bounds(bounds),
-                          node(node)
+                          node(node),
+                          storage(std::move(storage))
                 {
                 }
         };
 
         const T interior_node_traversal_cost_ = 2 * spatial::BoundingBox<N, T>::intersection_r_cost();
+        const BvhObjectSplit<N, T>* const object_split_;
+        const unsigned max_reference_count_;
         const double max_interior_node_count_reciprocal_;
+        T spatial_split_min_overlap_;
 
         std::vector<unsigned> object_indices_;
         unsigned object_indices_size_ = 0;
+        unsigned reference_count_ = 0;
         std::mutex object_indices_lock_;
 
         // std::deque to keep object addreses unchanged when inserting
@@ -122,6 +153,17 @@ class BvhBuild final
                 return offset;
         }
 
+        [[nodiscard]] bool create_references(const unsigned count)
+        {
+                const std::lock_guard lg(object_indices_lock_);
+                if (reference_count_ + count > max_reference_count_)
+                {
+                        return false;
+                }
+                reference_count_ += count;
+                return true;
+        }
+
         struct ChildNode final
         {
                 BvhBuildNode<N, T>* node;
@@ -138,50 +180,127 @@ class BvhBuild final
                 return res;
         }
 
+        [[nodiscard]] bool try_spatial_split(const std::optional<BvhSplit<N, T>>& s) const
+        {
+                if (!object_split_)
+                {
+                        return false;
+                }
+                return !s || bvh_overlap_surface(s->bounds_min, s->bounds_max) > spatial_split_min_overlap_;
+        }
+
+        [[nodiscard]] std::optional<BvhSpatialSplit<N, T>> find_spatial_split(
+                const Task& task,
+                const std::optional<BvhSplit<N, T>>& s)
+        {
+                if (!try_spatial_split(s))
+                {
+                        return {};
+                }
+
+                std::optional<BvhSpatialSplit<N, T>> res = spatial_split<N, T>(
+                        task.objects, task.bounds, interior_node_traversal_cost_, *object_split_);
+                if (!res || (s && !(res->cost < s->cost)))
+                {
+                        return {};
+                }
+
+                const std::size_t count = res->objects_min.size() + res->objects_max.size();
+                ASSERT(count >= task.objects.size());
+                if (!create_references(count - task.objects.size()))
+                {
+                        return {};
+                }
+                return res;
+        }
+
+        std::array<ChildNode, 2> create_interior_node(
+                const Task& task,
+                const unsigned axis,
+                progress::Ratio* const progress)
+        {
+                const std::array<ChildNode, 2> res = create_child_nodes();
+                if ((res[0].index & 0xfffe) == 0xfffe)
+                {
+                        progress->set(res[0].index * max_interior_node_count_reciprocal_);
+                }
+                *task.node = BvhBuildNode<N, T>(task.bounds, axis, res[0].index, res[1].index);
+                return res;
+        }
+
+        void create_leaf_node(const Task& task)
+        {
+                const unsigned count = task.objects.size();
+                const unsigned offset = create_indices(count);
+
+                std::common_type_t<double, T> cost = 0;
+                for (auto iter = object_indices_.begin() + offset; const BvhObject<N, T>& object : task.objects)
+                {
+                        *iter++ = object.index();
+                        cost += object.intersection_cost();
+                }
+
+                *task.node = BvhBuildNode<N, T>(task.bounds, offset, count, static_cast<T>(cost));
+        }
+
         void build(ThreadTaskManager<Task>* const task_manager, progress::Ratio* const progress)
         {
                 while (const auto task = task_manager->get())
                 {
-                        if (std::optional<BvhSplit<N, T>> s =
-                                    split(task->objects, task->bounds, interior_node_traversal_cost_))
+                        const std::optional<BvhSplit<N, T>> s =
+                                split(task->objects, task->bounds, interior_node_traversal_cost_);
+
+                        if (std::optional<BvhSpatialSplit<N, T>> spatial = find_spatial_split(*task, s))
                         {
-                                const auto [min, max] = create_child_nodes();
-                                if ((min.index & 0xfffe) == 0xfffe)
-                                {
-                                        progress->set(min.index * max_interior_node_count_reciprocal_);
-                                }
-                                *task->node = BvhBuildNode<N, T>(task->bounds, s->axis, min.index, max.index);
-                                task_manager->emplace(s->objects_min, s->bounds_min, min.node);
-                                task_manager->emplace(s->objects_max, s->bounds_max, max.node);
+                                const auto [min, max] = create_interior_node(*task, spatial->axis, progress);
+                                auto objects_min =
+                                        std::make_shared<std::vector<BvhObject<N, T>>>(std::move(spatial->objects_min));
+                                auto objects_max =
+                                        std::make_shared<std::vector<BvhObject<N, T>>>(std::move(spatial->objects_max));
+                                task_manager->emplace(
+                                        std::span(*objects_min), spatial->bounds_min, min.node, std::move(objects_min));
+                                task_manager->emplace(
+                                        std::span(*objects_max), spatial->bounds_max, max.node, std::move(objects_max));
                                 continue;
                         }
 
-                        const unsigned count = task->objects.size();
-                        const unsigned offset = create_indices(count);
-                        *task->node = BvhBuildNode<N, T>(task->bounds, offset, count);
-                        for (auto iter = object_indices_.begin() + offset;
-                             const BvhObject<N, T>& object : task->objects)
+                        if (s)
                         {
-                                *iter++ = object.index();
+                                const auto [min, max] = create_interior_node(*task, s->axis, progress);
+                                task_manager->emplace(s->objects_min, s->bounds_min, min.node, task->storage);
+                                task_manager->emplace(s->objects_max, s->bounds_max, max.node, task->storage);
+                                continue;
                         }
+
+                        create_leaf_node(*task);
                 }
         }
 
 public:
-        explicit BvhBuild(const std::span<BvhObject<N, T>>& objects, progress::Ratio* const progress)
-                : max_interior_node_count_reciprocal_(1.0 / max_interior_node_count(objects.size()))
+        // object_split is null if spatial splits are not used
+        BvhBuild(
+                const std::span<BvhObject<N, T>>& objects,
+                const BvhObjectSplit<N, T>* const object_split,
+                progress::Ratio* const progress)
+                : object_split_(object_split),
+                  max_reference_count_(max_reference_count(objects.size(), object_split != nullptr)),
+                  max_interior_node_count_reciprocal_(1.0 / max_interior_node_count(max_reference_count_))
         {
                 if (objects.empty())
                 {
                         error("No objects to build BVH");
                 }
 
-                object_indices_.resize(objects.size());
+                object_indices_.resize(max_reference_count_);
+                reference_count_ = objects.size();
+
+                const spatial::BoundingBox<N, T> bounds = compute_bounds(objects);
+                spatial_split_min_overlap_ = SPATIAL_SPLIT_OVERLAP * bounds.surface();
 
                 nodes_.emplace_back();
 
                 ThreadTasks<Task> tasks;
-                tasks.emplace(objects, compute_bounds(objects), &nodes_.front());
+                tasks.emplace(objects, bounds, &nodes_.front(), nullptr);
 
                 const auto f = [&]
                 {
@@ -206,7 +325,9 @@ public:
                 }
                 threads.join();
 
-                ASSERT(object_indices_size_ == objects.size());
+                ASSERT(object_indices_size_ == reference_count_);
+                object_indices_.resize(object_indices_size_);
+                object_indices_.shrink_to_fit();
         }
 
         [[nodiscard]] const std::vector<unsigned>& object_indices() const
@@ -218,5 +339,18 @@ public:
         {
                 return nodes_;
         }
+
+        // Surface area heuristic cost of the tree
+        [[nodiscard]] T sah_cost() const
+        {
+                std::common_type_t<double, T> sum = 0;
+                for (const BvhBuildNode<N, T>& node : nodes_)
+                {
+                        const T cost =
+                                (node.object_index_count == 0) ? interior_node_traversal_cost_ : node.object_cost;
+                        sum += cost * node.bounds.surface();
+                }
+                return sum / nodes_.front().bounds.surface();
+        }
 };
 }
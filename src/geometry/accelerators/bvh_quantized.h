@@ -0,0 +1,162 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "bvh_ray.h"
+
+#include <src/com/error.h>
+#include <src/geometry/spatial/bounding_box.h>
+#include <src/numerical/vector.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace ns::geometry::accelerators
+{
+// The node has the bounds of its two children quantized
+// to 8 bits relative to the bounds of the node.
+// The scales are powers of 2 stored as biased float exponents,
+// so decoding is a multiplication without rounding and an addition.
+// Decoded bounds contain the bounds of the children
+template <std::size_t N, typename T>
+struct BvhQuantizedNode final
+{
+        using B = BvhRay<N, T>::B;
+
+        static_assert(std::is_same_v<B, float>);
+
+        numerical::Vector<N, B> origin;
+        std::array<std::uint8_t, N> exponents;
+        std::array<std::array<std::uint8_t, N>, 2> min;
+        std::array<std::array<std::uint8_t, N>, 2> max;
+        std::uint8_t axis;
+
+        // Zero for interior children
+        std::array<std::uint16_t, 2> object_counts;
+
+        // Node index for interior children,
+        // object offset for leaf children
+        std::array<std::uint32_t, 2> offsets;
+
+        [[nodiscard]] static B decode(const B origin, const std::uint8_t exponent, const std::uint8_t v)
+        {
+                const B scale = std::bit_cast<B>(static_cast<std::uint32_t>(exponent) << 23);
+                return origin + static_cast<B>(v) * scale;
+        }
+
+        [[nodiscard]] std::array<numerical::Vector<N, B>, 2> bounds(const unsigned child) const
+        {
+                std::array<numerical::Vector<N, B>, 2> res;
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                        res[0][i] = decode(origin[i], exponents[i], min[child][i]);
+                        res[1][i] = decode(origin[i], exponents[i], max[child][i]);
+                }
+                return res;
+        }
+};
+
+namespace bvh_quantized_implementation
+{
+inline constexpr int MIN_EXPONENT = 1;
+inline constexpr int MAX_EXPONENT = 254;
+inline constexpr int EXPONENT_BIAS = 127;
+inline constexpr int MAX_VALUE = 255;
+
+template <typename Node>
+[[nodiscard]] std::uint8_t quantize_exponent(const typename Node::B origin, const typename Node::B max)
+{
+        int exponent;
+        std::frexp((max - origin) / MAX_VALUE, &exponent);
+        exponent = std::clamp(exponent + EXPONENT_BIAS, MIN_EXPONENT, MAX_EXPONENT);
+
+        while (Node::decode(origin, exponent, MAX_VALUE) < max)
+        {
+                if (exponent == MAX_EXPONENT)
+                {
+                        error("Bounds are too large for BVH node quantization");
+                }
+                ++exponent;
+        }
+
+        return exponent;
+}
+
+template <typename Node>
+[[nodiscard]] std::uint8_t quantize_min(
+        const typename Node::B origin,
+        const std::uint8_t exponent,
+        const typename Node::B min)
+{
+        const typename Node::B scale = Node::decode(0, exponent, 1);
+        int v = std::clamp<typename Node::B>(std::floor((min - origin) / scale), 0, MAX_VALUE);
+        while (v > 0 && Node::decode(origin, exponent, v) > min)
+        {
+                --v;
+        }
+        return v;
+}
+
+template <typename Node>
+[[nodiscard]] std::uint8_t quantize_max(
+        const typename Node::B origin,
+        const std::uint8_t exponent,
+        const typename Node::B max)
+{
+        const typename Node::B scale = Node::decode(0, exponent, 1);
+        int v = std::clamp<typename Node::B>(std::ceil((max - origin) / scale), 0, MAX_VALUE);
+        while (Node::decode(origin, exponent, v) < max)
+        {
+                ASSERT(v < MAX_VALUE);
+                ++v;
+        }
+        return v;
+}
+}
+
+template <std::size_t N, typename T>
+void bvh_quantize_bounds(
+        const spatial::BoundingBox<N, typename BvhQuantizedNode<N, T>::B>& bounds,
+        const std::array<const spatial::BoundingBox<N, typename BvhQuantizedNode<N, T>::B>*, 2>& children,
+        BvhQuantizedNode<N, T>* const node)
+{
+        namespace impl = bvh_quantized_implementation;
+
+        using Node = BvhQuantizedNode<N, T>;
+
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                node->origin[i] = bounds.min()[i];
+                node->exponents[i] = impl::quantize_exponent<Node>(node->origin[i], bounds.max()[i]);
+                for (std::size_t c = 0; c < 2; ++c)
+                {
+                        ASSERT(bounds.min()[i] <= children[c]->min()[i]);
+                        ASSERT(bounds.max()[i] >= children[c]->max()[i]);
+                        node->min[c][i] = impl::quantize_min<Node>(
+                                node->origin[i], node->exponents[i], children[c]->min()[i]);
+                        node->max[c][i] = impl::quantize_max<Node>(
+                                node->origin[i], node->exponents[i], children[c]->max()[i]);
+                }
+        }
+}
+}
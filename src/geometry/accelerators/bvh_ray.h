@@ -0,0 +1,187 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <src/com/type/limit.h>
+#include <src/geometry/spatial/bounding_box.h>
+#include <src/numerical/ray.h>
+#include <src/numerical/vector.h>
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+namespace ns::geometry::accelerators
+{
+namespace bvh_ray_implementation
+{
+// Nodes of double precision trees are stored and traversed in float.
+// The bounds are rounded outward, the ray origin is rounded down
+// or up for the near and far distances, and the slab tests are
+// widened by the rounding errors, so the traversal visits all
+// leaves that the double precision traversal visits
+template <typename T>
+using NodeType = std::conditional_t<std::is_same_v<T, double>, float, T>;
+
+template <typename B, typename T>
+[[nodiscard]] B round_down(const T v)
+{
+        const B res = static_cast<B>(v);
+        return (res > v) ? std::nextafter(res, -Limits<B>::infinity()) : res;
+}
+
+template <typename B, typename T>
+[[nodiscard]] B round_up(const T v)
+{
+        const B res = static_cast<B>(v);
+        return (res < v) ? std::nextafter(res, Limits<B>::infinity()) : res;
+}
+
+template <typename B, std::size_t N, typename T>
+[[nodiscard]] numerical::Vector<N, B> near_origin(
+        const numerical::Vector<N, T>& org,
+        const numerical::Vector<N, bool>& dir_negative)
+{
+        numerical::Vector<N, B> res;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                res[i] = dir_negative[i] ? round_down<B>(org[i]) : round_up<B>(org[i]);
+        }
+        return res;
+}
+
+template <typename B, std::size_t N, typename T>
+[[nodiscard]] numerical::Vector<N, B> far_origin(
+        const numerical::Vector<N, T>& org,
+        const numerical::Vector<N, bool>& dir_negative)
+{
+        numerical::Vector<N, B> res;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                res[i] = dir_negative[i] ? round_up<B>(org[i]) : round_down<B>(org[i]);
+        }
+        return res;
+}
+
+// Infinity if a finite reciprocal of the direction
+// is infinite in the node type, then all nodes are visited
+template <typename B, std::size_t N, typename T>
+[[nodiscard]] B reciprocal_error(const numerical::Vector<N, T>& dir_reciprocal)
+{
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                const T r = std::abs(dir_reciprocal[i]);
+                if (r != Limits<T>::infinity() && r > Limits<B>::max())
+                {
+                        return Limits<B>::infinity();
+                }
+        }
+        return 0;
+}
+
+// The slab test with the near and far distances widened
+// by the relative rounding errors
+template <std::size_t N, typename B>
+[[nodiscard]] bool intersect_bounds(
+        const numerical::Vector<N, B>& min,
+        const numerical::Vector<N, B>& max,
+        const numerical::Vector<N, B>& org_near,
+        const numerical::Vector<N, B>& org_far,
+        const numerical::Vector<N, B>& dir_reciprocal,
+        const numerical::Vector<N, bool>& dir_negative,
+        const B max_distance,
+        const B error)
+{
+        static constexpr B RELATIVE_ERROR = 4 * Limits<B>::epsilon();
+
+        B near = 0;
+        B far = max_distance;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                const B r = dir_reciprocal[i];
+                const B a1 = ((dir_negative[i] ? max[i] : min[i]) - org_near[i]) * r;
+                const B a2 = ((dir_negative[i] ? min[i] : max[i]) - org_far[i]) * r;
+                near = a1 > near ? a1 : near;
+                far = a2 < far ? a2 : far;
+                const B near_bound = near * (1 - RELATIVE_ERROR) - error;
+                const B far_bound = far * (far < 0 ? 1 - RELATIVE_ERROR : 1 + RELATIVE_ERROR) + error;
+                if (far_bound < near_bound)
+                {
+                        return false;
+                }
+        }
+        return true;
+}
+
+}
+
+// The ray in the node type of the tree
+template <std::size_t N, typename T>
+class BvhRay final
+{
+public:
+        using B = bvh_ray_implementation::NodeType<T>;
+
+private:
+        static constexpr bool ROUNDING = !std::is_same_v<B, T>;
+
+        numerical::Vector<N, bool> dir_negative_;
+        numerical::Vector<N, B> org_near_;
+        numerical::Vector<N, B> org_far_;
+        numerical::Vector<N, B> dir_reciprocal_;
+        B error_;
+
+public:
+        explicit BvhRay(const numerical::Ray<N, T>& ray)
+                : dir_negative_(ray.dir().negative_bool()),
+                  org_near_(bvh_ray_implementation::near_origin<B>(ray.org(), dir_negative_)),
+                  org_far_(bvh_ray_implementation::far_origin<B>(ray.org(), dir_negative_)),
+                  dir_reciprocal_(numerical::to_vector<B>(ray.dir().reciprocal())),
+                  error_(bvh_ray_implementation::reciprocal_error<B>(ray.dir().reciprocal()))
+        {
+        }
+
+        [[nodiscard]] bool dir_negative(const unsigned axis) const
+        {
+                return dir_negative_[axis];
+        }
+
+        // Exact bounds of the node type
+        [[nodiscard]] bool intersect(const spatial::BoundingBox<N, B>& bounds, const B max_distance) const
+        {
+                if constexpr (ROUNDING)
+                {
+                        return intersect(bounds.min(), bounds.max(), max_distance);
+                }
+                else
+                {
+                        return bounds.intersect(org_near_, dir_reciprocal_, dir_negative_, max_distance);
+                }
+        }
+
+        // Bounds with the widened test
+        [[nodiscard]] bool intersect(
+                const numerical::Vector<N, B>& min,
+                const numerical::Vector<N, B>& max,
+                const B max_distance) const
+        {
+                return bvh_ray_implementation::intersect_bounds(
+                        min, max, org_near_, org_far_, dir_reciprocal_, dir_negative_, max_distance, error_);
+        }
+};
+}
@@ -0,0 +1,78 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "bvh_report.h"
+
+#include <src/com/print.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns::geometry::accelerators
+{
+namespace
+{
+std::string histogram_text(const std::vector<std::size_t>& histogram)
+{
+        std::string res;
+        for (std::size_t i = 0; i < histogram.size(); ++i)
+        {
+                if (histogram[i] == 0)
+                {
+                        continue;
+                }
+                if (!res.empty())
+                {
+                        res += ", ";
+                }
+                res += to_string(i) + ": " + to_string(histogram[i]);
+        }
+        return res;
+}
+
+double per_ray(const std::uint64_t count, const std::uint64_t ray_count)
+{
+        return ray_count > 0 ? static_cast<double>(count) / ray_count : 0;
+}
+}
+
+std::string bvh_report_text(const BvhReport& report)
+{
+        std::string res;
+        res += "BVH SAH cost " + to_string_fixed(report.sah_cost, 3);
+        res += ", nodes " + to_string(report.node_count);
+        res += ", leaves " + to_string(report.leaf_count);
+        res += ", objects " + to_string(report.object_count);
+        res += ", memory " + to_string(report.memory_size) + " bytes";
+        res += ", overlap " + to_string_fixed(report.overlap_ratio, 5);
+        res += "\nBVH leaf sizes " + histogram_text(report.leaf_sizes);
+        res += "\nBVH leaf depths " + histogram_text(report.leaf_depths);
+        return res;
+}
+
+std::string bvh_counters_text(const BvhCounters& counters)
+{
+        std::string res;
+        res += "BVH traversal rays " + to_string(counters.rays);
+        res += ", nodes per ray " + to_string_fixed(per_ray(counters.nodes, counters.rays), 3);
+        res += ", leaves per ray " + to_string_fixed(per_ray(counters.leaves, counters.rays), 3);
+        res += ", objects per ray " + to_string_fixed(per_ray(counters.objects, counters.rays), 3);
+        return res;
+}
+}
@@ -0,0 +1,57 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns::geometry::accelerators
+{
+struct BvhReport final
+{
+        double sah_cost;
+        std::size_t node_count;
+        std::size_t leaf_count;
+        std::size_t object_count;
+        std::size_t memory_size;
+
+        // The overlap surface of the children relative
+        // to the surface of the node, the mean over interior nodes
+        double overlap_ratio;
+
+        // Element i is the number of leaves with i objects
+        std::vector<std::size_t> leaf_sizes;
+
+        // Element i is the number of leaves at depth i
+        std::vector<std::size_t> leaf_depths;
+};
+
+struct BvhCounters final
+{
+        std::uint64_t rays = 0;
+        std::uint64_t nodes = 0;
+        std::uint64_t leaves = 0;
+        std::uint64_t objects = 0;
+};
+
+[[nodiscard]] std::string bvh_report_text(const BvhReport& report);
+
+[[nodiscard]] std::string bvh_counters_text(const BvhCounters& counters);
+}
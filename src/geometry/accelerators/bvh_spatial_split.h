@@ -0,0 +1,336 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Martin Stich, Heiko Friedrich, Andreas Dietrich.
+Spatial splits in bounding volume hierarchies.
+High-Performance Graphics 2009.
+*/
+
+#pragma once
+
+#include "bvh_object.h"
+
+#include <src/com/error.h>
+#include <src/com/type/limit.h>
+#include <src/geometry/spatial/bounding_box.h>
+#include <src/numerical/vector.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace ns::geometry::accelerators
+{
+// Bounds of the parts of the object on both sides of the plane
+// x[axis] = position, clipped by the bounds of the object reference
+template <std::size_t N, typename T>
+using BvhObjectSplit = std::function<std::array<std::optional<spatial::BoundingBox<N, T>>, 2>(
+        unsigned index,
+        const spatial::BoundingBox<N, T>& bounds,
+        unsigned axis,
+        T position)>;
+
+namespace bvh_spatial_split_implementation
+{
+inline constexpr unsigned BIN_COUNT = 32;
+
+template <std::size_t N, typename T>
+class Bins final
+{
+        unsigned axis_;
+        T min_;
+        T width_;
+        T width_r_;
+
+public:
+        explicit Bins(const spatial::BoundingBox<N, T>& bounds)
+                : axis_(bounds.maximum_extent()),
+                  min_(bounds.min()[axis_]),
+                  width_((bounds.max()[axis_] - min_) / BIN_COUNT),
+                  width_r_(1 / width_)
+        {
+        }
+
+        [[nodiscard]] bool is_empty() const
+        {
+                return !(width_ > 0);
+        }
+
+        [[nodiscard]] unsigned axis() const
+        {
+                return axis_;
+        }
+
+        [[nodiscard]] unsigned bin(const T& value) const
+        {
+                const T n = (value - min_) * width_r_;
+                return n > 0 ? std::min<unsigned>(n, BIN_COUNT - 1) : 0;
+        }
+
+        // The plane between the bins index and index + 1
+        [[nodiscard]] T position(const unsigned index) const
+        {
+                ASSERT(index + 1 < BIN_COUNT);
+                return min_ + (index + 1) * width_;
+        }
+};
+
+template <std::size_t N, typename T>
+struct SpatialBin final
+{
+        std::optional<spatial::BoundingBox<N, T>> bounds;
+        std::common_type_t<double, T> entry_cost = 0;
+        std::common_type_t<double, T> exit_cost = 0;
+
+        void merge(const spatial::BoundingBox<N, T>& b)
+        {
+                if (bounds)
+                {
+                        bounds->merge(b);
+                }
+                else
+                {
+                        bounds = b;
+                }
+        }
+};
+
+template <std::size_t N, typename T>
+std::array<SpatialBin<N, T>, BIN_COUNT> compute_bins(
+        const std::span<const BvhObject<N, T>> objects,
+        const Bins<N, T>& bins,
+        const BvhObjectSplit<N, T>& object_split)
+{
+        const unsigned axis = bins.axis();
+
+        std::array<SpatialBin<N, T>, BIN_COUNT> res;
+        for (const BvhObject<N, T>& object : objects)
+        {
+                const unsigned first = bins.bin(object.bounds().min()[axis]);
+                const unsigned last = bins.bin(object.bounds().max()[axis]);
+                ASSERT(first <= last);
+
+                res[first].entry_cost += object.intersection_cost();
+                res[last].exit_cost += object.intersection_cost();
+
+                std::optional<spatial::BoundingBox<N, T>> bounds = object.bounds();
+                for (unsigned i = first; i < last && bounds; ++i)
+                {
+                        const auto [min, max] = object_split(object.index(), *bounds, axis, bins.position(i));
+                        if (min)
+                        {
+                                res[i].merge(*min);
+                        }
+                        bounds = max;
+                }
+                if (bounds)
+                {
+                        res[last].merge(*bounds);
+                }
+        }
+        return res;
+}
+
+template <std::size_t N, typename T>
+struct SpatialSum final
+{
+        std::optional<spatial::BoundingBox<N, T>> bounds;
+        std::common_type_t<double, T> cost;
+};
+
+template <std::size_t N, typename T>
+std::optional<std::tuple<T, unsigned>> minimum_surface_area_heuristic_split(
+        const spatial::BoundingBox<N, T>& bounds,
+        const T& interior_node_traversal_cost,
+        const std::array<SpatialBin<N, T>, BIN_COUNT>& bins)
+{
+        std::array<SpatialSum<N, T>, BIN_COUNT - 1> backward;
+        {
+                SpatialSum<N, T> sum{.bounds = std::nullopt, .cost = 0};
+                for (unsigned i = BIN_COUNT - 1; i > 0; --i)
+                {
+                        if (bins[i].bounds)
+                        {
+                                sum.bounds = sum.bounds ? sum.bounds->merged(*bins[i].bounds) : *bins[i].bounds;
+                        }
+                        sum.cost += bins[i].exit_cost;
+                        backward[i - 1] = sum;
+                }
+        }
+
+        const T surface_r = 1 / bounds.surface();
+
+        std::optional<std::tuple<T, unsigned>> res;
+        SpatialSum<N, T> forward{.bounds = std::nullopt, .cost = 0};
+        for (unsigned i = 0; i < BIN_COUNT - 1; ++i)
+        {
+                if (bins[i].bounds)
+                {
+                        forward.bounds = forward.bounds ? forward.bounds->merged(*bins[i].bounds) : *bins[i].bounds;
+                }
+                forward.cost += bins[i].entry_cost;
+
+                if (!forward.bounds || !backward[i].bounds)
+                {
+                        continue;
+                }
+
+                const T f = forward.cost * forward.bounds->surface();
+                const T b = backward[i].cost * backward[i].bounds->surface();
+                const T cost = interior_node_traversal_cost + (f + b) * surface_r;
+                if (!res || cost < std::get<0>(*res))
+                {
+                        res.emplace(cost, i);
+                }
+        }
+        return res;
+}
+
+template <std::size_t N, typename T>
+void add(const BvhObject<N, T>& object,
+         const spatial::BoundingBox<N, T>& bounds,
+         std::vector<BvhObject<N, T>>* const objects,
+         std::optional<spatial::BoundingBox<N, T>>* const objects_bounds)
+{
+        objects->emplace_back(bounds, object.intersection_cost(), object.index());
+        if (*objects_bounds)
+        {
+                (*objects_bounds)->merge(bounds);
+        }
+        else
+        {
+                *objects_bounds = bounds;
+        }
+}
+}
+
+template <std::size_t N, typename T>
+struct BvhSpatialSplit final
+{
+        std::vector<BvhObject<N, T>> objects_min;
+        std::vector<BvhObject<N, T>> objects_max;
+        spatial::BoundingBox<N, T> bounds_min;
+        spatial::BoundingBox<N, T> bounds_max;
+        unsigned axis;
+        T cost;
+};
+
+template <std::size_t N, typename T>
+[[nodiscard]] T bvh_overlap_surface(const spatial::BoundingBox<N, T>& b1, const spatial::BoundingBox<N, T>& b2)
+{
+        const numerical::Vector<N, T> overlap_min = numerical::max(b1.min(), b2.min());
+        const numerical::Vector<N, T> overlap_max = numerical::min(b1.max(), b2.max());
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                if (!(overlap_min[i] < overlap_max[i]))
+                {
+                        return 0;
+                }
+        }
+        return spatial::BoundingBox<N, T>(overlap_min, overlap_max).surface();
+}
+
+// Objects crossing the split plane are referenced in both children
+// with the bounds clipped by the plane
+template <std::size_t N, typename T>
+std::optional<BvhSpatialSplit<N, T>> spatial_split(
+        const std::span<const BvhObject<N, T>> objects,
+        const spatial::BoundingBox<N, T>& bounds,
+        const T& interior_node_traversal_cost,
+        const BvhObjectSplit<N, T>& object_split)
+{
+        namespace impl = bvh_spatial_split_implementation;
+
+        ASSERT(object_split);
+
+        if (objects.size() <= 1)
+        {
+                return {};
+        }
+
+        std::common_type_t<double, T> cost = 0;
+        for (const BvhObject<N, T>& object : objects)
+        {
+                cost += object.intersection_cost();
+        }
+
+        const impl::Bins<N, T> bins(bounds);
+        if (bins.is_empty())
+        {
+                return {};
+        }
+
+        const auto split = impl::minimum_surface_area_heuristic_split(
+                bounds, interior_node_traversal_cost, impl::compute_bins(objects, bins, object_split));
+        if (!split || std::get<0>(*split) >= cost)
+        {
+                return {};
+        }
+
+        const unsigned axis = bins.axis();
+        const T position = bins.position(std::get<1>(*split));
+
+        std::vector<BvhObject<N, T>> objects_min;
+        std::vector<BvhObject<N, T>> objects_max;
+        std::optional<spatial::BoundingBox<N, T>> bounds_min;
+        std::optional<spatial::BoundingBox<N, T>> bounds_max;
+
+        for (const BvhObject<N, T>& object : objects)
+        {
+                if (object.bounds().max()[axis] <= position)
+                {
+                        impl::add(object, object.bounds(), &objects_min, &bounds_min);
+                        continue;
+                }
+                if (object.bounds().min()[axis] >= position)
+                {
+                        impl::add(object, object.bounds(), &objects_max, &bounds_max);
+                        continue;
+                }
+                const auto [min, max] = object_split(object.index(), object.bounds(), axis, position);
+                if (min)
+                {
+                        impl::add(object, *min, &objects_min, &bounds_min);
+                }
+                if (max)
+                {
+                        impl::add(object, *max, &objects_max, &bounds_max);
+                }
+        }
+
+        if (objects_min.empty() || objects_max.empty())
+        {
+                return {};
+        }
+
+        return {
+                {.objects_min = std::move(objects_min),
+                 .objects_max = std::move(objects_max),
+                 .bounds_min = *bounds_min,
+                 .bounds_max = *bounds_max,
+                 .axis = axis,
+                 .cost = std::get<0>(*split)}
+        };
+}
+}
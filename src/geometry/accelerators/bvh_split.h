@@ -264,6 +264,7 @@ struct BvhSplit final
         spatial::BoundingBox<N, T> bounds_min;
         spatial::BoundingBox<N, T> bounds_max;
         unsigned axis;
+        T cost;
 };
 
 template <std::size_t N, typename T>
@@ -310,7 +311,8 @@ std::optional<BvhSplit<N, T>> split(
                  .objects_max = std::span(std::to_address(p), objects.end() - p),
                  .bounds_min = forward_sum[split_index].bounds,
                  .bounds_max = backward_sum[split_index].bounds,
-                 .axis = center_bounds.axis()}
+                 .axis = center_bounds.axis(),
+                 .cost = split_cost}
         };
 }
 }
@@ -30,8 +30,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/progress/progress.h>
 #include <src/settings/instantiation.h>
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 namespace ns::geometry::core
@@ -75,38 +79,75 @@ std::vector<PointType> create_points(const std::vector<numerical::Vector<N, Sour
         return res;
 }
 
+template <typename Facet>
+class FacetIndex final
+{
+        std::vector<std::tuple<const Facet*, int>> facets_;
+
+public:
+        explicit FacetIndex(const std::vector<const Facet*>& facets)
+        {
+                facets_.reserve(facets.size());
+                for (std::size_t i = 0; i < facets.size(); ++i)
+                {
+                        facets_.emplace_back(facets[i], i);
+                }
+                std::ranges::sort(facets_);
+        }
+
+        [[nodiscard]] int find(const Facet* const facet) const
+        {
+                const auto iter = std::ranges::lower_bound(
+                        facets_, facet, std::less{},
+                        [](const std::tuple<const Facet*, int>& v)
+                        {
+                                return std::get<0>(v);
+                        });
+                ASSERT(iter != facets_.cend() && std::get<0>(*iter) == facet);
+                return std::get<1>(*iter);
+        }
+};
+
 template <std::size_t N, typename Data, typename Compute>
 std::vector<DelaunaySimplex<N>> lower_convex_hull_simplices(
         const ch::DelaunayPoints<N>& points,
         const ch::FacetList<ch::Facet<N + 1, Data, Compute>>& convex_hull_facets)
 {
-        using S = ch::DelaunayDataType<N>;
-        using C = ch::DelaunayComputeType<N>;
+        using Facet = ch::Facet<N + 1, Data, Compute>;
 
-        const std::vector<numerical::Vector<N, S>> data = create_points<numerical::Vector<N, S>>(points.points());
-
-        std::vector<DelaunaySimplex<N>> res;
-        res.reserve(convex_hull_facets.size());
-
-        for (const auto& facet : convex_hull_facets)
+        std::vector<const Facet*> facets;
+        for (const Facet& facet : convex_hull_facets)
         {
-                if (!facet.last_ortho_coord_is_negative())
+                if (facet.last_ortho_coord_is_negative())
                 {
-                        // not the lower convex hull
-                        continue;
+                        facets.push_back(&facet);
                 }
+        }
 
-                const std::array<int, N + 1>& vertices = facet.vertices();
+        // the order of the convex hull facets depends on the thread count
+        std::ranges::sort(
+                facets, std::less{},
+                [](const Facet* const facet)
+                {
+                        return facet->vertices();
+                });
+
+        const FacetIndex<Facet> facet_index(facets);
 
-                std::array<numerical::Vector<N, double>, N + 1> orthos;
+        std::vector<DelaunaySimplex<N>> res;
+        res.reserve(facets.size());
+
+        for (const Facet* const facet : facets)
+        {
+                std::array<int, N + 1> neighbors;
                 for (std::size_t r = 0; r < N + 1; ++r)
                 {
-                        // ortho is directed outside
-                        orthos[r] = ch::Facet<N, S, C>(data, del_elem(vertices, r), vertices[r])
-                                            .template ortho_fp<double>();
+                        const Facet* const link = facet->link(r);
+                        // only the lower convex hull facets are Delaunay simplices
+                        neighbors[r] = link->last_ortho_coord_is_negative() ? facet_index.find(link) : -1;
                 }
 
-                res.emplace_back(points.restore_indices(vertices), orthos);
+                res.emplace_back(points.restore_indices(facet->vertices()), neighbors);
         }
 
         return res;
@@ -127,29 +168,43 @@ std::vector<ConvexHullSimplex<N>> convex_hull_simplices(
 }
 
 template <std::size_t N>
-std::vector<DelaunaySimplex<N>> compute_delaunay(const ch::DelaunayPoints<N>& points, progress::Ratio* const progress)
+std::vector<DelaunaySimplex<N>> compute_delaunay(
+        const ch::DelaunayPoints<N>& points,
+        progress::Ratio* const progress,
+        const bool write_log)
 {
         using S = ch::DelaunayParaboloidDataType<N + 1>;
         using C = ch::DelaunayParaboloidComputeType<N + 1>;
 
-        const ch::FacetList<ch::Facet<N + 1, S, C>> facets = ch::compute_convex_hull<C>(
+        const ch::ConvexHullFacets<ch::Facet<N + 1, S, C>> facets = ch::compute_convex_hull<C>(
                 create_points_paraboloid<numerical::Vector<N + 1, S>>(points.points()), progress);
 
-        return lower_convex_hull_simplices(points, facets);
+        if (write_log)
+        {
+                LOG(facets.pool->description());
+        }
+
+        return lower_convex_hull_simplices(points, facets.facets);
 }
 
 template <std::size_t N>
 std::vector<ConvexHullSimplex<N>> compute_convex_hull(
         const ch::ConvexHullPoints<N>& points,
-        progress::Ratio* const progress)
+        progress::Ratio* const progress,
+        const bool write_log)
 {
         using S = ch::ConvexHullDataType<N>;
         using C = ch::ConvexHullComputeType<N>;
 
-        const ch::FacetList<ch::Facet<N, S, C>> facets =
+        const ch::ConvexHullFacets<ch::Facet<N, S, C>> facets =
                 ch::compute_convex_hull<C>(create_points<numerical::Vector<N, S>>(points.points()), progress);
 
-        return convex_hull_simplices(points, facets);
+        if (write_log)
+        {
+                LOG(facets.pool->description());
+        }
+
+        return convex_hull_simplices(points, facets.facets);
 }
 }
 
@@ -159,6 +214,8 @@ DelaunayData<N> compute_delaunay(
         progress::Ratio* const progress,
         const bool write_log)
 {
+        static_assert(std::is_same_v<DelaunayPoint<N>, numerical::Vector<N, ch::DelaunayDataType<N>>>);
+
         if (points.empty())
         {
                 error("No points to compute delaunay");
@@ -176,12 +233,12 @@ DelaunayData<N> compute_delaunay(
                 LOG(ch::delaunay_type_description<N>());
         }
 
-        std::vector<DelaunaySimplex<N>> simplices = compute_delaunay(delaunay_points, progress);
+        std::vector<DelaunaySimplex<N>> simplices = compute_delaunay(delaunay_points, progress, write_log);
 
-        std::vector<numerical::Vector<N, double>> result_points(points.size(), numerical::Vector<N, double>(0));
+        std::vector<DelaunayPoint<N>> result_points(points.size(), DelaunayPoint<N>(0));
         for (std::size_t i = 0; i < delaunay_points.points().size(); ++i)
         {
-                result_points[delaunay_points.restore_index(i)] = to_vector<double>(delaunay_points.points()[i]);
+                result_points[delaunay_points.restore_index(i)] = delaunay_points.points()[i];
         }
 
         if (write_log)
@@ -192,6 +249,22 @@ DelaunayData<N> compute_delaunay(
         return {.points = std::move(result_points), .simplices = std::move(simplices)};
 }
 
+template <std::size_t N>
+numerical::Vector<N, double> compute_delaunay_facet_ortho(
+        const std::vector<DelaunayPoint<N>>& points,
+        const DelaunaySimplex<N>& simplex,
+        const unsigned vertex_index)
+{
+        using S = ch::DelaunayDataType<N>;
+        using C = ch::DelaunayComputeType<N>;
+
+        ASSERT(vertex_index < N + 1);
+
+        // ortho is directed outside
+        return ch::Facet<N, S, C>(points, del_elem(simplex.vertices(), vertex_index), simplex.vertices()[vertex_index])
+                .template ortho_fp<double>();
+}
+
 template <std::size_t N>
 std::vector<ConvexHullSimplex<N>> compute_convex_hull(
         const std::vector<numerical::Vector<N, float>>& points,
@@ -215,7 +288,7 @@ std::vector<ConvexHullSimplex<N>> compute_convex_hull(
                 LOG(ch::convex_hull_type_description<N>());
         }
 
-        std::vector<ConvexHullSimplex<N>> res = compute_convex_hull(convex_hull_points, progress);
+        std::vector<ConvexHullSimplex<N>> res = compute_convex_hull(convex_hull_points, progress, write_log);
 
         if (write_log)
         {
@@ -229,10 +302,15 @@ std::vector<ConvexHullSimplex<N>> compute_convex_hull(
         template DelaunayData<N> compute_delaunay( \
                 const std::vector<numerical::Vector<(N), float>>&, progress::Ratio*, bool);
 
+#define TEMPLATE_DELAUNAY_FACET_ORTHO(N)                                      \
+        template numerical::Vector<(N), double> compute_delaunay_facet_ortho( \
+                const std::vector<DelaunayPoint<(N)>>&, const DelaunaySimplex<(N)>&, unsigned);
+
 #define TEMPLATE_CONVEX_HULL(N)                                           \
         template std::vector<ConvexHullSimplex<(N)>> compute_convex_hull( \
                 const std::vector<numerical::Vector<(N), float>>&, progress::Ratio*, bool);
 
 TEMPLATE_INSTANTIATION_N_2(TEMPLATE_DELAUNAY)
+TEMPLATE_INSTANTIATION_N_2(TEMPLATE_DELAUNAY_FACET_ORTHO)
 TEMPLATE_INSTANTIATION_N_2_A(TEMPLATE_CONVEX_HULL)
 }
@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace ns::geometry::core
@@ -55,14 +56,15 @@ template <std::size_t N>
 class DelaunaySimplex final
 {
         std::array<int, N + 1> indices_;
-        std::array<numerical::Vector<N, double>, N + 1> orthos_;
+
+        // the simplex opposite to the vertex,
+        // negative if there is no simplex
+        std::array<int, N + 1> neighbors_;
 
 public:
-        DelaunaySimplex(
-                const std::array<int, N + 1>& indices,
-                const std::array<numerical::Vector<N, double>, N + 1>& orthos)
+        DelaunaySimplex(const std::array<int, N + 1>& indices, const std::array<int, N + 1>& neighbors)
                 : indices_(indices),
-                  orthos_(orthos)
+                  neighbors_(neighbors)
         {
         }
 
@@ -71,17 +73,21 @@ public:
                 return indices_;
         }
 
-        [[nodiscard]] const numerical::Vector<N, double>& ortho(const unsigned index) const
+        [[nodiscard]] int neighbor(const unsigned index) const
         {
-                ASSERT(index < orthos_.size());
-                return orthos_[index];
+                ASSERT(index < neighbors_.size());
+                return neighbors_[index];
         }
 };
 
+// the integer coordinates of the Delaunay computation
+template <std::size_t N>
+using DelaunayPoint = numerical::Vector<N, std::int_least32_t>;
+
 template <std::size_t N>
 struct DelaunayData final
 {
-        std::vector<numerical::Vector<N, double>> points;
+        std::vector<DelaunayPoint<N>> points;
         std::vector<DelaunaySimplex<N>> simplices;
 };
 
@@ -91,6 +97,14 @@ DelaunayData<N> compute_delaunay(
         progress::Ratio* progress,
         bool write_log);
 
+// the ortho of the simplex facet opposite to the vertex,
+// the vector is directed outside
+template <std::size_t N>
+numerical::Vector<N, double> compute_delaunay_facet_ortho(
+        const std::vector<DelaunayPoint<N>>& points,
+        const DelaunaySimplex<N>& simplex,
+        unsigned vertex_index);
+
 template <std::size_t N>
 std::vector<ConvexHullSimplex<N>> compute_convex_hull(
         const std::vector<numerical::Vector<N, float>>& points,
@@ -44,6 +44,7 @@ The projection to the n-space of the lower convex hull of the points
 
 #include "facet.h"
 #include "facet_connector.h"
+#include "facet_pool.h"
 #include "facet_storage.h"
 #include "point_set.h"
 #include "simplex_points.h"
@@ -60,14 +61,28 @@ The projection to the n-space of the lower convex hull of the points
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <barrier>
 #include <cstddef>
+#include <memory>
+#include <optional>
 #include <vector>
 
 namespace ns::geometry::core::convex_hull
 {
+template <typename Facet>
+struct ConvexHullFacets final
+{
+        std::unique_ptr<FacetPool> pool;
+        // destroyed before the pool
+        FacetList<Facet> facets;
+};
+
 namespace compute_implementation
 {
+inline constexpr std::size_t MAX_BATCH_SIZE = 256;
+inline constexpr std::size_t BATCH_LOOKAHEAD = 1024;
+
 template <typename S, typename C>
 int thread_count_for_horizon()
 {
@@ -130,13 +145,17 @@ void add_conflict_points_to_new_facet(
         const Facet* const facet_1,
         Facet* const new_facet)
 {
+        thread_local std::vector<int> conflict_points;
+
+        conflict_points.clear();
+
         point_set->set(facet_0->conflict_points());
 
         for (const int p : facet_0->conflict_points())
         {
                 if (p != point && new_facet->visible_from_point(points, p))
                 {
-                        new_facet->add_conflict_point(p);
+                        conflict_points.push_back(p);
                 }
         }
 
@@ -144,11 +163,14 @@ void add_conflict_points_to_new_facet(
         {
                 if (!point_set->contains(p) && p != point && new_facet->visible_from_point(points, p))
                 {
-                        new_facet->add_conflict_point(p);
+                        conflict_points.push_back(p);
                 }
         }
 
         point_set->clear(facet_0->conflict_points());
+
+        // one allocation without extra capacity
+        new_facet->set_conflict_points(conflict_points);
 }
 
 template <typename Facet>
@@ -202,6 +224,34 @@ void add_new_facets_to_conflict_points(
         }
 }
 
+template <typename Point, typename Facet>
+void create_facet_for_ridge(
+        const std::vector<Point>& points,
+        const int point,
+        const Facet* const facet,
+        const std::size_t vertex_index,
+        PointSet* const point_set,
+        FacetList<Facet>* const new_facets)
+{
+        Facet* const link_facet = facet->link(vertex_index);
+
+        const int link_index = link_facet->find_link_index(facet);
+
+        new_facets->emplace_back(
+                points, set_elem(facet->vertices(), vertex_index, point), link_facet->vertices()[link_index],
+                *link_facet);
+
+        const auto new_iter = std::prev(new_facets->end());
+
+        Facet* const new_facet = &(*new_iter);
+        new_facet->set_iter(new_iter);
+
+        new_facet->set_link(new_facet->find_index_for_point(point), link_facet);
+        link_facet->set_link(link_index, new_facet);
+
+        add_conflict_points_to_new_facet(points, point, point_set, facet, link_facet, new_facet);
+}
+
 template <typename Point, typename Facet>
 void create_facet_for_point_and_horizon(
         const unsigned thread_count,
@@ -230,21 +280,7 @@ void create_facet_for_point_and_horizon(
         ++ridge_count;
         ridge_index += thread_count;
 
-        const int link_index = link_facet->find_link_index(facet);
-
-        new_facets->emplace_back(
-                points, set_elem(facet->vertices(), vertex_index, point), link_facet->vertices()[link_index],
-                *link_facet);
-
-        const auto new_iter = std::prev(new_facets->end());
-
-        Facet* const new_facet = &(*new_iter);
-        new_facet->set_iter(new_iter);
-
-        new_facet->set_link(new_facet->find_index_for_point(point), link_facet);
-        link_facet->set_link(link_index, new_facet);
-
-        add_conflict_points_to_new_facet(points, point, point_set, facet, link_facet, new_facet);
+        create_facet_for_ridge(points, point, facet, vertex_index, point_set, new_facets);
 }
 
 template <typename Point, typename Facet>
@@ -278,6 +314,40 @@ void create_facets_for_point_and_horizon(
         }
 }
 
+template <typename Point, typename Facet>
+void create_facets_for_point_and_horizon(
+        const std::vector<Point>& points,
+        const int point,
+        const std::vector<FacetStorage<Facet>>& point_conflicts,
+        PointSet* const point_set,
+        std::vector<FacetList<Facet>>* const new_facets_vector)
+{
+        // The same distribution of the facets over the lists
+        // as with one thread for each list
+        for (FacetList<Facet>& new_facets : *new_facets_vector)
+        {
+                new_facets.clear();
+        }
+
+        std::size_t ridge_count = 0;
+
+        for (const Facet* const facet : point_conflicts[point])
+        {
+                for (std::size_t i = 0; i < facet->vertices().size(); ++i)
+                {
+                        if (facet->link(i)->marked_as_visible())
+                        {
+                                continue;
+                        }
+
+                        FacetList<Facet>* const new_facets =
+                                &(*new_facets_vector)[ridge_count++ % new_facets_vector->size()];
+
+                        create_facet_for_ridge(points, point, facet, i, point_set, new_facets);
+                }
+        }
+}
+
 template <std::size_t N, typename S, typename C>
 void create_horizon_facets(
         const unsigned thread_id,
@@ -343,7 +413,8 @@ void add_point_to_convex_hull(
         std::vector<FacetStorage<Facet<N, S, C>>>* const point_conflicts,
         ThreadPool* const thread_pool,
         std::barrier<>* const barrier,
-        std::vector<PointSet>* const point_set_work)
+        std::vector<PointSet>* const point_set_work,
+        FacetPool* const facet_pool)
 {
         if ((*point_conflicts)[point].size() == 0)
         {
@@ -366,6 +437,7 @@ void add_point_to_convex_hull(
         thread_pool->run(
                 [&](const unsigned thread_id, const unsigned thread_count)
                 {
+                        const FacetPool::Scope scope(facet_pool, thread_id);
                         create_horizon_facets(
                                 thread_id, thread_count, points, point, point_conflicts, point_set_work, &new_facets,
                                 barrier);
@@ -388,8 +460,182 @@ void add_point_to_convex_hull(
         }
 }
 
+template <typename Facet>
+[[nodiscard]] bool mark_facets_for_batch(const FacetStorage<Facet>& visible_facets, const unsigned batch)
+{
+        for (const Facet* const facet : visible_facets)
+        {
+                if (facet->marked_for_batch(batch))
+                {
+                        return false;
+                }
+                for (std::size_t i = 0; i < facet->vertices().size(); ++i)
+                {
+                        if (facet->link(i)->marked_for_batch(batch))
+                        {
+                                return false;
+                        }
+                }
+        }
+
+        for (const Facet* const facet : visible_facets)
+        {
+                facet->mark_for_batch(batch);
+                for (std::size_t i = 0; i < facet->vertices().size(); ++i)
+                {
+                        facet->link(i)->mark_for_batch(batch);
+                }
+        }
+
+        return true;
+}
+
+// Points, starting from the point with index begin, that do not share
+// visible facets and horizon facets. Their insertions do not change
+// the visible facets of each other, so they can be inserted simultaneously.
+// Consecutive points of the biased randomized order are close to each other,
+// so the points that share facets with the batch are skipped and the search
+// continues up to the lookahead distance from the first skipped point.
+// The skipped points are inserted by the next batches, the returned index
+// is the index of the first skipped point. With the zero lookahead
+// the batch is a run of consecutive points.
+template <typename Facet>
+std::size_t find_batch(
+        const std::size_t begin,
+        const std::vector<unsigned char>& enabled,
+        const std::size_t facet_count,
+        const std::vector<FacetStorage<Facet>>& point_conflicts,
+        const std::size_t lookahead,
+        const unsigned batch_index,
+        std::vector<int>* const batch)
+{
+        batch->clear();
+
+        std::optional<std::size_t> skipped;
+
+        std::size_t i = begin;
+        for (; i < enabled.size() && batch->size() < MAX_BATCH_SIZE; ++i)
+        {
+                if (skipped && i - *skipped > lookahead)
+                {
+                        break;
+                }
+
+                if (!enabled[i] || point_conflicts[i].size() == 0)
+                {
+                        // the point is inside the convex hull
+                        continue;
+                }
+
+                if (point_conflicts[i].size() >= facet_count)
+                {
+                        error("All facets are visible from the point");
+                }
+
+                if (!mark_facets_for_batch(point_conflicts[i], batch_index))
+                {
+                        if (!skipped)
+                        {
+                                skipped = i;
+                        }
+                        continue;
+                }
+
+                batch->push_back(i);
+        }
+
+        return skipped ? *skipped : i;
+}
+
+template <std::size_t N, typename S, typename C>
+void create_batch_facets(
+        const unsigned thread_id,
+        const unsigned thread_count,
+        const std::vector<numerical::Vector<N, S>>& points,
+        const std::vector<int>& batch,
+        std::atomic_size_t* const task,
+        std::vector<FacetStorage<Facet<N, S, C>>>* const point_conflicts,
+        std::vector<PointSet>* const point_set_work,
+        std::vector<std::vector<FacetList<Facet<N, S, C>>>>* const new_facets,
+        std::barrier<>* const barrier)
+{
+        try
+        {
+                std::size_t i;
+                while ((i = (*task)++) < batch.size())
+                {
+                        create_facets_for_point_and_horizon(
+                                points, batch[i], *point_conflicts, &(*point_set_work)[thread_id], &(*new_facets)[i]);
+
+                        connect_facets(batch[i], &(*new_facets)[i]);
+                }
+        }
+        catch (...)
+        {
+                barrier->arrive_and_wait();
+                throw;
+        }
+        barrier->arrive_and_wait();
+
+        // in the order of the sequential insertion
+        for (std::size_t i = 0; i < batch.size(); ++i)
+        {
+                erase_visible_facets_from_conflict_points(thread_id, thread_count, point_conflicts, batch[i]);
+                add_new_facets_to_conflict_points(thread_id, thread_count, (*new_facets)[i], point_conflicts);
+        }
+}
+
+template <std::size_t N, typename S, typename C>
+void add_points_to_convex_hull(
+        const std::vector<numerical::Vector<N, S>>& points,
+        const std::vector<int>& batch,
+        FacetList<Facet<N, S, C>>* const facets,
+        std::vector<FacetStorage<Facet<N, S, C>>>* const point_conflicts,
+        ThreadPool* const thread_pool,
+        std::barrier<>* const barrier,
+        std::vector<PointSet>* const point_set_work,
+        FacetPool* const facet_pool)
+{
+        for (const int point : batch)
+        {
+                for (const Facet<N, S, C>* const facet : (*point_conflicts)[point])
+                {
+                        facet->mark_as_visible();
+                }
+        }
+
+        std::vector<std::vector<FacetList<Facet<N, S, C>>>> new_facets(
+                batch.size(), std::vector<FacetList<Facet<N, S, C>>>(thread_pool->thread_count()));
+
+        std::atomic_size_t task = 0;
+
+        thread_pool->run(
+                [&](const unsigned thread_id, const unsigned thread_count)
+                {
+                        const FacetPool::Scope scope(facet_pool, thread_id);
+                        create_batch_facets(
+                                thread_id, thread_count, points, batch, &task, point_conflicts, point_set_work,
+                                &new_facets, barrier);
+                });
+
+        for (std::size_t i = 0; i < batch.size(); ++i)
+        {
+                for (const Facet<N, S, C>* const facet : (*point_conflicts)[batch[i]])
+                {
+                        facets->erase(facet->iter());
+                }
+
+                (*point_conflicts)[batch[i]].clear();
+
+                for (FacetList<Facet<N, S, C>>& facet_list : new_facets[i])
+                {
+                        facets->splice(facets->cend(), facet_list);
+                }
+        }
+}
+
 template <typename C, std::size_t N, typename S>
-FacetList<Facet<N, S, C>> compute_convex_hull(
+ConvexHullFacets<Facet<N, S, C>> compute_convex_hull(
         const std::vector<numerical::Vector<N, S>>& points,
         progress::Ratio* const progress)
 {
@@ -400,6 +646,13 @@ FacetList<Facet<N, S, C>> compute_convex_hull(
                 error("Error point count " + to_string(points.size()) + " for convex hull in " + space_name(N));
         }
 
+        ThreadPool thread_pool(thread_count_for_horizon<S, C>());
+        std::barrier<> barrier(thread_pool.thread_count());
+
+        // The calling thread allocates when the thread pool is not running
+        auto facet_pool = std::make_unique<FacetPool>(thread_pool.thread_count());
+        const FacetPool::Scope facet_pool_scope(facet_pool.get(), 0);
+
         FacetList<Facet<N, S, C>> facets;
 
         std::array<int, N + 1> initial_vertices;
@@ -416,25 +669,37 @@ FacetList<Facet<N, S, C>> compute_convex_hull(
 
         create_initial_conflict_lists(points, point_enabled, &facets, &point_conflicts);
 
-        ThreadPool thread_pool(thread_count_for_horizon<S, C>());
-        std::barrier<> barrier(thread_pool.thread_count());
-
         std::vector<PointSet> point_set_work(thread_pool.thread_count(), points.size());
 
-        // Initial simplex created, so N + 1 points already processed
-        for (std::size_t i = 0, points_processed = N + 1; i < points.size(); ++i, ++points_processed)
+        // Batches are inserted in parallel only with several threads
+        const std::size_t batch_lookahead = (thread_pool.thread_count() > 1) ? BATCH_LOOKAHEAD : 0;
+
+        std::vector<int> batch;
+        unsigned batch_index = 0;
+
+        for (std::size_t i = 0; i < points.size();)
         {
-                if (!point_enabled[i])
+                if (progress::Ratio::lock_free())
                 {
-                        continue;
+                        // Initial simplex created, so N + 1 points already processed
+                        progress->set(i + N + 1, points.size());
                 }
 
-                if (progress::Ratio::lock_free())
+                i = find_batch(
+                        i, point_enabled, facets.size(), point_conflicts, batch_lookahead, ++batch_index, &batch);
+
+                if (batch.size() == 1)
                 {
-                        progress->set(points_processed, points.size());
+                        add_point_to_convex_hull(
+                                points, batch.front(), &facets, &point_conflicts, &thread_pool, &barrier,
+                                &point_set_work, facet_pool.get());
+                }
+                else if (batch.size() > 1)
+                {
+                        add_points_to_convex_hull(
+                                points, batch, &facets, &point_conflicts, &thread_pool, &barrier, &point_set_work,
+                                facet_pool.get());
                 }
-
-                add_point_to_convex_hull(points, i, &facets, &point_conflicts, &thread_pool, &barrier, &point_set_work);
         }
 
         ASSERT(std::all_of(
@@ -444,12 +709,12 @@ FacetList<Facet<N, S, C>> compute_convex_hull(
                         return facet.conflict_points().empty();
                 }));
 
-        return facets;
+        return {.pool = std::move(facet_pool), .facets = std::move(facets)};
 }
 }
 
 template <typename C, std::size_t N, typename S>
-FacetList<Facet<N, S, C>> compute_convex_hull(
+ConvexHullFacets<Facet<N, S, C>> compute_convex_hull(
         const std::vector<numerical::Vector<N, S>>& points,
         progress::Ratio* const progress)
 {
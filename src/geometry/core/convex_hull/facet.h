@@ -18,6 +18,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include "facet_ortho.h"
+#include "facet_pool.h"
 
 #include <src/com/error.h>
 #include <src/com/print.h>
@@ -32,7 +33,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 namespace ns::geometry::core::convex_hull
 {
 template <typename F>
-using FacetList = std::list<F>;
+using FacetList = std::list<F, FacetAllocator<F>>;
 
 template <typename F>
 using FacetListIter = FacetList<F>::const_iterator;
@@ -46,6 +47,7 @@ class Facet final
         FacetListIter<Facet> facet_iter_;
         std::array<Facet*, N> links_;
         mutable bool marked_as_visible_ = false;
+        mutable unsigned batch_ = 0;
 
 public:
         Facet(const std::vector<numerical::Vector<N, DataType>>& points,
@@ -82,6 +84,13 @@ public:
                 conflict_points_.push_back(point);
         }
 
+        void set_conflict_points(const std::vector<int>& points)
+        {
+                ASSERT(conflict_points_.empty());
+                conflict_points_.reserve(points.size());
+                conflict_points_.assign(points.cbegin(), points.cend());
+        }
+
         [[nodiscard]] const std::vector<int>& conflict_points() const
         {
                 return conflict_points_;
@@ -131,6 +140,16 @@ public:
                 return marked_as_visible_;
         }
 
+        void mark_for_batch(const unsigned batch) const
+        {
+                batch_ = batch;
+        }
+
+        [[nodiscard]] bool marked_for_batch(const unsigned batch) const
+        {
+                return batch_ == batch;
+        }
+
         [[nodiscard]] const std::array<int, N>& vertices() const
         {
                 return vertices_;
@@ -18,19 +18,19 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <src/com/error.h>
+#include <src/com/flat_hash_map.h>
 #include <src/geometry/core/ridge.h>
 
 #include <array>
 #include <cstddef>
 #include <tuple>
-#include <unordered_map>
 
 namespace ns::geometry::core::convex_hull
 {
 template <std::size_t N, typename Facet>
 class FacetConnector final
 {
-        std::unordered_map<Ridge<N>, std::tuple<Facet*, unsigned>> ridge_map_;
+        FlatHashMap<Ridge<N>, std::tuple<Facet*, unsigned>> ridge_map_;
         std::size_t expected_ridge_count_;
         std::size_t ridge_count_ = 0;
 
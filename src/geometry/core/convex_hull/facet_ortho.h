@@ -18,15 +18,19 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <src/com/error.h>
+#include <src/com/fixed_integer.h>
 #include <src/com/set_mpz.h>
 #include <src/com/type/concept.h>
+#include <src/com/type/limit.h>
 #include <src/numerical/complement.h>
 #include <src/numerical/vector.h>
 
 #include <gmp.h>
 #include <gmpxx.h>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstddef>
 #include <type_traits>
 #include <vector>
@@ -70,7 +74,7 @@ void reduce(numerical::Vector<N, mpz_class>* const v)
 template <std::size_t N, typename T>
 void negate(numerical::Vector<N, T>* const v)
 {
-        static_assert(!std::is_class_v<T>);
+        static_assert(!std::is_same_v<T, mpz_class>);
 
         for (std::size_t i = 0; i < N; ++i)
         {
@@ -92,7 +96,7 @@ void negate(numerical::Vector<N, mpz_class>* const v)
 template <std::size_t N, typename T>
 [[nodiscard]] bool are_opposite(const numerical::Vector<N, T>& v1, const numerical::Vector<N, T>& v2)
 {
-        static_assert(!std::is_class_v<T>);
+        static_assert(!std::is_same_v<T, mpz_class>);
 
         for (std::size_t i = 0; i < N; ++i)
         {
@@ -124,7 +128,7 @@ template <std::size_t N>
 template <std::size_t N, typename T>
 [[nodiscard]] bool last_coord_is_negative(const numerical::Vector<N, T>& v)
 {
-        static_assert(!std::is_class_v<T>);
+        static_assert(!std::is_same_v<T, mpz_class>);
 
         return v[N - 1] < 0;
 }
@@ -146,6 +150,30 @@ template <typename Result, std::size_t N, typename T>
         return to_vector<Result>(v).normalized();
 }
 
+template <typename Result, std::size_t N, std::size_t BITS>
+[[nodiscard]] numerical::Vector<N, Result> normalize(const numerical::Vector<N, FixedInteger<BITS>>& v)
+{
+        static_assert(std::is_same_v<Result, float> || std::is_same_v<Result, double>);
+
+        // The values can be out of the float range
+        // and their squares out of the double range
+        numerical::Vector<N, double> res;
+        double max = 0;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                res[i] = static_cast<double>(v[i]);
+                max = std::max(max, std::abs(res[i]));
+        }
+
+        ASSERT(max > 0);
+
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                res[i] /= max;
+        }
+        return to_vector<Result>(res.normalized());
+}
+
 template <typename Result, std::size_t N>
 [[nodiscard]] numerical::Vector<N, Result> normalize(const numerical::Vector<N, mpz_class>& v)
 {
@@ -188,7 +216,7 @@ template <std::size_t N, typename DataType, typename ComputeType>
         const int from_index,
         const int to_index)
 {
-        static_assert(!std::is_class_v<DataType> && !std::is_class_v<ComputeType>);
+        static_assert(!std::is_class_v<DataType> && !std::is_same_v<ComputeType, mpz_class>);
         static_assert(std::is_same_v<ComputeType, std::common_type_t<ComputeType, DataType>>);
 
         const numerical::Vector<N, DataType>& from = points[from_index];
@@ -251,6 +279,97 @@ template <std::size_t N>
 
         return mpz_sgn(d.get_mpz_t());
 }
+
+//
+
+template <typename T>
+[[nodiscard]] double to_double(const T& v)
+{
+        static_assert(!std::is_same_v<T, mpz_class>);
+
+        return static_cast<double>(v);
+}
+
+[[nodiscard]] inline double to_double(const mpz_class& v)
+{
+        return v.get_d();
+}
+
+// Upper bound of the relative error of to_double in units of 2^(-53)
+template <typename T>
+inline constexpr int TO_DOUBLE_ERROR = []
+{
+        if constexpr (std::is_same_v<T, mpz_class>)
+        {
+                // truncation
+                return 2;
+        }
+        else if constexpr (IS_FIXED_INTEGER<T>)
+        {
+                // sum of the converted words
+                return 2 * T::BIT_COUNT / 64;
+        }
+        else
+        {
+                return 1;
+        }
+}();
+
+template <std::size_t N, typename T>
+[[nodiscard]] numerical::Vector<N, double> to_double(const numerical::Vector<N, T>& v)
+{
+        numerical::Vector<N, double> res;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                res[i] = to_double(v[i]);
+        }
+        return res;
+}
+
+// Error bound of the floating point dot product relative to
+// the sum of the absolute values of the products.
+// Conversions of the vector and the point coordinates, products
+// and N - 1 additions, multiplied by 2 to cover the second order
+// terms and the rounding of the sum of the absolute values.
+template <std::size_t N, typename ComputeType>
+inline constexpr double DOT_PRODUCT_ERROR = (TO_DOUBLE_ERROR<ComputeType> + N + 2) * Limits<double>::epsilon();
+
+// The sign of the dot product, or 0 if the sign
+// cannot be determined in floating point
+template <std::size_t N, typename ComputeType, typename DataType>
+[[nodiscard]] int dot_product_sign_filter(
+        const numerical::Vector<N, double>& v,
+        const std::vector<numerical::Vector<N, DataType>>& points,
+        const int from_index,
+        const int to_index)
+{
+        static_assert(!std::is_class_v<DataType>);
+
+        const numerical::Vector<N, DataType>& from = points[from_index];
+        const numerical::Vector<N, DataType>& to = points[to_index];
+
+        double d = 0;
+        double sum = 0;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                const double p = v[i] * static_cast<double>(to[i] - from[i]);
+                d += p;
+                sum += std::abs(p);
+        }
+
+        const double error = sum * DOT_PRODUCT_ERROR<N, ComputeType>;
+
+        // false for non-finite values
+        if (d > error)
+        {
+                return 1;
+        }
+        if (d < -error)
+        {
+                return -1;
+        }
+        return 0;
+}
 }
 
 template <std::size_t N, typename DataType, typename ComputeType>
@@ -261,7 +380,24 @@ class FacetOrtho final
 
         static constexpr bool REDUCE = false;
 
+        // Multiword types are filtered with floating point
+        static constexpr bool FILTER = std::is_class_v<ComputeType> && !std::is_class_v<DataType>;
+
+        struct NoFilter final
+        {
+        };
+
         numerical::Vector<N, ComputeType> ortho_;
+        [[no_unique_address]] std::conditional_t<FILTER, numerical::Vector<N, double>, NoFilter> ortho_fp_;
+
+        void negate()
+        {
+                facet_ortho_implementation::negate(&ortho_);
+                if constexpr (FILTER)
+                {
+                        ortho_fp_ = -ortho_fp_;
+                }
+        }
 
         template <bool USE_DIRECTION_FACET>
         FacetOrtho(
@@ -281,7 +417,12 @@ class FacetOrtho final
                         impl::reduce(&ortho_);
                 }
 
-                const auto v = impl::dot_product_sign(ortho_, points, vertices[0], direction_point);
+                if constexpr (FILTER)
+                {
+                        ortho_fp_ = impl::to_double(ortho_);
+                }
+
+                const auto v = dot_product_sign(points, vertices[0], direction_point);
 
                 if (v < 0)
                 {
@@ -292,7 +433,7 @@ class FacetOrtho final
                 if (v > 0)
                 {
                         // direction point is visible, change ortho direction
-                        impl::negate(&ortho_);
+                        negate();
                         return;
                 }
 
@@ -302,7 +443,7 @@ class FacetOrtho final
                 {
                         if (impl::are_opposite(ortho_, direction_facet->ortho_))
                         {
-                                impl::negate(&ortho_);
+                                negate();
                         }
                         return;
                 }
@@ -333,7 +474,23 @@ public:
                 const int from_index,
                 const int to_index) const
         {
-                return facet_ortho_implementation::dot_product_sign(ortho_, points, from_index, to_index);
+                namespace impl = facet_ortho_implementation;
+
+                if constexpr (FILTER)
+                {
+                        const int sign =
+                                impl::dot_product_sign_filter<N, ComputeType>(ortho_fp_, points, from_index, to_index);
+                        if (sign != 0)
+                        {
+                                return sign;
+                        }
+                        const auto d = impl::dot_product_sign(ortho_, points, from_index, to_index);
+                        return static_cast<int>(d > 0) - static_cast<int>(d < 0);
+                }
+                else
+                {
+                        return impl::dot_product_sign(ortho_, points, from_index, to_index);
+                }
         }
 
         template <typename T>
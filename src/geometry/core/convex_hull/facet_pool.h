@@ -0,0 +1,236 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <src/com/error.h>
+#include <src/com/print.h>
+
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns::geometry::core::convex_hull
+{
+// Fixed size objects in blocks with free lists.
+// Each thread allocates from its own pool specified by a scope.
+// Deallocation is made only by the thread that created the pool
+// when no other thread allocates. The deallocated objects are
+// distributed over the pools for reuse by all threads.
+// The memory is released when the pool is destroyed.
+class FacetPool final
+{
+        static constexpr std::size_t BLOCK_SIZE = 1 << 20;
+        static constexpr std::size_t ALIGN = alignof(std::max_align_t);
+
+        class Pool final
+        {
+                std::vector<std::unique_ptr<std::byte[]>> blocks_;
+                std::size_t index_ = BLOCK_SIZE;
+                std::size_t size_ = 0;
+                std::vector<void*> free_;
+                std::size_t allocation_count_ = 0;
+                std::size_t reuse_count_ = 0;
+
+        public:
+                [[nodiscard]] void* allocate(const std::size_t size)
+                {
+                        ASSERT(size_ == 0 || size_ == (size + ALIGN - 1) / ALIGN * ALIGN);
+
+                        ++allocation_count_;
+
+                        if (!free_.empty())
+                        {
+                                ++reuse_count_;
+                                void* const res = free_.back();
+                                free_.pop_back();
+                                return res;
+                        }
+
+                        size_ = (size + ALIGN - 1) / ALIGN * ALIGN;
+                        if (size_ > BLOCK_SIZE)
+                        {
+                                error("Object size " + to_string(size) + " is too large for facet pool");
+                        }
+
+                        if (index_ + size_ > BLOCK_SIZE)
+                        {
+                                blocks_.emplace_back(new std::byte[BLOCK_SIZE]);
+                                index_ = 0;
+                        }
+
+                        void* const res = blocks_.back().get() + index_;
+                        index_ += size_;
+                        return res;
+                }
+
+                void deallocate(void* const ptr)
+                {
+                        free_.push_back(ptr);
+                }
+
+                [[nodiscard]] std::size_t allocation_count() const
+                {
+                        return allocation_count_;
+                }
+
+                [[nodiscard]] std::size_t reuse_count() const
+                {
+                        return reuse_count_;
+                }
+
+                [[nodiscard]] std::size_t block_count() const
+                {
+                        return blocks_.size();
+                }
+        };
+
+        inline static thread_local FacetPool* thread_facet_pool_ = nullptr;
+        inline static thread_local Pool* thread_pool_ = nullptr;
+
+        const std::thread::id thread_id_ = std::this_thread::get_id();
+
+        std::vector<Pool> pools_;
+        std::size_t deallocation_index_ = 0;
+
+        void deallocate_to_pools(void* const ptr)
+        {
+                ASSERT(std::this_thread::get_id() == thread_id_);
+
+                pools_[deallocation_index_].deallocate(ptr);
+                deallocation_index_ = (deallocation_index_ + 1) % pools_.size();
+        }
+
+public:
+        class Scope final
+        {
+                FacetPool* previous_facet_pool_;
+                Pool* previous_pool_;
+
+        public:
+                Scope(FacetPool* const facet_pool, const unsigned pool_index)
+                        : previous_facet_pool_(thread_facet_pool_),
+                          previous_pool_(thread_pool_)
+                {
+                        ASSERT(facet_pool && pool_index < facet_pool->pools_.size());
+
+                        thread_facet_pool_ = facet_pool;
+                        thread_pool_ = &facet_pool->pools_[pool_index];
+                }
+
+                ~Scope()
+                {
+                        thread_facet_pool_ = previous_facet_pool_;
+                        thread_pool_ = previous_pool_;
+                }
+
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+                Scope(Scope&&) = delete;
+                Scope& operator=(Scope&&) = delete;
+        };
+
+        explicit FacetPool(const unsigned pool_count)
+                : pools_(pool_count)
+        {
+                ASSERT(pool_count > 0);
+        }
+
+        FacetPool(const FacetPool&) = delete;
+        FacetPool& operator=(const FacetPool&) = delete;
+        FacetPool(FacetPool&&) = delete;
+        FacetPool& operator=(FacetPool&&) = delete;
+
+        [[nodiscard]] static void* allocate(const std::size_t size)
+        {
+                if (!thread_pool_)
+                {
+                        error("No facet pool for allocation");
+                }
+                return thread_pool_->allocate(size);
+        }
+
+        static void deallocate(void* const ptr)
+        {
+                if (!thread_facet_pool_)
+                {
+                        // the memory is released with the pool
+                        return;
+                }
+                thread_facet_pool_->deallocate_to_pools(ptr);
+        }
+
+        [[nodiscard]] std::string description() const
+        {
+                std::size_t allocation_count = 0;
+                std::size_t reuse_count = 0;
+                std::size_t block_count = 0;
+                for (const Pool& pool : pools_)
+                {
+                        allocation_count += pool.allocation_count();
+                        reuse_count += pool.reuse_count();
+                        block_count += pool.block_count();
+                }
+
+                std::ostringstream oss;
+                oss << "Facet pool" << '\n';
+                oss << "  Allocations: " << to_string_digit_groups(allocation_count) << '\n';
+                oss << "  Reused: " << to_string_digit_groups(reuse_count) << '\n';
+                oss << "  Blocks: " << to_string_digit_groups(block_count) << '\n';
+                oss << "  Bytes: " << to_string_digit_groups(block_count * BLOCK_SIZE);
+                return oss.str();
+        }
+};
+
+// Not final, std::list derives from the allocator
+template <typename T>
+class FacetAllocator
+{
+public:
+        using value_type = T;
+
+        FacetAllocator() = default;
+
+        template <typename U>
+        FacetAllocator(const FacetAllocator<U>&) noexcept
+        {
+        }
+
+        [[nodiscard]] T* allocate(const std::size_t n)
+        {
+                if (n != 1)
+                {
+                        error("Facet allocator supports only single objects");
+                }
+                return static_cast<T*>(FacetPool::allocate(sizeof(T)));
+        }
+
+        void deallocate(T* const ptr, const std::size_t)
+        {
+                FacetPool::deallocate(ptr);
+        }
+
+        template <typename U>
+        [[nodiscard]] bool operator==(const FacetAllocator<U>&) const noexcept
+        {
+                return true;
+        }
+};
+}
@@ -0,0 +1,207 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Nina Amenta, Sunghee Choi, Günter Rote.
+Incremental constructions con BRIO.
+Proceedings of the Nineteenth Annual Symposium on Computational Geometry,
+2003, 211-219.
+
+John Skilling.
+Programming the Hilbert curve.
+AIP Conference Proceedings 707, 2004, 381-387.
+*/
+
+/*
+Biased randomized insertion order.
+The points are randomly distributed over rounds of
+increasing sizes, each round is twice the size of the
+previous round. The points of each round are sorted
+along the Hilbert curve.
+*/
+
+#pragma once
+
+#include <src/com/error.h>
+#include <src/com/shuffle.h>
+#include <src/numerical/vector.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace ns::geometry::core::convex_hull
+{
+enum class InsertionOrder
+{
+        RANDOM,
+        BIASED_RANDOMIZED
+};
+
+namespace insertion_order_implementation
+{
+inline constexpr std::size_t MIN_ROUND_SIZE = 1'000;
+
+using HilbertIndex = unsigned __int128;
+
+template <std::size_t N>
+inline constexpr unsigned HILBERT_MAX_BITS = std::min<unsigned>(sizeof(HilbertIndex) * 8 / N, 32);
+
+struct HilbertKey final
+{
+        HilbertIndex index;
+        std::size_t point;
+};
+}
+
+// The coordinates are the axes in the Skilling's notation
+template <std::size_t N>
+[[nodiscard]] insertion_order_implementation::HilbertIndex hilbert_index(
+        std::array<unsigned, N> coordinates,
+        const unsigned bits)
+{
+        static_assert(N >= 2);
+
+        ASSERT(bits > 0 && bits <= insertion_order_implementation::HILBERT_MAX_BITS<N>);
+
+        const unsigned m = 1u << (bits - 1);
+
+        // Inverse undo
+        for (unsigned q = m; q > 1; q >>= 1)
+        {
+                const unsigned p = q - 1;
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                        if ((coordinates[i] & q) != 0)
+                        {
+                                coordinates[0] ^= p;
+                        }
+                        else
+                        {
+                                const unsigned t = (coordinates[0] ^ coordinates[i]) & p;
+                                coordinates[0] ^= t;
+                                coordinates[i] ^= t;
+                        }
+                }
+        }
+
+        // Gray encode
+        for (std::size_t i = 1; i < N; ++i)
+        {
+                coordinates[i] ^= coordinates[i - 1];
+        }
+        unsigned t = 0;
+        for (unsigned q = m; q > 1; q >>= 1)
+        {
+                if ((coordinates[N - 1] & q) != 0)
+                {
+                        t ^= q - 1;
+                }
+        }
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                coordinates[i] ^= t;
+        }
+
+        // The transposed index to the index
+        insertion_order_implementation::HilbertIndex res = 0;
+        for (unsigned b = bits; b > 0; --b)
+        {
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                        res = (res << 1) | ((coordinates[i] >> (b - 1)) & 1);
+                }
+        }
+        return res;
+}
+
+namespace insertion_order_implementation
+{
+template <typename T>
+void sort_round(
+        const std::vector<HilbertKey>& keys,
+        const std::size_t begin,
+        std::vector<T>* const data,
+        std::vector<T>* const round_data)
+{
+        round_data->clear();
+        for (const HilbertKey& key : keys)
+        {
+                round_data->push_back((*data)[key.point]);
+        }
+        std::ranges::copy(*round_data, data->begin() + begin);
+}
+}
+
+// The coordinates are non-negative and less than 2^BITS
+template <unsigned BITS, typename RandomEngine, std::size_t N, typename T>
+void biased_randomized_insertion_order(
+        RandomEngine&& engine,
+        std::vector<numerical::Vector<N, T>>* const points,
+        std::vector<int>* const map)
+{
+        namespace impl = insertion_order_implementation;
+
+        static_assert(std::is_integral_v<T>);
+        static_assert(BITS > 0 && BITS <= 32);
+
+        ASSERT(points->size() == map->size());
+
+        shuffle(engine, points, map);
+
+        constexpr unsigned INDEX_BITS = std::min(BITS, impl::HILBERT_MAX_BITS<N>);
+        constexpr unsigned SHIFT = BITS - INDEX_BITS;
+
+        std::vector<impl::HilbertKey> keys;
+        std::vector<numerical::Vector<N, T>> round_points;
+        std::vector<int> round_map;
+
+        // The last round contains half of the points,
+        // the previous round contains half of the remaining points
+        std::size_t end = points->size();
+        while (end > impl::MIN_ROUND_SIZE)
+        {
+                const std::size_t begin = end / 2;
+
+                keys.clear();
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                        std::array<unsigned, N> coordinates;
+                        for (std::size_t n = 0; n < N; ++n)
+                        {
+                                ASSERT((*points)[i][n] >= 0);
+                                coordinates[n] = static_cast<unsigned>((*points)[i][n]) >> SHIFT;
+                        }
+                        keys.push_back({.index = hilbert_index(coordinates, INDEX_BITS), .point = i});
+                }
+
+                std::ranges::sort(
+                        keys,
+                        [](const impl::HilbertKey& a, const impl::HilbertKey& b)
+                        {
+                                return a.index < b.index || (a.index == b.index && a.point < b.point);
+                        });
+
+                impl::sort_round(keys, begin, points, &round_points);
+                impl::sort_round(keys, begin, map, &round_map);
+
+                end = begin;
+        }
+}
+}
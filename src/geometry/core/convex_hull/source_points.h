@@ -17,8 +17,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "insertion_order.h"
 #include "integer_types.h"
 
+#include <src/com/enum.h>
 #include <src/com/error.h>
 #include <src/com/print.h>
 #include <src/com/random/pcg.h>
@@ -109,7 +111,9 @@ class Points final
         std::vector<int> map_;
 
 public:
-        explicit Points(const std::vector<numerical::Vector<N, float>>& points)
+        explicit Points(
+                const std::vector<numerical::Vector<N, float>>& points,
+                const InsertionOrder insertion_order = InsertionOrder::BIASED_RANDOMIZED)
         {
                 points_.reserve(points.size());
                 map_.reserve(points.size());
@@ -128,7 +132,16 @@ public:
                         }
                 }
 
-                shuffle(PCG(points_.size()), &points_, &map_);
+                switch (insertion_order)
+                {
+                case InsertionOrder::RANDOM:
+                        shuffle(PCG(points_.size()), &points_, &map_);
+                        return;
+                case InsertionOrder::BIASED_RANDOMIZED:
+                        biased_randomized_insertion_order<BITS>(PCG(points_.size()), &points_, &map_);
+                        return;
+                }
+                error("Unknown insertion order " + to_string(enum_to_int(insertion_order)));
         }
 
         [[nodiscard]] const std::vector<numerical::Vector<N, T>>& points() const
@@ -0,0 +1,166 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <src/com/error.h>
+#include <src/com/print.h>
+#include <src/com/random/pcg.h>
+#include <src/geometry/core/convex_hull/insertion_order.h>
+#include <src/numerical/vector.h>
+#include <src/test/test.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace ns::geometry::core::convex_hull
+{
+namespace
+{
+template <std::size_t N>
+std::array<unsigned, N> cell_coordinates(std::size_t cell, const unsigned bits)
+{
+        std::array<unsigned, N> res;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                res[i] = cell & ((1u << bits) - 1);
+                cell >>= bits;
+        }
+        return res;
+}
+
+template <std::size_t N>
+unsigned distance(const std::array<unsigned, N>& a, const std::array<unsigned, N>& b)
+{
+        unsigned res = 0;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                res += (a[i] > b[i]) ? (a[i] - b[i]) : (b[i] - a[i]);
+        }
+        return res;
+}
+
+// Each index is used once and the cells with
+// consecutive indices are adjacent
+template <std::size_t N>
+void test_hilbert_curve(const unsigned bits)
+{
+        const std::size_t count = std::size_t{1} << (N * bits);
+
+        std::vector<std::array<unsigned, N>> cells(count);
+        for (std::size_t cell = 0; cell < count; ++cell)
+        {
+                const std::array<unsigned, N> coordinates = cell_coordinates<N>(cell, bits);
+                const auto index = hilbert_index(coordinates, bits);
+                if (!(index < count))
+                {
+                        error("Hilbert index " + to_string(static_cast<unsigned long long>(index))
+                              + " is out of range for " + to_string(count) + " cells");
+                }
+                cells[static_cast<std::size_t>(index)] = coordinates;
+        }
+
+        const std::unordered_set<std::size_t> used = [&]
+        {
+                std::unordered_set<std::size_t> res;
+                for (const std::array<unsigned, N>& c : cells)
+                {
+                        std::size_t cell = 0;
+                        for (std::size_t i = N; i > 0; --i)
+                        {
+                                cell = (cell << bits) | c[i - 1];
+                        }
+                        res.insert(cell);
+                }
+                return res;
+        }();
+        if (used.size() != count)
+        {
+                error("Hilbert indices are not unique in " + to_string(N) + "-space");
+        }
+
+        for (std::size_t i = 1; i < count; ++i)
+        {
+                if (distance(cells[i - 1], cells[i]) != 1)
+                {
+                        error("Hilbert curve cells " + to_string(i - 1) + " and " + to_string(i)
+                              + " are not adjacent in " + to_string(N) + "-space");
+                }
+        }
+}
+
+template <std::size_t N>
+void test_insertion_order()
+{
+        constexpr unsigned BITS = 20;
+        constexpr int COUNT = 10'000;
+
+        PCG engine;
+        std::uniform_int_distribution<int> uid(0, (1 << BITS) - 1);
+
+        std::vector<numerical::Vector<N, int>> points(COUNT);
+        std::vector<int> map(COUNT);
+        for (int i = 0; i < COUNT; ++i)
+        {
+                for (std::size_t n = 0; n < N; ++n)
+                {
+                        points[i][n] = uid(engine);
+                }
+                map[i] = i;
+        }
+
+        const std::vector<numerical::Vector<N, int>> source = points;
+
+        biased_randomized_insertion_order<BITS>(engine, &points, &map);
+
+        std::vector<int> sorted_map = map;
+        std::ranges::sort(sorted_map);
+        for (int i = 0; i < COUNT; ++i)
+        {
+                if (sorted_map[i] != i)
+                {
+                        error("Insertion order is not a permutation");
+                }
+        }
+
+        for (int i = 0; i < COUNT; ++i)
+        {
+                if (!(points[i] == source[map[i]]))
+                {
+                        error("Insertion order points and indices do not match");
+                }
+        }
+}
+
+void test()
+{
+        test_hilbert_curve<2>(5);
+        test_hilbert_curve<3>(4);
+        test_hilbert_curve<4>(3);
+        test_hilbert_curve<5>(2);
+
+        test_insertion_order<2>();
+        test_insertion_order<3>();
+        test_insertion_order<5>();
+}
+
+TEST_SMALL("Hilbert Curve Insertion Order", test)
+}
+}
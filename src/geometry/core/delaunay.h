@@ -18,61 +18,23 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include "convex_hull.h"
-#include "ridge.h"
 #include "voronoi.h"
 
+#include <src/com/arrays.h>
 #include <src/com/error.h>
+#include <src/com/sort.h>
+#include <src/com/thread.h>
 #include <src/numerical/vector.h>
 
 #include <array>
 #include <cstddef>
-#include <unordered_map>
 #include <vector>
 
 namespace ns::geometry::core
 {
 namespace delaunay_implementation
 {
-template <std::size_t N>
-class SimplexIndex final
-{
-        std::unordered_map<const DelaunaySimplex<N>*, int> map_;
-
-public:
-        explicit SimplexIndex(const std::vector<DelaunaySimplex<N>>* const simplices)
-        {
-                ASSERT(simplices);
-
-                map_.reserve(simplices->size());
-
-                int i = 0;
-                for (const DelaunaySimplex<N>& simplex : *simplices)
-                {
-                        map_.emplace(&simplex, i++);
-                }
-        }
-
-        [[nodiscard]] int find(const DelaunaySimplex<N>* const simplex) const
-        {
-                const auto iter = map_.find(simplex);
-                ASSERT(iter != map_.cend());
-                return iter->second;
-        }
-};
-
-template <std::size_t N>
-std::unordered_map<Ridge<N + 1>, RidgeFacets2<DelaunaySimplex<N>>> create_ridge_to_facets_map(
-        const std::vector<DelaunaySimplex<N>>* const simplices)
-{
-        ASSERT(simplices);
-
-        std::unordered_map<Ridge<N + 1>, RidgeFacets2<DelaunaySimplex<N>>> res(simplices->size());
-        for (const DelaunaySimplex<N>& simplex : *simplices)
-        {
-                add_to_ridges(&simplex, &res);
-        }
-        return res;
-}
+inline constexpr std::size_t CHUNK_SIZE = 1 << 10;
 }
 
 template <std::size_t N>
@@ -87,6 +49,8 @@ class DelaunayFacet final
         std::array<int, 2> delaunay_;
 
 public:
+        DelaunayFacet() = default;
+
         DelaunayFacet(
                 const std::array<int, N>& vertices,
                 const numerical::Vector<N, double>& ortho,
@@ -127,6 +91,8 @@ class DelaunayObject final
         numerical::Vector<N, double> voronoi_vertex_;
 
 public:
+        DelaunayObject() = default;
+
         DelaunayObject(const std::array<int, N + 1>& vertices, const numerical::Vector<N, double>& voronoi_vertex)
                 : vertices_(vertices),
                   voronoi_vertex_(voronoi_vertex)
@@ -146,52 +112,82 @@ public:
 
 template <std::size_t N>
 [[nodiscard]] std::vector<DelaunayObject<N>> create_delaunay_objects(
-        const std::vector<numerical::Vector<N, double>>& points,
+        const std::vector<DelaunayPoint<N>>& points,
         const std::vector<DelaunaySimplex<N>>& simplices)
 {
-        std::vector<DelaunayObject<N>> res;
-        res.reserve(simplices.size());
-        for (const DelaunaySimplex<N>& simplex : simplices)
-        {
-                res.emplace_back(
-                        simplex.vertices(), compute_voronoi_vertex_for_delaunay_object(points, simplex.vertices()));
-        }
+        namespace impl = delaunay_implementation;
+
+        std::vector<DelaunayObject<N>> res(simplices.size());
+
+        run_in_chunks(
+                simplices.size(), impl::CHUNK_SIZE,
+                [&](const std::size_t begin, const std::size_t end)
+                {
+                        for (std::size_t i = begin; i < end; ++i)
+                        {
+                                const std::array<int, N + 1>& vertices = simplices[i].vertices();
+                                res[i] = DelaunayObject<N>(
+                                        vertices, compute_voronoi_vertex_for_delaunay_object<double>(points, vertices));
+                        }
+                });
+
         return res;
 }
 
 template <std::size_t N>
-[[nodiscard]] std::vector<DelaunayFacet<N>> create_delaunay_facets(const std::vector<DelaunaySimplex<N>>& simplices)
+[[nodiscard]] std::vector<DelaunayFacet<N>> create_delaunay_facets(
+        const std::vector<DelaunayPoint<N>>& points,
+        const std::vector<DelaunaySimplex<N>>& simplices)
 {
         namespace impl = delaunay_implementation;
 
-        const impl::SimplexIndex<N> simplex_index(&simplices);
-
-        const std::unordered_map<Ridge<N + 1>, RidgeFacets2<DelaunaySimplex<N>>> ridges =
-                impl::create_ridge_to_facets_map(&simplices);
-
-        std::vector<DelaunayFacet<N>> res;
-        res.reserve(ridges.size());
-
-        for (const auto& [ridge, ridge_facets] : ridges)
+        // a facet between two simplices is created
+        // only for the simplex with the lower index
+        const auto facet_exists = [&](const int simplex, const unsigned vertex_index)
         {
-                ASSERT(ridge_facets.f0().facet());
-
-                const DelaunaySimplex<N>* const simplex_0 = ridge_facets.f0().facet();
-                const numerical::Vector<N, double> ortho = simplex_0->ortho(ridge_facets.f0().vertex_index());
-                const int delaunay_0 = simplex_index.find(simplex_0);
-
-                if (!ridge_facets.f1().facet())
+                const int neighbor = simplices[simplex].neighbor(vertex_index);
+                ASSERT(neighbor != simplex);
+                return neighbor < 0 || neighbor > simplex;
+        };
+
+        // the facets are in the order of the simplices
+        // independent of the thread count
+        std::vector<std::size_t> offsets(simplices.size() + 1);
+        offsets[0] = 0;
+        for (std::size_t s = 0; s < simplices.size(); ++s)
+        {
+                std::size_t count = 0;
+                for (std::size_t r = 0; r < N + 1; ++r)
                 {
-                        res.emplace_back(ridge.vertices(), ortho, delaunay_0);
-                        continue;
+                        count += facet_exists(s, r) ? 1 : 0;
                 }
+                offsets[s + 1] = offsets[s] + count;
+        }
 
-                const DelaunaySimplex<N>* const simplex_1 = ridge_facets.f1().facet();
-                ASSERT(ortho == -simplex_1->ortho(ridge_facets.f1().vertex_index()));
+        std::vector<DelaunayFacet<N>> res(offsets.back());
 
-                const int delaunay_1 = simplex_index.find(simplex_1);
-                res.emplace_back(ridge.vertices(), ortho, delaunay_0, delaunay_1);
-        }
+        run_in_chunks(
+                simplices.size(), impl::CHUNK_SIZE,
+                [&](const std::size_t begin, const std::size_t end)
+                {
+                        for (std::size_t s = begin; s < end; ++s)
+                        {
+                                const DelaunaySimplex<N>& simplex = simplices[s];
+                                std::size_t index = offsets[s];
+                                for (std::size_t r = 0; r < N + 1; ++r)
+                                {
+                                        if (!facet_exists(s, r))
+                                        {
+                                                continue;
+                                        }
+                                        res[index++] = DelaunayFacet<N>(
+                                                sort(del_elem(simplex.vertices(), r)),
+                                                compute_delaunay_facet_ortho(points, simplex, r), s,
+                                                simplex.neighbor(r));
+                                }
+                                ASSERT(index == offsets[s + 1]);
+                        }
+                });
 
         return res;
 }
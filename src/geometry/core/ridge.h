@@ -238,8 +238,8 @@ void remove_from_ridges(const Facet* const facet, Map<Ridge<N>, RidgeFacets<Face
         }
 }
 
-template <std::size_t N, typename Facet, template <typename...> typename Set>
-void add_to_ridges(const Facet& facet, const int exclude_point, Set<Ridge<N>>* const ridges)
+template <std::size_t N, typename Facet>
+void add_to_ridges(const Facet& facet, const int exclude_point, std::vector<Ridge<N>>* const ridges)
 {
         const std::array<int, N>& vertices = facet.vertices();
 
@@ -247,7 +247,7 @@ void add_to_ridges(const Facet& facet, const int exclude_point, Set<Ridge<N>>* c
         {
                 if (vertices[i] != exclude_point)
                 {
-                        ridges->emplace(sort(del_elem(vertices, i)));
+                        ridges->emplace_back(sort(del_elem(vertices, i)));
                 }
         }
 }
@@ -291,23 +291,41 @@ void test_convex_hull(progress::Ratio* const progress)
         LOG(name + " passed");
 }
 
+template <std::size_t N>
+int performance_point_count()
+{
+        static_assert(N >= 2);
+        switch (N)
+        {
+        case 2:
+        case 3:
+                return 10'000'000;
+        case 4:
+        case 5:
+                return 1'000'000;
+        default:
+                return 100'000;
+        }
+}
+
 template <std::size_t N>
 void test_performance(progress::Ratio* const progress)
 {
         // N = 4, in parallel, 100000 points, inside sphere, time: 1.7 s, 0.4 s.
 
         constexpr bool ON_SPHERE = false;
-        constexpr int SIZE = 100'000;
-        constexpr bool WRITE_LOG = false;
-        constexpr bool WRITE_INFO = false;
+        constexpr bool WRITE_LOG = true;
+        constexpr bool WRITE_INFO = true;
+
+        const int size = performance_point_count<N>();
 
         {
                 constexpr bool ZERO = false;
-                create_convex_hull(random_points<N>(ZERO, SIZE, ON_SPHERE), WRITE_LOG, WRITE_INFO, progress);
+                create_convex_hull(random_points<N>(ZERO, size, ON_SPHERE), WRITE_LOG, WRITE_INFO, progress);
         }
         {
                 constexpr bool ZERO = true;
-                create_convex_hull(random_points<N>(ZERO, SIZE, ON_SPHERE), WRITE_LOG, WRITE_INFO, progress);
+                create_convex_hull(random_points<N>(ZERO, size, ON_SPHERE), WRITE_LOG, WRITE_INFO, progress);
         }
 }
 
@@ -52,12 +52,12 @@ x ⋅ (2 * (v(n) - v(0))) = v(n) ⋅ v(n) - v(0) ⋅ v(0)
 
 namespace ns::geometry::core
 {
-template <std::size_t N, typename T>
+template <typename T, std::size_t N, typename PointType>
 [[nodiscard]] numerical::Vector<N, T> compute_voronoi_vertex_for_delaunay_object(
-        const std::vector<numerical::Vector<N, T>>& points,
+        const std::vector<numerical::Vector<N, PointType>>& points,
         const std::array<int, N + 1>& vertices)
 {
-        const numerical::Vector<N, T>& p0 = points[vertices[0]];
+        const numerical::Vector<N, T> p0 = to_vector<T>(points[vertices[0]]);
         const T dot0 = dot(p0, p0);
 
         numerical::Matrix<N, N, T> a;
@@ -65,7 +65,7 @@ template <std::size_t N, typename T>
 
         for (std::size_t row = 0; row < N; ++row)
         {
-                const numerical::Vector<N, T>& p = points[vertices[row + 1]];
+                const numerical::Vector<N, T> p = to_vector<T>(points[vertices[row + 1]]);
                 for (std::size_t col = 0; col < N; ++col)
                 {
                         a[row, col] = 2 * (p[col] - p0[col]);
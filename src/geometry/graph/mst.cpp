@@ -21,7 +21,7 @@ Algorithms. Fourth edition.
 Pearson Education, 2011.
 
 4.3 Minimum Spanning Trees
-Kruskal’s algorithm
+Borůvka’s algorithm
 */
 
 #include "mst.h"
@@ -31,7 +31,8 @@ Kruskal’s algorithm
 #include <src/com/error.h>
 #include <src/com/log.h>
 #include <src/com/print.h>
-#include <src/com/union_find.h>
+#include <src/com/thread.h>
+#include <src/com/union_find_concurrent.h>
 #include <src/geometry/core/ridge.h>
 #include <src/numerical/vector.h>
 #include <src/progress/progress.h>
@@ -39,13 +40,19 @@ Kruskal’s algorithm
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstddef>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 namespace ns::geometry::graph
 {
 namespace
 {
+constexpr std::size_t OBJECT_CHUNK_SIZE = 1 << 12;
+constexpr std::size_t VERTEX_CHUNK_SIZE = 1 << 14;
+
 using Edge2 = core::Ridge<3>;
 
 class WeightedEdge final
@@ -70,6 +77,17 @@ public:
         {
                 return edge_.vertices()[index];
         }
+
+        // edges with equal weights are ordered by vertices,
+        // so the minimum spanning tree is unique
+        [[nodiscard]] bool operator<(const WeightedEdge& edge) const
+        {
+                if (weight_ != edge.weight_)
+                {
+                        return weight_ < edge.weight_;
+                }
+                return edge_ < edge.edge_;
+        }
 };
 
 template <std::size_t N>
@@ -92,24 +110,25 @@ std::array<int, 2> sorted_vertices(const std::array<int, N>& object, const std::
 }
 
 template <std::size_t N>
-std::vector<Edge2> all_edges_from_delaunay_objects(const std::vector<std::array<int, N>>& delaunay_objects)
+void add_edges_from_delaunay_objects(
+        const std::vector<std::array<int, N>>& delaunay_objects,
+        const std::size_t begin,
+        const std::size_t end,
+        std::vector<Edge2>* const edges)
 {
         static_assert(N >= 3);
 
-        std::vector<Edge2> edges;
-
-        for (const std::array<int, N>& object : delaunay_objects)
+        for (std::size_t i = begin; i < end; ++i)
         {
+                const std::array<int, N>& object = delaunay_objects[i];
                 for (std::size_t p1 = 0; p1 < object.size() - 1; ++p1)
                 {
                         for (std::size_t p2 = p1 + 1; p2 < object.size(); ++p2)
                         {
-                                edges.emplace_back(sorted_vertices(object, p1, p2));
+                                edges->emplace_back(sorted_vertices(object, p1, p2));
                         }
                 }
         }
-
-        return edges;
 }
 
 template <std::size_t N>
@@ -126,29 +145,131 @@ std::vector<WeightedEdge> weight_edges(
         return res;
 }
 
-std::vector<std::array<int, 2>> kruskal(
+// edges are unique within a chunk,
+// duplicates between chunks are allowed.
+// vector, sort and unique are faster than unordered_set
+template <std::size_t N>
+std::vector<std::vector<WeightedEdge>> weighted_edges_from_delaunay_objects(
+        const std::vector<numerical::Vector<N, float>>& points,
+        const std::vector<std::array<int, N + 1>>& delaunay_objects)
+{
+        std::vector<std::vector<WeightedEdge>> res(
+                (delaunay_objects.size() + OBJECT_CHUNK_SIZE - 1) / OBJECT_CHUNK_SIZE);
+
+        run_in_chunks(
+                delaunay_objects.size(), OBJECT_CHUNK_SIZE,
+                [&](const std::size_t begin, const std::size_t end)
+                {
+                        std::vector<Edge2> edges;
+                        add_edges_from_delaunay_objects(delaunay_objects, begin, end, &edges);
+                        sort_and_unique(&edges);
+                        res[begin / OBJECT_CHUNK_SIZE] = weight_edges(points, edges);
+                });
+
+        return res;
+}
+
+void set_min_edge(std::atomic<const WeightedEdge*>* const min_edge, const WeightedEdge* const edge)
+{
+        const WeightedEdge* current = min_edge->load(std::memory_order_acquire);
+        while ((!current || *edge < *current)
+               && !min_edge->compare_exchange_weak(
+                       current, edge, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+        }
+}
+
+// edges within components are removed,
+// the minimum edges of components are found
+void find_min_edges(
+        UnionFindConcurrent<int>* const union_find,
+        std::vector<std::vector<WeightedEdge>>* const edges,
+        std::vector<std::atomic<const WeightedEdge*>>* const min_edges)
+{
+        const std::size_t count = edges->size();
+
+        run_in_threads(
+                [&](std::atomic_size_t& task)
+                {
+                        std::size_t chunk = 0;
+                        while ((chunk = task++) < count)
+                        {
+                                std::vector<WeightedEdge>& chunk_edges = (*edges)[chunk];
+                                std::size_t size = 0;
+                                for (std::size_t i = 0; i < chunk_edges.size(); ++i)
+                                {
+                                        const int v = union_find->find(chunk_edges[i].vertex(0));
+                                        const int w = union_find->find(chunk_edges[i].vertex(1));
+                                        if (v == w)
+                                        {
+                                                continue;
+                                        }
+                                        chunk_edges[size] = chunk_edges[i];
+                                        set_min_edge(&(*min_edges)[v], &chunk_edges[size]);
+                                        set_min_edge(&(*min_edges)[w], &chunk_edges[size]);
+                                        ++size;
+                                }
+                                chunk_edges.erase(chunk_edges.begin() + size, chunk_edges.end());
+                        }
+                },
+                count);
+}
+
+// the minimum edges of components are in the minimum spanning tree,
+// an edge is added once if it is the minimum edge of both its components
+std::size_t connect_components(
+        UnionFindConcurrent<int>* const union_find,
+        std::vector<std::atomic<const WeightedEdge*>>* const min_edges,
+        std::vector<WeightedEdge>* const mst)
+{
+        std::size_t res = 0;
+        std::mutex mutex;
+
+        run_in_chunks(
+                min_edges->size(), VERTEX_CHUNK_SIZE,
+                [&](const std::size_t begin, const std::size_t end)
+                {
+                        std::vector<WeightedEdge> edges;
+                        for (std::size_t i = begin; i < end; ++i)
+                        {
+                                const WeightedEdge* const edge =
+                                        (*min_edges)[i].exchange(nullptr, std::memory_order_acquire);
+                                if (edge && union_find->add_connection(edge->vertex(0), edge->vertex(1)))
+                                {
+                                        edges.push_back(*edge);
+                                }
+                        }
+                        const std::lock_guard lg(mutex);
+                        mst->insert(mst->end(), edges.cbegin(), edges.cend());
+                        res += edges.size();
+                });
+
+        return res;
+}
+
+std::vector<std::array<int, 2>> boruvka(
         const int point_count,
         const int vertex_count,
-        const std::vector<WeightedEdge>& sorted_edges)
+        std::vector<std::vector<WeightedEdge>>&& edges)
 {
         ASSERT(point_count > 1 && vertex_count > 1);
 
         const unsigned mst_size = vertex_count - 1;
 
-        std::vector<std::array<int, 2>> mst;
+        std::vector<WeightedEdge> mst;
 
         mst.reserve(mst_size);
 
-        UnionFind<int> union_find(point_count);
+        UnionFindConcurrent<int> union_find(point_count);
+        std::vector<std::atomic<const WeightedEdge*>> min_edges(point_count);
 
-        for (std::size_t i = 0; i < sorted_edges.size() && mst.size() < mst_size; ++i)
+        while (mst.size() < mst_size)
         {
-                const int v = sorted_edges[i].vertex(0);
-                const int w = sorted_edges[i].vertex(1);
+                find_min_edges(&union_find, &edges, &min_edges);
 
-                if (union_find.add_connection(v, w))
+                if (connect_components(&union_find, &min_edges, &mst) == 0)
                 {
-                        mst.push_back({v, w});
+                        break;
                 }
         }
 
@@ -157,27 +278,33 @@ std::vector<std::array<int, 2>> kruskal(
                 error("Error create minimum spanning tree. The graph is not connected.");
         }
 
-        return mst;
+        std::sort(mst.begin(), mst.end());
+
+        std::vector<std::array<int, 2>> res;
+        res.reserve(mst.size());
+        for (const WeightedEdge& edge : mst)
+        {
+                res.push_back({edge.vertex(0), edge.vertex(1)});
+        }
+        return res;
 }
 
 template <std::size_t N>
-unsigned unique_vertex_count(const std::vector<std::array<int, N>>& delaunay_objects)
+unsigned unique_vertex_count(const std::size_t point_count, const std::vector<std::array<int, N>>& delaunay_objects)
 {
         static_assert(N >= 3);
 
-        std::vector<int> indices;
+        std::vector<bool> vertices(point_count, false);
 
         for (const std::array<int, N>& obj : delaunay_objects)
         {
                 for (const int index : obj)
                 {
-                        indices.push_back(index);
+                        vertices[index] = true;
                 }
         }
 
-        sort_and_unique(&indices);
-
-        return indices.size();
+        return std::count(vertices.cbegin(), vertices.cend(), true);
 }
 }
 
@@ -187,39 +314,18 @@ std::vector<std::array<int, 2>> minimum_spanning_tree(
         const std::vector<std::array<int, N + 1>>& delaunay_objects,
         progress::Ratio* const progress)
 {
-        // vector, sort and unique are faster than unordered_set
-
         LOG("Minimum spanning tree...");
         progress->set_text("Minimum spanning tree");
         const Clock::time_point start_time = Clock::now();
 
-        progress->set(0, 5);
-
-        std::vector<Edge2> edges = all_edges_from_delaunay_objects(delaunay_objects);
-
-        progress->set(1, 5);
+        progress->set(0, 2);
 
-        sort_and_unique(&edges);
-
-        progress->set(2, 5);
-
-        std::vector<WeightedEdge> weighted_edges = weight_edges(points, edges);
-
-        edges.clear();
-
-        progress->set(3, 5);
-
-        std::sort(
-                weighted_edges.begin(), weighted_edges.end(),
-                [](const WeightedEdge& a, const WeightedEdge& b) -> bool
-                {
-                        return a.weight() < b.weight();
-                });
+        std::vector<std::vector<WeightedEdge>> edges = weighted_edges_from_delaunay_objects(points, delaunay_objects);
 
-        progress->set(4, 5);
+        progress->set(1, 2);
 
         std::vector<std::array<int, 2>> mst =
-                kruskal(points.size(), unique_vertex_count(delaunay_objects), weighted_edges);
+                boruvka(points.size(), unique_vertex_count(points.size(), delaunay_objects), std::move(edges));
 
         LOG("Minimum spanning tree created, " + to_string_fixed(duration_from(start_time), 5) + " s");
 
@@ -31,6 +31,7 @@ Cambridge University Press, 2007.
 #include "prune_facets.h"
 #include "structure.h"
 
+#include <src/com/chrono.h>
 #include <src/com/error.h>
 #include <src/com/log.h>
 #include <src/com/names.h>
@@ -46,6 +47,8 @@ Cambridge University Press, 2007.
 #include <cmath>
 #include <cstddef>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -58,6 +61,17 @@ constexpr double RHO_MAX = 1;
 constexpr double ALPHA_MIN = 0;
 constexpr double ALPHA_MAX = 1;
 
+void log_time(const std::string_view text, const Clock::time_point start_time)
+{
+        LOG(std::string(text) + ", " + to_string_fixed(duration_from(start_time), 5) + " s");
+}
+
+template <typename T>
+std::size_t vector_memory_size(const std::vector<T>& data)
+{
+        return data.capacity() * sizeof(T);
+}
+
 bool all_false(const std::vector<bool>& data)
 {
         return std::ranges::find(data, true) == data.cend();
@@ -106,7 +120,7 @@ std::vector<std::array<int, N>> create_facets(
 template <std::size_t N>
 struct DelaunayData final
 {
-        std::vector<numerical::Vector<N, double>> points;
+        std::vector<core::DelaunayPoint<N>> points;
         std::vector<core::DelaunayObject<N>> objects;
         std::vector<core::DelaunayFacet<N>> facets;
 };
@@ -118,18 +132,25 @@ DelaunayData<N> create_voronoi_delaunay(
 {
         constexpr bool WRITE_LOG = true;
 
+        Clock::time_point start_time = Clock::now();
+
         LOG("computing delaunay...");
         core::DelaunayData<N> delaunay = core::compute_delaunay(source_points, progress, WRITE_LOG);
+        log_time("delaunay computed", start_time);
 
         DelaunayData<N> res;
 
         res.points = std::move(delaunay.points);
 
+        start_time = Clock::now();
         LOG("creating delaunay objects...");
         res.objects = core::create_delaunay_objects(res.points, delaunay.simplices);
+        log_time("delaunay objects created", start_time);
 
+        start_time = Clock::now();
         LOG("creating delaunay facets...");
-        res.facets = core::create_delaunay_facets(delaunay.simplices);
+        res.facets = core::create_delaunay_facets(res.points, delaunay.simplices);
+        log_time("delaunay facets created", start_time);
 
         return res;
 }
@@ -155,7 +176,7 @@ class Impl final : public ManifoldConstructor<N>, public ManifoldConstructorCoco
         const bool cocone_only_;
 
         std::vector<numerical::Vector<N, float>> source_points_;
-        std::vector<numerical::Vector<N, double>> points_;
+        std::vector<core::DelaunayPoint<N>> points_;
         std::vector<core::DelaunayObject<N>> delaunay_objects_;
         std::vector<core::DelaunayFacet<N>> delaunay_facets_;
         std::vector<ManifoldVertex<N>> vertex_data_;
@@ -169,7 +190,9 @@ class Impl final : public ManifoldConstructor<N>, public ManifoldConstructorCoco
                 progress->set(1, 4);
                 LOG("prune facets...");
 
+                Clock::time_point start_time = Clock::now();
                 prune_facets_incident_to_sharp_ridges(points_, delaunay_facets_, interior_vertices, &cocone_facets);
+                log_time("facets pruned", start_time);
                 if (all_false(cocone_facets))
                 {
                         error("Cocone facets not found after prune. " + to_string(N - 1)
@@ -179,7 +202,9 @@ class Impl final : public ManifoldConstructor<N>, public ManifoldConstructorCoco
                 progress->set(2, 4);
                 LOG("extract manifold...");
 
+                start_time = Clock::now();
                 cocone_facets = extract_manifold(delaunay_objects_, delaunay_facets_, cocone_facets);
+                log_time("manifold extracted", start_time);
                 if (all_false(cocone_facets))
                 {
                         error("Cocone facets not found after manifold extraction. " + to_string(N - 1)
@@ -189,7 +214,11 @@ class Impl final : public ManifoldConstructor<N>, public ManifoldConstructorCoco
                 progress->set(3, 4);
                 LOG("create result...");
 
-                return create_facets(delaunay_facets_, cocone_facets);
+                start_time = Clock::now();
+                std::vector<std::array<int, N>> res = create_facets(delaunay_facets_, cocone_facets);
+                log_time("result created", start_time);
+
+                return res;
         }
 
         [[nodiscard]] std::vector<std::array<int, N>> cocone(progress::Ratio* const progress) const override
@@ -230,6 +259,8 @@ class Impl final : public ManifoldConstructor<N>, public ManifoldConstructorCoco
                 progress->set(0, 4);
                 LOG("vertex data...");
 
+                const Clock::time_point start_time = Clock::now();
+
                 const std::vector<bool> interior_vertices = find_interior_vertices(rho, std::cos(alpha), vertex_data_);
                 if (all_false(interior_vertices))
                 {
@@ -238,6 +269,7 @@ class Impl final : public ManifoldConstructor<N>, public ManifoldConstructorCoco
 
                 std::vector<bool> cocone_facets =
                         find_interior_facets(delaunay_facets_, facet_data_, interior_vertices);
+                log_time("interior facets found", start_time);
                 if (all_false(cocone_facets))
                 {
                         error("Cocone interior facets not found. " + to_string(N - 1)
@@ -258,6 +290,22 @@ class Impl final : public ManifoldConstructor<N>, public ManifoldConstructorCoco
                 return res;
         }
 
+        [[nodiscard]] std::size_t memory_size() const override
+        {
+                std::size_t res = sizeof(*this);
+                res += vector_memory_size(source_points_);
+                res += vector_memory_size(points_);
+                res += vector_memory_size(delaunay_objects_);
+                res += vector_memory_size(delaunay_facets_);
+                res += vector_memory_size(vertex_data_);
+                res += vector_memory_size(facet_data_);
+                for (const ManifoldVertex<N>& vertex : vertex_data_)
+                {
+                        res += vector_memory_size(vertex.cocone_neighbors);
+                }
+                return res;
+        }
+
         [[nodiscard]] std::vector<numerical::Vector<N, double>> normals() const override
         {
                 std::vector<numerical::Vector<N, double>> res;
@@ -297,10 +345,13 @@ public:
                 }
 
                 {
+                        const Clock::time_point start_time = Clock::now();
+                        LOG("finding manifold data...");
                         ManifoldData<N> data =
                                 find_manifold_data(!cocone_only_, points_, delaunay_objects_, delaunay_facets_);
                         vertex_data_ = std::move(data.vertices);
                         facet_data_ = std::move(data.facets);
+                        log_time("manifold data found", start_time);
                 }
 
                 ASSERT(source_points.size() == points_.size());
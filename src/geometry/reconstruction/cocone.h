@@ -60,6 +60,8 @@ public:
                 double rho,
                 double alpha,
                 progress::Ratio* progress) const = 0;
+
+        [[nodiscard]] virtual std::size_t memory_size() const = 0;
 };
 
 template <std::size_t N>
@@ -30,10 +30,12 @@ Cambridge University Press, 2007.
 #include <src/com/error.h>
 #include <src/com/log.h>
 #include <src/com/print.h>
+#include <src/com/thread.h>
 #include <src/geometry/core/delaunay.h>
 #include <src/settings/instantiation.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstddef>
 #include <vector>
@@ -42,6 +44,9 @@ namespace ns::geometry::reconstruction
 {
 namespace
 {
+constexpr std::size_t VERTEX_CHUNK_SIZE = 1 << 10;
+constexpr std::size_t FACET_CHUNK_SIZE = 1 << 12;
+
 // Definition 5.4 (i)
 template <std::size_t N>
 bool ratio_condition(const ManifoldVertex<N>& vertex, const double rho)
@@ -64,81 +69,112 @@ void initial_phase(
         const double rho,
         const double cosine_of_alpha,
         const std::vector<ManifoldVertex<N>>& vertices,
-        std::vector<bool>* const interior_vertices,
+        std::vector<unsigned char>* const interior_vertices,
         std::size_t* const interior_count)
 {
-        for (std::size_t v = 0; v < vertices.size(); ++v)
-        {
-                const ManifoldVertex<N>& vertex = vertices[v];
+        std::atomic_size_t count = 0;
 
-                if (!ratio_condition(vertex, rho))
+        run_in_chunks(
+                vertices.size(), VERTEX_CHUNK_SIZE,
+                [&](const std::size_t begin, const std::size_t end)
                 {
-                        continue;
-                }
-
-                const bool flat = std::ranges::all_of(
-                        vertex.cocone_neighbors,
-                        [&](const auto index)
+                        std::size_t chunk_interior_count = 0;
+                        for (std::size_t v = begin; v < end; ++v)
                         {
-                                return normal_condition(vertex, vertices[index], cosine_of_alpha);
-                        });
-
-                if (flat)
-                {
-                        (*interior_vertices)[v] = true;
-                        ++(*interior_count);
-                }
-        }
+                                const ManifoldVertex<N>& vertex = vertices[v];
+
+                                if (!ratio_condition(vertex, rho))
+                                {
+                                        continue;
+                                }
+
+                                const bool flat = std::ranges::all_of(
+                                        vertex.cocone_neighbors,
+                                        [&](const auto index)
+                                        {
+                                                return normal_condition(vertex, vertices[index], cosine_of_alpha);
+                                        });
+
+                                if (flat)
+                                {
+                                        (*interior_vertices)[v] = true;
+                                        ++chunk_interior_count;
+                                }
+                        }
+                        count += chunk_interior_count;
+                });
+
+        *interior_count += count;
 }
 
 template <std::size_t N>
-void expansion_phase_neighbors(
+bool interior_neighbor(
         const std::size_t vertex_index,
         const double cosine_of_alpha,
         const std::vector<ManifoldVertex<N>>& vertices,
-        std::vector<bool>* const interior_vertices,
-        std::size_t* const interior_count)
+        const std::vector<unsigned char>& interior_vertices)
 {
         const ManifoldVertex<N>& vertex = vertices[vertex_index];
 
         for (const auto neighbor_index : vertex.cocone_neighbors)
         {
-                if (!(*interior_vertices)[neighbor_index])
+                if (!interior_vertices[neighbor_index])
                 {
                         continue;
                 }
 
                 if (normal_condition(vertex, vertices[neighbor_index], cosine_of_alpha))
                 {
-                        (*interior_vertices)[vertex_index] = true;
-                        ++(*interior_count);
-                        break;
+                        return true;
                 }
         }
+
+        return false;
 }
 
+// The neighbors are taken from the interior vertices of the previous pass,
+// so the threads do not read the elements written by other threads.
+// The passes continue until no vertices are added, and the result
+// does not depend on the order in which the vertices are added
 template <std::size_t N>
 void expansion_phase(
         const double rho,
         const double cosine_of_alpha,
         const std::vector<ManifoldVertex<N>>& vertices,
-        std::vector<bool>* const interior_vertices,
+        std::vector<unsigned char>* const interior_vertices,
         std::size_t* const interior_count)
 {
-        for (std::size_t i = 0; i < vertices.size(); ++i)
-        {
-                if ((*interior_vertices)[i])
-                {
-                        continue;
-                }
+        const std::vector<unsigned char> previous_interior_vertices = *interior_vertices;
 
-                if (!ratio_condition(vertices[i], rho))
-                {
-                        continue;
-                }
+        std::atomic_size_t count = 0;
 
-                expansion_phase_neighbors(i, cosine_of_alpha, vertices, interior_vertices, interior_count);
-        }
+        run_in_chunks(
+                vertices.size(), VERTEX_CHUNK_SIZE,
+                [&](const std::size_t begin, const std::size_t end)
+                {
+                        std::size_t chunk_interior_count = 0;
+                        for (std::size_t i = begin; i < end; ++i)
+                        {
+                                if (previous_interior_vertices[i])
+                                {
+                                        continue;
+                                }
+
+                                if (!ratio_condition(vertices[i], rho))
+                                {
+                                        continue;
+                                }
+
+                                if (interior_neighbor(i, cosine_of_alpha, vertices, previous_interior_vertices))
+                                {
+                                        (*interior_vertices)[i] = true;
+                                        ++chunk_interior_count;
+                                }
+                        }
+                        count += chunk_interior_count;
+                });
+
+        *interior_count += count;
 }
 
 template <std::size_t N>
@@ -170,7 +206,7 @@ std::vector<bool> find_interior_vertices(
         const double cosine_of_alpha,
         const std::vector<ManifoldVertex<N>>& vertices)
 {
-        std::vector<bool> interior_vertices(vertices.size(), false);
+        std::vector<unsigned char> interior_vertices(vertices.size(), false);
 
         std::size_t interior_count = 0;
 
@@ -181,7 +217,7 @@ std::vector<bool> find_interior_vertices(
 
         if (interior_count == 0)
         {
-                return interior_vertices;
+                return std::vector<bool>(vertices.size(), false);
         }
 
         while (true)
@@ -198,7 +234,7 @@ std::vector<bool> find_interior_vertices(
         LOG("interior_vertices expansion phase, interior point count = " + to_string(interior_count)
             + ", vertex count = " + to_string(vertices.size()));
 
-        return interior_vertices;
+        return {interior_vertices.cbegin(), interior_vertices.cend()};
 }
 
 template <std::size_t N>
@@ -209,12 +245,19 @@ std::vector<bool> find_interior_facets(
 {
         ASSERT(delaunay_facets.size() == facet_data.size());
 
-        std::vector<bool> res(facet_data.size());
-        for (std::size_t i = 0; i < facet_data.size(); ++i)
-        {
-                res[i] = interior_facet(delaunay_facets, facet_data, interior_vertices, i);
-        }
-        return res;
+        std::vector<unsigned char> res(facet_data.size());
+
+        run_in_chunks(
+                facet_data.size(), FACET_CHUNK_SIZE,
+                [&](const std::size_t begin, const std::size_t end)
+                {
+                        for (std::size_t i = begin; i < end; ++i)
+                        {
+                                res[i] = interior_facet(delaunay_facets, facet_data, interior_vertices, i);
+                        }
+                });
+
+        return {res.cbegin(), res.cend()};
 }
 
 #define TEMPLATE(N)                                                                                                 \
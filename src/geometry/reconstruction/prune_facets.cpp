@@ -25,7 +25,9 @@ Cambridge University Press, 2007.
 
 #include "prune_facets.h"
 
+#include <src/com/alg.h>
 #include <src/com/error.h>
+#include <src/com/flat_hash_map.h>
 #include <src/geometry/core/delaunay.h>
 #include <src/geometry/core/ridge.h>
 #include <src/numerical/complement.h>
@@ -35,8 +37,6 @@ Cambridge University Press, 2007.
 #include <algorithm>
 #include <array>
 #include <cstddef>
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 namespace ns::geometry::reconstruction
@@ -44,10 +44,20 @@ namespace ns::geometry::reconstruction
 namespace
 {
 template <std::size_t N>
-using RidgeMap = std::unordered_map<core::Ridge<N>, core::RidgeFacets<core::DelaunayFacet<N>>>;
+using RidgeMap = FlatHashMap<core::Ridge<N>, core::RidgeFacets<core::DelaunayFacet<N>>>;
 
+// vector, sort and unique are faster than unordered_set
 template <std::size_t N>
-using RidgeSet = std::unordered_set<core::Ridge<N>>;
+using RidgeSet = std::vector<core::Ridge<N>>;
+
+template <typename T, std::size_t N>
+[[nodiscard]] numerical::Vector<N, T> point_vector(
+        const std::vector<core::DelaunayPoint<N>>& points,
+        const int from,
+        const int to)
+{
+        return to_vector<T>(points[to]) - to_vector<T>(points[from]);
+}
 
 // orthonormal orthogonal complement of a ridge
 template <std::size_t N, typename T>
@@ -62,17 +72,17 @@ class RidgeComplement final
 
 public:
         RidgeComplement(
-                const std::vector<numerical::Vector<N, T>>& points,
+                const std::vector<core::DelaunayPoint<N>>& points,
                 const std::array<int, N - 1>& indices,
                 const int point)
         {
                 std::array<numerical::Vector<N, T>, N - 1> vectors;
                 for (std::size_t i = 0; i < N - 2; ++i)
                 {
-                        vectors[i] = points[indices[i + 1]] - points[indices[0]];
+                        vectors[i] = point_vector<T>(points, indices[0], indices[i + 1]);
                 }
 
-                vectors[N - 2] = points[point] - points[indices[0]];
+                vectors[N - 2] = point_vector<T>(points, indices[0], point);
                 e0_ = numerical::orthogonal_complement(vectors).normalized();
 
                 vectors[N - 2] = e0_;
@@ -126,18 +136,18 @@ void update_angles(const T sine, const T cosine, Angles<T>* const res)
         }
 }
 
-template <std::size_t N, typename T>
+template <typename T, std::size_t N>
 [[nodiscard]] Angles<T> compute_angles(
-        const std::vector<numerical::Vector<N, T>>& points,
+        const std::vector<core::DelaunayPoint<N>>& points,
         const core::Ridge<N>& ridge,
         const core::RidgeFacets<core::DelaunayFacet<N>>& facets)
 {
         ASSERT(!facets.empty());
 
-        const RidgeComplement basis(points, ridge.vertices(), facets.cbegin()->point());
+        const RidgeComplement<N, T> basis(points, ridge.vertices(), facets.cbegin()->point());
 
         const numerical::Vector<2, T> base =
-                basis.coordinates(points[facets.cbegin()->point()] - points[ridge.vertices()[0]]);
+                basis.coordinates(point_vector<T>(points, ridge.vertices()[0], facets.cbegin()->point()));
         ASSERT(is_finite(base));
 
         Angles<T> res;
@@ -145,7 +155,7 @@ template <std::size_t N, typename T>
         for (auto facet = std::next(facets.cbegin()); facet != facets.cend(); ++facet)
         {
                 const numerical::Vector<2, T> v =
-                        basis.coordinates(points[facet->point()] - points[ridge.vertices()[0]]);
+                        basis.coordinates(point_vector<T>(points, ridge.vertices()[0], facet->point()));
                 ASSERT(is_finite(v));
 
                 const T sine = cross(base, v);
@@ -157,9 +167,9 @@ template <std::size_t N, typename T>
         return res;
 }
 
-template <std::size_t N, typename T>
+template <typename T, std::size_t N>
 [[nodiscard]] bool sharp_ridge(
-        const std::vector<numerical::Vector<N, T>>& points,
+        const std::vector<core::DelaunayPoint<N>>& points,
         const std::vector<bool>& interior_vertices,
         const core::Ridge<N>& ridge,
         const core::RidgeFacets<core::DelaunayFacet<N>>& ridge_facets)
@@ -177,7 +187,7 @@ template <std::size_t N, typename T>
                 return true;
         }
 
-        const Angles<T> angles = compute_angles(points, ridge, ridge_facets);
+        const Angles<T> angles = compute_angles<T>(points, ridge, ridge_facets);
 
         // not sharp if any angle is greater than or equal to 90 degrees
         if (angles.cos_plus <= 0 || angles.cos_minus <= 0)
@@ -196,9 +206,9 @@ template <std::size_t N, typename T>
 
 template <std::size_t N>
 [[nodiscard]] RidgeSet<N> prune(
-        const std::vector<numerical::Vector<N, double>>& points,
+        const std::vector<core::DelaunayPoint<N>>& points,
         const std::vector<bool>& interior_vertices,
-        const std::unordered_map<const core::DelaunayFacet<N>*, int>& facet_ptr_index,
+        const std::vector<core::DelaunayFacet<N>>& delaunay_facets,
         const RidgeSet<N>& suspicious_ridges,
         std::vector<bool>* const cocone_facets,
         RidgeMap<N>* const ridge_map)
@@ -210,7 +220,7 @@ template <std::size_t N>
                 const auto ridge_iter = ridge_map->find(r);
 
                 if (ridge_iter == ridge_map->cend()
-                    || !sharp_ridge(points, interior_vertices, ridge_iter->first, ridge_iter->second))
+                    || !sharp_ridge<double>(points, interior_vertices, ridge_iter->first, ridge_iter->second))
                 {
                         continue;
                 }
@@ -223,9 +233,9 @@ template <std::size_t N>
                         core::add_to_ridges(*(d->facet()), d->point(), &ridges);
                         facets_to_remove.push_back(d->facet());
 
-                        const auto del = facet_ptr_index.find(d->facet());
-                        ASSERT(del != facet_ptr_index.cend());
-                        (*cocone_facets)[del->second] = false;
+                        ASSERT(d->facet() >= delaunay_facets.data()
+                               && d->facet() < delaunay_facets.data() + delaunay_facets.size());
+                        (*cocone_facets)[d->facet() - delaunay_facets.data()] = false;
                 }
 
                 for (const core::DelaunayFacet<N>* const facet : facets_to_remove)
@@ -234,13 +244,15 @@ template <std::size_t N>
                 }
         }
 
+        sort_and_unique(&ridges);
+
         return ridges;
 }
 }
 
 template <std::size_t N>
 void prune_facets_incident_to_sharp_ridges(
-        const std::vector<numerical::Vector<N, double>>& points,
+        const std::vector<core::DelaunayPoint<N>>& points,
         const std::vector<core::DelaunayFacet<N>>& delaunay_facets,
         const std::vector<bool>& interior_vertices,
         std::vector<bool>* const cocone_facets)
@@ -248,33 +260,35 @@ void prune_facets_incident_to_sharp_ridges(
         ASSERT(!delaunay_facets.empty() && delaunay_facets.size() == cocone_facets->size());
         ASSERT(points.size() == interior_vertices.size());
 
-        RidgeMap<N> ridge_map;
-        std::unordered_map<const core::DelaunayFacet<N>*, int> facet_ptr_index;
+        const auto facet_count = std::ranges::count(*cocone_facets, true);
+
+        RidgeMap<N> ridge_map(N * facet_count / 2);
         for (std::size_t i = 0; i < delaunay_facets.size(); ++i)
         {
                 if ((*cocone_facets)[i])
                 {
                         core::add_to_ridges(&delaunay_facets[i], &ridge_map);
-                        facet_ptr_index.emplace(&delaunay_facets[i], i);
                 }
         }
 
-        RidgeSet<N> suspicious_ridges(ridge_map.size());
+        RidgeSet<N> suspicious_ridges;
+        suspicious_ridges.reserve(ridge_map.size());
         for (const auto& e : ridge_map)
         {
-                suspicious_ridges.insert(e.first);
+                suspicious_ridges.push_back(e.first);
         }
+        std::sort(suspicious_ridges.begin(), suspicious_ridges.end());
 
         while (!suspicious_ridges.empty())
         {
                 suspicious_ridges =
-                        prune(points, interior_vertices, facet_ptr_index, suspicious_ridges, cocone_facets, &ridge_map);
+                        prune(points, interior_vertices, delaunay_facets, suspicious_ridges, cocone_facets, &ridge_map);
         }
 }
 
-#define TEMPLATE(N)                                                                                               \
-        template void prune_facets_incident_to_sharp_ridges(                                                      \
-                const std::vector<numerical::Vector<(N), double>>&, const std::vector<core::DelaunayFacet<(N)>>&, \
+#define TEMPLATE(N)                                                                                         \
+        template void prune_facets_incident_to_sharp_ridges(                                                \
+                const std::vector<core::DelaunayPoint<(N)>>&, const std::vector<core::DelaunayFacet<(N)>>&, \
                 const std::vector<bool>&, std::vector<bool>*);
 
 TEMPLATE_INSTANTIATION_N_2(TEMPLATE)
@@ -27,6 +27,7 @@ Cambridge University Press, 2007.
 
 #include <src/com/alg.h>
 #include <src/com/error.h>
+#include <src/com/thread.h>
 #include <src/com/type/limit.h>
 #include <src/geometry/core/delaunay.h>
 #include <src/numerical/vector.h>
@@ -47,6 +48,8 @@ constexpr double LIMIT_COSINE_FOR_INTERSECTION_PA_AB = -0.9999;
 
 constexpr double MAX_VORONOI_EDGE_RADIUS = Limits<double>::max();
 
+constexpr std::size_t VERTEX_CHUNK_SIZE = 1 << 8;
+
 struct VertexConnections final
 {
         struct Facet final
@@ -407,15 +410,21 @@ void cocone_neighbors(
         ASSERT(delaunay_facets.size() == facet_data.size());
         ASSERT(vertex_connections.size() == vertex_data->size());
 
-        const int vertex_count = vertex_connections.size();
-        for (int vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
-        {
-                for (const VertexConnections::Facet& vertex_facet : vertex_connections[vertex_index].facets)
+        run_in_chunks(
+                vertex_connections.size(), VERTEX_CHUNK_SIZE,
+                [&](const std::size_t begin, const std::size_t end)
                 {
-                        cocone_neighbors(delaunay_facets, facet_data, vertex_index, vertex_facet, vertex_data);
-                }
-                sort_and_unique(&(*vertex_data)[vertex_index].cocone_neighbors);
-        }
+                        for (std::size_t vertex_index = begin; vertex_index < end; ++vertex_index)
+                        {
+                                for (const VertexConnections::Facet& vertex_facet :
+                                     vertex_connections[vertex_index].facets)
+                                {
+                                        cocone_neighbors(
+                                                delaunay_facets, facet_data, vertex_index, vertex_facet, vertex_data);
+                                }
+                                sort_and_unique(&(*vertex_data)[vertex_index].cocone_neighbors);
+                        }
+                });
 }
 
 template <std::size_t N>
@@ -447,53 +456,72 @@ std::vector<VertexConnections> vertex_connections(
 
         return connections;
 }
-}
 
 template <std::size_t N>
-ManifoldData<N> find_manifold_data(
+void manifold_vertex(
         const bool find_cocone_neighbors,
-        const std::vector<numerical::Vector<N, double>>& points,
+        const numerical::Vector<N, double>& point,
         const std::vector<core::DelaunayObject<N>>& objects,
-        const std::vector<core::DelaunayFacet<N>>& facets)
+        const std::vector<core::DelaunayFacet<N>>& facets,
+        const VertexConnections& connections,
+        ManifoldVertex<N>* const vertex_data,
+        std::vector<ManifoldFacet<N>>* const facet_data)
 {
-        const std::vector<VertexConnections> connections = vertex_connections(points.size(), objects, facets);
+        if (connections.facets.empty() && connections.objects.empty())
+        {
+                // No all points are Delaunay vertices.
+                // Integer convex hull algorithm can skip some points.
+                return;
+        }
 
-        std::vector<ManifoldVertex<N>> vertex_data;
-        std::vector<ManifoldFacet<N>> facet_data;
-        vertex_data.reserve(points.size());
-        facet_data.resize(facets.size());
+        ASSERT(!connections.facets.empty() && !connections.objects.empty());
 
-        for (std::size_t v = 0; v < points.size(); ++v)
+        const numerical::Vector<N, double> positive_norm = voronoi_positive_norm(point, objects, facets, connections);
+
+        if (!find_cocone_neighbors)
         {
-                if (connections[v].facets.empty() && connections[v].objects.empty())
-                {
-                        // No all points are Delaunay vertices.
-                        // Integer convex hull algorithm can skip some points.
-                        vertex_data.emplace_back(numerical::Vector<N, double>(0), 0, 0);
-                        continue;
-                }
+                cocone_facets(point, objects, facets, positive_norm, connections, facet_data);
 
-                ASSERT(!connections[v].facets.empty() && !connections[v].objects.empty());
+                *vertex_data = ManifoldVertex<N>(positive_norm, 0, 0);
+        }
+        else
+        {
+                const double height = voronoi_height(point, objects, positive_norm, connections.objects);
 
-                const numerical::Vector<N, double> positive_norm =
-                        voronoi_positive_norm(points[v], objects, facets, connections[v]);
+                const double voronoi_radius =
+                        cocone_facets_and_voronoi_radius(point, objects, facets, positive_norm, connections, facet_data);
 
-                if (!find_cocone_neighbors)
-                {
-                        cocone_facets(points[v], objects, facets, positive_norm, connections[v], &facet_data);
+                *vertex_data = ManifoldVertex<N>(positive_norm, height, voronoi_radius);
+        }
+}
+}
 
-                        vertex_data.emplace_back(positive_norm, 0, 0);
-                }
-                else
-                {
-                        const double height = voronoi_height(points[v], objects, positive_norm, connections[v].objects);
+template <std::size_t N>
+ManifoldData<N> find_manifold_data(
+        const bool find_cocone_neighbors,
+        const std::vector<core::DelaunayPoint<N>>& points,
+        const std::vector<core::DelaunayObject<N>>& objects,
+        const std::vector<core::DelaunayFacet<N>>& facets)
+{
+        const std::vector<VertexConnections> connections = vertex_connections(points.size(), objects, facets);
 
-                        const double voronoi_radius = cocone_facets_and_voronoi_radius(
-                                points[v], objects, facets, positive_norm, connections[v], &facet_data);
+        std::vector<ManifoldVertex<N>> vertex_data(
+                points.size(), ManifoldVertex<N>(numerical::Vector<N, double>(0), 0, 0));
+        std::vector<ManifoldFacet<N>> facet_data(facets.size());
 
-                        vertex_data.emplace_back(positive_norm, height, voronoi_radius);
-                }
-        }
+        // A facet vertex is processed only for its vertex,
+        // so the threads write different elements of the facet data
+        run_in_chunks(
+                points.size(), VERTEX_CHUNK_SIZE,
+                [&](const std::size_t begin, const std::size_t end)
+                {
+                        for (std::size_t v = begin; v < end; ++v)
+                        {
+                                manifold_vertex(
+                                        find_cocone_neighbors, to_vector<double>(points[v]), objects, facets,
+                                        connections[v], &vertex_data[v], &facet_data);
+                        }
+                });
 
         if (find_cocone_neighbors)
         {
@@ -505,9 +533,9 @@ ManifoldData<N> find_manifold_data(
         return {.vertices = std::move(vertex_data), .facets = std::move(facet_data)};
 }
 
-#define TEMPLATE(N)                                                       \
-        template ManifoldData<(N)> find_manifold_data(                    \
-                bool, const std::vector<numerical::Vector<(N), double>>&, \
+#define TEMPLATE(N)                                                 \
+        template ManifoldData<(N)> find_manifold_data(              \
+                bool, const std::vector<core::DelaunayPoint<(N)>>&, \
                 const std::vector<core::DelaunayObject<(N)>>&, const std::vector<core::DelaunayFacet<(N)>>&);
 
 TEMPLATE_INSTANTIATION_N_2(TEMPLATE)
@@ -59,7 +59,7 @@ struct ManifoldData final
 template <std::size_t N>
 [[nodiscard]] ManifoldData<N> find_manifold_data(
         bool find_cocone_neighbors,
-        const std::vector<numerical::Vector<N, double>>& points,
+        const std::vector<core::DelaunayPoint<N>>& points,
         const std::vector<core::DelaunayObject<N>>& delaunay_objects,
         const std::vector<core::DelaunayFacet<N>>& delaunay_facets);
 }
@@ -113,6 +113,11 @@ class HyperplaneSimplex final
 public:
         static T intersection_cost();
 
+        // Not initialized
+        HyperplaneSimplex()
+        {
+        }
+
         explicit HyperplaneSimplex(const std::array<numerical::Vector<N, T>, N>& vertices)
                 : HyperplaneSimplex(vertices, create_vectors(vertices))
         {
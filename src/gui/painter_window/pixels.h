@@ -90,8 +90,10 @@ class PainterPixels final : public Pixels, public painter::Notifier<N - 1>
         static_assert(N >= 3);
 
         static constexpr std::chrono::seconds NORMALIZE_INTERVAL{10};
+        static constexpr std::chrono::milliseconds PIXEL_NOTIFICATION_INTERVAL{100};
 
         static constexpr std::optional<int> MAX_PASS_COUNT = std::nullopt;
+        static constexpr int BPT_LIGHT_PATH_CONNECTION_COUNT = 4;
         static constexpr long long NULL_INDEX = -1;
 
         static constexpr image::ColorFormat COLOR_FORMAT = image::ColorFormat::R8G8B8A8_SRGB;
@@ -114,7 +116,7 @@ class PainterPixels final : public Pixels, public painter::Notifier<N - 1>
         std::vector<std::byte> pixels_r8g8b8a8_{make_initial_image(screen_size_, COLOR_FORMAT)};
         std::vector<numerical::Vector<3, float>> pixels_original_{
                 static_cast<std::size_t>(global_index_.count()), numerical::Vector<3, float>(MIN)};
-        std::vector<Spinlock> pixels_lock_{pixels_original_.size()};
+        std::vector<Spinlock> rows_lock_{pixels_original_.size() / screen_size_[0]};
         std::atomic<float> pixels_coef_ = 1;
 
         static_assert(std::atomic<float>::is_always_lock_free);
@@ -157,14 +159,19 @@ class PainterPixels final : public Pixels, public painter::Notifier<N - 1>
         void normalize_pixels(const float coef)
         {
                 ASSERT(pixels_original_.size() * PIXEL_SIZE == pixels_r8g8b8a8_.size());
+                ASSERT(pixels_original_.size() == rows_lock_.size() * screen_size_[0]);
+                const std::size_t row_size = screen_size_[0];
                 std::byte* ptr = pixels_r8g8b8a8_.data();
-                for (std::size_t i = 0; i < pixels_original_.size(); ++i, ptr += PIXEL_SIZE)
+                for (std::size_t row = 0, i = 0; row < rows_lock_.size(); ++row)
                 {
-                        const std::lock_guard lg(pixels_lock_[i]);
-                        const numerical::Vector<3, float>& pixel = pixels_original_[i];
-                        if (pixel[0] != MIN)
+                        const std::lock_guard lg(rows_lock_[row]);
+                        for (const std::size_t end = i + row_size; i < end; ++i, ptr += PIXEL_SIZE)
                         {
-                                write_r8g8b8a8(ptr, pixel * coef);
+                                const numerical::Vector<3, float>& pixel = pixels_original_[i];
+                                if (pixel[0] != MIN)
+                                {
+                                        write_r8g8b8a8(ptr, pixel * coef);
+                                }
                         }
                 }
                 ASSERT(ptr == pixels_r8g8b8a8_.data() + pixels_r8g8b8a8_.size());
@@ -211,10 +218,18 @@ class PainterPixels final : public Pixels, public painter::Notifier<N - 1>
 
         // PainterNotifier
 
-        void thread_busy(const unsigned thread_number, const std::array<int, N - 1>& pixel) override
+        [[nodiscard]] std::optional<std::chrono::milliseconds> pixel_notification_interval() const override
         {
-                const long long x = pixel[0];
-                const long long y = screen_size_[1] - 1 - pixel[1];
+                return PIXEL_NOTIFICATION_INTERVAL;
+        }
+
+        void thread_busy(
+                const unsigned thread_number,
+                const std::array<int, N - 1>& min,
+                const std::array<int, N - 1>& max) override
+        {
+                const long long x = (min[0] + max[0]) / 2;
+                const long long y = screen_size_[1] - 1 - (min[1] + max[1]) / 2;
                 busy_indices_2d_[thread_number] = y * screen_size_[0] + x;
         }
 
@@ -223,16 +238,43 @@ class PainterPixels final : public Pixels, public painter::Notifier<N - 1>
                 busy_indices_2d_[thread_number] = NULL_INDEX;
         }
 
-        void pixel_set(const std::array<int, N - 1>& pixel, const numerical::Vector<3, float>& rgb) override
+        void pixels_set(
+                const std::array<int, N - 1>& min,
+                const std::array<int, N - 1>& max,
+                const std::span<const numerical::Vector<3, float>> rgb) override
         {
                 static_assert(COLOR_FORMAT == image::ColorFormat::R8G8B8A8_SRGB);
 
-                const std::size_t index = global_index_.compute(flip_vertically(pixel));
-                std::byte* const ptr = pixels_r8g8b8a8_.data() + PIXEL_SIZE * index;
+                const float coef = pixels_coef_.load(std::memory_order_relaxed);
+
+                const std::size_t row_size = max[0] - min[0] + 1;
+                ASSERT(rgb.size() % row_size == 0);
+
+                std::array<int, N - 1> pixel = min;
+                for (std::size_t offset = 0; offset < rgb.size(); offset += row_size)
+                {
+                        const std::size_t index = global_index_.compute(flip_vertically(pixel));
+                        std::byte* ptr = pixels_r8g8b8a8_.data() + PIXEL_SIZE * index;
+
+                        {
+                                const std::lock_guard lg(rows_lock_[index / screen_size_[0]]);
+                                for (std::size_t i = 0; i < row_size; ++i, ptr += PIXEL_SIZE)
+                                {
+                                        const numerical::Vector<3, float>& color = rgb[offset + i];
+                                        pixels_original_[index + i] = color;
+                                        write_r8g8b8a8(ptr, color * coef);
+                                }
+                        }
 
-                const std::lock_guard lg(pixels_lock_[index]);
-                pixels_original_[index] = rgb;
-                write_r8g8b8a8(ptr, rgb * pixels_coef_.load(std::memory_order_relaxed));
+                        for (std::size_t i = 1; i < N - 1; ++i)
+                        {
+                                if (++pixel[i] <= max[i])
+                                {
+                                        break;
+                                }
+                                pixel[i] = min[i];
+                        }
+                }
         }
 
         painter::Images<N - 1>* images(const long long /*pass_number*/) override
@@ -378,10 +420,13 @@ public:
                                   integrator,
                                   this,
                                   samples_per_pixel,
+                                  BPT_LIGHT_PATH_CONNECTION_COUNT,
                                   MAX_PASS_COUNT,
                                   scene_.scene.get(),
+                                  std::nullopt,
                                   thread_count,
-                                  flat_shading))
+                                  flat_shading,
+                                  std::nullopt))
         {
                 normalize_thread_ = std::thread(
                         [this]
@@ -26,6 +26,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/com/error.h>
 #include <src/numerical/matrix.h>
 
+#include <algorithm>
 #include <bitset>
 #include <cstddef>
 #include <exception>
@@ -36,6 +37,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <string>
 #include <utility>
 #include <variant>
+#include <vector>
 
 namespace ns::model::mesh
 {
@@ -147,6 +149,14 @@ class MeshObject final : public std::enable_shared_from_this<MeshObject<N>>
 
         Versions<Updates().size()> versions_;
 
+        struct Attachment final
+        {
+                const void* key;
+                std::shared_ptr<const void> data;
+        };
+
+        mutable std::vector<Attachment> attachments_;
+
         mutable std::shared_mutex mutex_;
 
         void send_event(MeshEvent<N>&& event) noexcept
@@ -230,6 +240,48 @@ public:
                         send_event(event::Erase<N>(id_));
                 }
         }
+
+        // Data of other modules that is destroyed with the object
+        // or when it is replaced by the data with the same key.
+        // The replaced data is destroyed without the object lock
+        void attach(const void* const key, std::shared_ptr<const void> data) const
+        {
+                ASSERT(key);
+
+                const std::unique_lock lock(mutex_);
+                const auto iter = std::ranges::find(attachments_, key, &Attachment::key);
+                if (iter != attachments_.end())
+                {
+                        std::swap(iter->data, data);
+                        return;
+                }
+                attachments_.push_back({.key = key, .data = std::move(data)});
+        }
+
+        // Data of the cache that is evicted with the object or when
+        // the cache data is inserted again. The cache is the attachment key,
+        // the eviction function is called with the generation of the data
+        // if the cache exists. The cache checks that the generation
+        // is the generation of its current data
+        template <typename Cache>
+        void attach_eviction(
+                Cache* const cache,
+                void (Cache::*const evict)(unsigned long long),
+                const unsigned long long generation) const
+        {
+                ASSERT(cache && evict);
+
+                const std::weak_ptr<Cache> weak_cache = cache->weak_from_this();
+                attach(cache, std::shared_ptr<const void>(
+                                      nullptr,
+                                      [weak_cache, evict, generation](const void*)
+                                      {
+                                              if (const std::shared_ptr<Cache> ptr = weak_cache.lock())
+                                              {
+                                                      ((*ptr).*evict)(generation);
+                                              }
+                                      }));
+        }
 };
 
 template <std::size_t N>
@@ -387,6 +439,16 @@ public:
                 return object_->versions_.updates(version);
         }
 
+        [[nodiscard]] int version() const
+        {
+                return object_->versions_.version();
+        }
+
+        [[nodiscard]] Updates updates_after(const int version) const
+        {
+                return object_->versions_.updates_after(version);
+        }
+
         [[nodiscard]] const std::string& name() const
         {
                 return object_->name_;
@@ -55,6 +55,36 @@ public:
                 versions_.emplace_back(versions_.back().version + 1, updates);
         }
 
+        [[nodiscard]] int version() const
+        {
+                ASSERT(!versions_.empty());
+
+                return versions_.back().version;
+        }
+
+        // all updates if the version is older than the stored versions
+        [[nodiscard]] std::bitset<N> updates_after(const int version) const
+        {
+                ASSERT(!versions_.empty());
+                ASSERT(version <= versions_.back().version);
+
+                const int version_from = version + 1;
+                if (version_from < versions_.front().version)
+                {
+                        return std::bitset<N>().set();
+                }
+
+                std::bitset<N> updates;
+                for (const Version& v : versions_)
+                {
+                        if (v.version >= version_from)
+                        {
+                                updates |= v.updates;
+                        }
+                }
+                return updates;
+        }
+
         std::bitset<N> updates(std::optional<int>* const version) const
         {
                 ASSERT(version);
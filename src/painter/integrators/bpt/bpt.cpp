@@ -28,6 +28,8 @@ Elsevier, 2017.
 
 #include "connect.h"
 #include "light_distribution.h"
+#include "light_paths.h"
+#include "mis.h"
 #include "vertex_pdf.h"
 
 #include "vertex/camera.h"
@@ -49,6 +51,7 @@ Elsevier, 2017.
 #include <cmath>
 #include <cstddef>
 #include <optional>
+#include <random>
 #include <vector>
 
 namespace ns::painter::integrators::bpt
@@ -222,7 +225,7 @@ void generate_camera_path(
 {
         path->clear();
 
-        path->emplace_back(std::in_place_type<vertex::Camera<N, T, Color>>, ray.dir());
+        path->emplace_back(std::in_place_type<vertex::Camera<N, T, Color>>, &scene->projector(), ray.dir());
 
         walk<FLAT_SHADING>(
                 /*camera_path=*/true, scene, light_distribution, /*beta=*/Color{1}, /*pdf=*/T{1}, ray, engine, path);
@@ -262,6 +265,32 @@ void generate_light_path(
 
         ASSERT(path->size() <= MAX_DEPTH + 1);
 }
+
+template <bool FLAT_SHADING, std::size_t N, typename T, typename Color>
+[[nodiscard]] bool generate_camera_path(
+        const Scene<N, T, Color>& scene,
+        const numerical::Ray<N, T>& ray,
+        const LightDistribution<N, T, Color>& light_distribution,
+        PCG& engine,
+        std::vector<vertex::Vertex<N, T, Color>>* const camera_path,
+        std::optional<Color>* const color)
+{
+        generate_camera_path<FLAT_SHADING>(&scene, &light_distribution, ray, engine, camera_path);
+
+        if (camera_path->size() == 1)
+        {
+                *color = Color(0);
+                return false;
+        }
+
+        if (camera_path->size() == 2 && std::holds_alternative<vertex::InfiniteLight<N, T, Color>>((*camera_path)[1]))
+        {
+                *color = std::nullopt;
+                return false;
+        }
+
+        return true;
+}
 }
 
 template <bool FLAT_SHADING, std::size_t N, typename T, typename Color>
@@ -274,28 +303,85 @@ std::optional<Color> bpt(
         thread_local std::vector<vertex::Vertex<N, T, Color>> camera_path;
         thread_local std::vector<vertex::Vertex<N, T, Color>> light_path;
 
-        generate_camera_path<FLAT_SHADING>(&scene, &light_distribution, ray, engine, &camera_path);
-
-        if (camera_path.size() == 1)
+        std::optional<Color> color;
+        if (!generate_camera_path<FLAT_SHADING>(scene, ray, light_distribution, engine, &camera_path, &color))
         {
-                return Color(0);
+                return color;
         }
 
-        if (camera_path.size() == 2 && std::holds_alternative<vertex::InfiniteLight<N, T, Color>>(camera_path[1]))
+        generate_light_path<FLAT_SHADING>(&scene, &light_distribution, engine, &light_path);
+
+        return connect(MAX_DEPTH, scene, light_path, camera_path, light_distribution, engine);
+}
+
+template <bool FLAT_SHADING, std::size_t N, typename T, typename Color>
+void generate_light_paths(
+        const Scene<N, T, Color>& scene,
+        LightDistribution<N, T, Color>& light_distribution,
+        const std::size_t part,
+        const StrategyCounts<T>& counts,
+        PCG& engine,
+        LightPaths<N, T, Color>* const light_paths,
+        std::vector<CameraConnection<N, T, Color>>* const camera_connections)
+{
+        light_paths->generate(
+                part,
+                [&](std::vector<vertex::Vertex<N, T, Color>>* const path)
+                {
+                        generate_light_path<FLAT_SHADING>(&scene, &light_distribution, engine, path);
+                        if (counts.light_tracing_count > 0)
+                        {
+                                connect_to_camera(MAX_DEPTH, scene, *path, counts, camera_connections);
+                        }
+                });
+}
+
+template <bool FLAT_SHADING, std::size_t N, typename T, typename Color>
+std::optional<Color> bpt(
+        const Scene<N, T, Color>& scene,
+        const numerical::Ray<N, T>& ray,
+        const LightPaths<N, T, Color>& light_paths,
+        const StrategyCounts<T>& counts,
+        LightDistribution<N, T, Color>& light_distribution,
+        PCG& engine)
+{
+        ASSERT(counts.light_path_count > 0);
+        ASSERT(light_paths.size() > 0);
+
+        thread_local std::vector<vertex::Vertex<N, T, Color>> camera_path;
+        thread_local std::vector<const std::vector<vertex::Vertex<N, T, Color>>*> paths;
+
+        std::optional<Color> color;
+        if (!generate_camera_path<FLAT_SHADING>(scene, ray, light_distribution, engine, &camera_path, &color))
         {
-                return {};
+                return color;
         }
 
-        generate_light_path<FLAT_SHADING>(&scene, &light_distribution, engine, &light_path);
+        // each camera path uses its own random subset of the pool,
+        // but the pool is shared by all pixels of the pass
+        std::uniform_int_distribution<std::size_t> distribution(0, light_paths.size() - 1);
+        paths.clear();
+        for (int i = 0; i < counts.light_path_count; ++i)
+        {
+                paths.push_back(&light_paths[distribution(engine)]);
+        }
 
-        return connect(MAX_DEPTH, scene, light_path, camera_path, light_distribution, engine);
+        return connect(MAX_DEPTH, scene, paths, camera_path, counts, light_distribution, engine);
 }
 
-#define TEMPLATE(N, T, C)                                                                                   \
-        template std::optional<C> bpt<true, (N), T, C>(                                                     \
-                const Scene<(N), T, C>&, const numerical::Ray<(N), T>&, LightDistribution<N, T, C>&, PCG&); \
-        template std::optional<C> bpt<false, (N), T, C>(                                                    \
-                const Scene<(N), T, C>&, const numerical::Ray<(N), T>&, LightDistribution<N, T, C>&, PCG&);
+#define TEMPLATE_F(F, N, T, C)                                                                                     \
+        template std::optional<C> bpt<(F), (N), T, C>(                                                             \
+                const Scene<(N), T, C>&, const numerical::Ray<(N), T>&, LightDistribution<N, T, C>&, PCG&);        \
+        template void generate_light_paths<(F), (N), T, C>(                                                        \
+                const Scene<(N), T, C>&, LightDistribution<N, T, C>&, std::size_t, const StrategyCounts<T>&, PCG&, \
+                LightPaths<N, T, C>*, std::vector<CameraConnection<N, T, C>>*);                                    \
+        template std::optional<C> bpt<(F), (N), T, C>(                                                             \
+                const Scene<(N), T, C>&, const numerical::Ray<(N), T>&, const LightPaths<N, T, C>&,                \
+                const StrategyCounts<T>&, LightDistribution<N, T, C>&, PCG&);
+
+#define TEMPLATE(N, T, C)           \
+        TEMPLATE_F(true, N, T, C) \
+        TEMPLATE_F(false, N, T, C)
 
 TEMPLATE_INSTANTIATION_N_T_C(TEMPLATE)
 }
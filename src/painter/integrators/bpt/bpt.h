@@ -17,7 +17,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "connect.h"
 #include "light_distribution.h"
+#include "light_paths.h"
+#include "mis.h"
 
 #include <src/com/random/pcg.h>
 #include <src/numerical/ray.h>
@@ -25,6 +28,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <cstddef>
 #include <optional>
+#include <vector>
 
 namespace ns::painter::integrators::bpt
 {
@@ -34,4 +38,26 @@ template <bool FLAT_SHADING, std::size_t N, typename T, typename Color>
         const numerical::Ray<N, T>& ray,
         LightDistribution<N, T, Color>& light_distribution,
         PCG& engine);
+
+// If the light tracing count is not 0, the generated light paths
+// are connected to the camera and the connections are appended
+// to the specified vector
+template <bool FLAT_SHADING, std::size_t N, typename T, typename Color>
+void generate_light_paths(
+        const Scene<N, T, Color>& scene,
+        LightDistribution<N, T, Color>& light_distribution,
+        std::size_t part,
+        const StrategyCounts<T>& counts,
+        PCG& engine,
+        LightPaths<N, T, Color>* light_paths,
+        std::vector<CameraConnection<N, T, Color>>* camera_connections);
+
+template <bool FLAT_SHADING, std::size_t N, typename T, typename Color>
+[[nodiscard]] std::optional<Color> bpt(
+        const Scene<N, T, Color>& scene,
+        const numerical::Ray<N, T>& ray,
+        const LightPaths<N, T, Color>& light_paths,
+        const StrategyCounts<T>& counts,
+        LightDistribution<N, T, Color>& light_distribution,
+        PCG& engine);
 }
@@ -37,6 +37,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/painter/objects.h>
 #include <src/settings/instantiation.h>
 
+#include <array>
 #include <cstddef>
 #include <optional>
 #include <vector>
@@ -255,12 +256,90 @@ template <std::size_t N, typename T, typename Color>
         return std::move(color);
 }
 
+template <std::size_t N, typename T>
+[[nodiscard]] bool on_screen(const numerical::Vector<N, T>& screen_point, const std::array<int, N>& screen_size)
+{
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                if (!(screen_point[i] >= 0 && screen_point[i] < screen_size[i]))
+                {
+                        return false;
+                }
+        }
+        return true;
+}
+
+template <std::size_t N, typename T, typename Color>
+[[nodiscard]] std::optional<Color> compute_color_t_1(
+        const vertex::Surface<N, T, Color>& light,
+        const ProjectorPoint<N, T>& camera)
+{
+        const numerical::Vector<N, T>& n = light.normal();
+        const numerical::Vector<N, T>& v = light.dir_to_prev();
+        const numerical::Vector<N, T>& l = camera.dir;
+
+        const T n_l = dot(n, l);
+        if (!(n_l > 0))
+        {
+                return {};
+        }
+
+        return light.beta() * light.brdf(v, l) * (n_l * camera.pdf);
+}
+
+template <std::size_t N, typename T, typename Color>
+void connect_t_1(
+        const Scene<N, T, Color>& scene,
+        const std::vector<vertex::Vertex<N, T, Color>>& light_path,
+        const int s,
+        const StrategyCounts<T>& counts,
+        std::vector<CameraConnection<N, T, Color>>* const connections)
+{
+        ASSERT(s >= 2);
+
+        ASSERT((std::holds_alternative<vertex::Surface<N, T, Color>>(light_path[s - 1])));
+        const auto& light = std::get<vertex::Surface<N, T, Color>>(light_path[s - 1]);
+        if (!light.is_connectible())
+        {
+                return;
+        }
+
+        const Projector<N, T>& projector = scene.projector();
+
+        const std::optional<ProjectorPoint<N, T>> camera = projector.project(light.pos());
+        if (!camera || !on_screen(camera->screen_point, projector.screen_size()))
+        {
+                return;
+        }
+
+        const auto color = compute_color_t_1(light, *camera);
+        if (!color || color->is_black())
+        {
+                return;
+        }
+
+        const numerical::Ray<N, T> ray_to_camera(light.pos(), camera->dir);
+        if (com::occluded(scene, light.normals(), ray_to_camera, std::optional<T>(camera->distance)))
+        {
+                return;
+        }
+
+        thread_local std::vector<vertex::Vertex<N, T, Color>> path;
+        path.clear();
+        path.emplace_back(std::in_place_type<vertex::Camera<N, T, Color>>, &projector, -camera->dir);
+
+        connections->push_back(
+                {.screen_point = camera->screen_point,
+                 .color = *color * mis_weight(light_path, path, s, /*t=*/1, counts)});
+}
+
 template <std::size_t N, typename T, typename Color>
 std::optional<Color> weight_color(
         const std::vector<vertex::Vertex<N, T, Color>>& light_path,
         const std::vector<vertex::Vertex<N, T, Color>>& camera_path,
         const int s,
         const int t,
+        const StrategyCounts<T>& counts,
         const std::optional<Color>& color)
 {
         if (!color || color->is_black())
@@ -268,7 +347,7 @@ std::optional<Color> weight_color(
                 return {};
         }
 
-        return *color * mis_weight(light_path, camera_path, s, t);
+        return *color * mis_weight(light_path, camera_path, s, t, counts);
 }
 
 template <std::size_t N, typename T, typename Color>
@@ -276,6 +355,7 @@ std::optional<Color> weight_color_s_1(
         const std::vector<vertex::Vertex<N, T, Color>>& camera_path,
         const int s,
         const int t,
+        const StrategyCounts<T>& counts,
         const std::optional<ConnectS1<N, T, Color>>& connection)
 {
         if (!connection || connection->color.is_black())
@@ -286,7 +366,7 @@ std::optional<Color> weight_color_s_1(
         thread_local std::vector<vertex::Vertex<N, T, Color>> path;
         path.clear();
         path.push_back(connection->light_vertex);
-        return connection->color * mis_weight(path, camera_path, s, t);
+        return connection->color * mis_weight(path, camera_path, s, t, counts);
 }
 
 template <std::size_t N, typename T, typename Color>
@@ -296,6 +376,7 @@ std::optional<Color> connect(
         const std::vector<vertex::Vertex<N, T, Color>>& camera_path,
         const int s,
         const int t,
+        const StrategyCounts<T>& counts,
         LightDistribution<N, T, Color>& light_distribution,
         PCG& engine)
 {
@@ -305,7 +386,7 @@ std::optional<Color> connect(
         if (s == 0)
         {
                 const auto connection = connect_s_0(scene, camera_path[t - 1]);
-                return weight_color(light_path, camera_path, s, t, connection);
+                return weight_color(light_path, camera_path, s, t, counts, connection);
         }
 
         if (std::holds_alternative<vertex::InfiniteLight<N, T, Color>>(camera_path[t - 1]))
@@ -316,11 +397,11 @@ std::optional<Color> connect(
         if (s == 1)
         {
                 const auto connection = connect_s_1(scene, camera_path[t - 1], light_distribution, engine);
-                return weight_color_s_1(camera_path, s, t, connection);
+                return weight_color_s_1(camera_path, s, t, counts, connection);
         }
 
         const auto connection = connect(scene, light_path[s - 1], camera_path[t - 1]);
-        return weight_color(light_path, camera_path, s, t, connection);
+        return weight_color(light_path, camera_path, s, t, counts, connection);
 }
 
 template <std::size_t N, typename T, typename Color>
@@ -331,6 +412,7 @@ void connect(
         const std::vector<vertex::Vertex<N, T, Color>>& camera_path,
         const int s,
         const int t,
+        const StrategyCounts<T>& counts,
         LightDistribution<N, T, Color>& light_distribution,
         Color& color,
         PCG& engine)
@@ -341,7 +423,7 @@ void connect(
                 return;
         }
 
-        const auto c = connect(scene, light_path, camera_path, s, t, light_distribution, engine);
+        const auto c = connect(scene, light_path, camera_path, s, t, counts, light_distribution, engine);
         if (c)
         {
                 color += *c;
@@ -358,6 +440,8 @@ template <std::size_t N, typename T, typename Color>
         LightDistribution<N, T, Color>& light_distribution,
         PCG& engine)
 {
+        static constexpr StrategyCounts<T> COUNTS{.light_path_count = 1, .light_tracing_count = 0};
+
         const int camera_size = camera_path.size();
         const int light_size = light_path.size();
 
@@ -367,17 +451,90 @@ template <std::size_t N, typename T, typename Color>
         {
                 for (int s = 0; s <= light_size; ++s)
                 {
-                        connect(max_depth, scene, light_path, camera_path, s, t, light_distribution, color, engine);
+                        connect(max_depth, scene, light_path, camera_path, s, t, COUNTS, light_distribution,
+                                color, engine);
                 }
         }
 
         return color;
 }
 
-#define TEMPLATE(N, T, C)                                                                    \
-        template C connect(                                                                  \
-                int, const Scene<(N), T, C>&, const std::vector<vertex::Vertex<(N), T, C>>&, \
-                const std::vector<vertex::Vertex<(N), T, C>>&, LightDistribution<(N), T, C>&, PCG&);
+template <std::size_t N, typename T, typename Color>
+[[nodiscard]] Color connect(
+        const int max_depth,
+        const Scene<N, T, Color>& scene,
+        const std::vector<const std::vector<vertex::Vertex<N, T, Color>>*>& light_paths,
+        const std::vector<vertex::Vertex<N, T, Color>>& camera_path,
+        const StrategyCounts<T>& counts,
+        LightDistribution<N, T, Color>& light_distribution,
+        PCG& engine)
+{
+        ASSERT(!light_paths.empty());
+        ASSERT(counts.light_path_count == static_cast<int>(light_paths.size()));
+
+        static const std::vector<vertex::Vertex<N, T, Color>> EMPTY_PATH;
+
+        const int camera_size = camera_path.size();
+
+        Color color(0);
+        Color light_paths_color(0);
+
+        for (int t = 2; t <= camera_size; ++t)
+        {
+                for (int s = 0; s <= 1; ++s)
+                {
+                        connect(max_depth, scene, EMPTY_PATH, camera_path, s, t, counts, light_distribution,
+                                color, engine);
+                }
+
+                for (const std::vector<vertex::Vertex<N, T, Color>>* const light_path : light_paths)
+                {
+                        const int light_size = light_path->size();
+                        for (int s = 2; s <= light_size; ++s)
+                        {
+                                connect(max_depth, scene, *light_path, camera_path, s, t, counts,
+                                        light_distribution, light_paths_color, engine);
+                        }
+                }
+        }
+
+        return color + light_paths_color / static_cast<T>(counts.light_path_count);
+}
+
+template <std::size_t N, typename T, typename Color>
+void connect_to_camera(
+        const int max_depth,
+        const Scene<N, T, Color>& scene,
+        const std::vector<vertex::Vertex<N, T, Color>>& light_path,
+        const StrategyCounts<T>& counts,
+        std::vector<CameraConnection<N, T, Color>>* const connections)
+{
+        ASSERT(counts.light_tracing_count > 0);
+
+        const int light_size = light_path.size();
+
+        for (int s = 2; s <= light_size; ++s)
+        {
+                const int depth = s - 1;
+                if (depth > max_depth)
+                {
+                        return;
+                }
+                connect_t_1(scene, light_path, s, counts, connections);
+        }
+}
+
+#define TEMPLATE(N, T, C)                                                                                        \
+        template C connect(                                                                                      \
+                int, const Scene<(N), T, C>&, const std::vector<vertex::Vertex<(N), T, C>>&,                     \
+                const std::vector<vertex::Vertex<(N), T, C>>&, LightDistribution<(N), T, C>&, PCG&);             \
+        template C connect(                                                                                      \
+                int, const Scene<(N), T, C>&, const std::vector<const std::vector<vertex::Vertex<(N), T, C>>*>&, \
+                const std::vector<vertex::Vertex<(N), T, C>>&, const StrategyCounts<T>&,                         \
+                LightDistribution<(N), T, C>&, PCG&);                                                            \
+        template void connect_to_camera(                                                                         \
+                int, const Scene<(N), T, C>&, const std::vector<vertex::Vertex<(N), T, C>>&,                     \
+                const StrategyCounts<T>&, std::vector<CameraConnection<(N), T, C>>*);
 
 TEMPLATE_INSTANTIATION_N_T_C(TEMPLATE)
 }
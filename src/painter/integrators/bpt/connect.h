@@ -18,10 +18,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include "light_distribution.h"
+#include "mis.h"
 
 #include "vertex/vertex.h"
 
 #include <src/com/random/pcg.h>
+#include <src/numerical/vector.h>
 #include <src/painter/objects.h>
 
 #include <cstddef>
@@ -37,4 +39,33 @@ template <std::size_t N, typename T, typename Color>
         const std::vector<vertex::Vertex<N, T, Color>>& camera_path,
         LightDistribution<N, T, Color>& light_distribution,
         PCG& engine);
+
+// Light paths with at least 2 vertices are taken from the specified paths,
+// the contributions of the paths are averaged
+template <std::size_t N, typename T, typename Color>
+[[nodiscard]] Color connect(
+        int max_depth,
+        const Scene<N, T, Color>& scene,
+        const std::vector<const std::vector<vertex::Vertex<N, T, Color>>*>& light_paths,
+        const std::vector<vertex::Vertex<N, T, Color>>& camera_path,
+        const StrategyCounts<T>& counts,
+        LightDistribution<N, T, Color>& light_distribution,
+        PCG& engine);
+
+template <std::size_t N, typename T, typename Color>
+struct CameraConnection final
+{
+        numerical::Vector<N - 1, T> screen_point;
+        Color color;
+};
+
+// Connections of the light path vertices to the camera (t = 1),
+// the connections are appended to the specified vector
+template <std::size_t N, typename T, typename Color>
+void connect_to_camera(
+        int max_depth,
+        const Scene<N, T, Color>& scene,
+        const std::vector<vertex::Vertex<N, T, Color>>& light_path,
+        const StrategyCounts<T>& counts,
+        std::vector<CameraConnection<N, T, Color>>* connections);
 }
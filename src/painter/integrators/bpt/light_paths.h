@@ -0,0 +1,93 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "vertex/vertex.h"
+
+#include <src/com/error.h>
+#include <src/com/memory_arena.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace ns::painter::integrators::bpt
+{
+// Light subpaths shared by all pixels of a pass.
+// The paths are divided into parts that can be generated
+// concurrently. Surfaces of the vertices are allocated in the own
+// memory arena of each part, so the paths do not depend on the thread
+// local arenas.
+template <std::size_t N, typename T, typename Color>
+class LightPaths final
+{
+        std::vector<std::vector<vertex::Vertex<N, T, Color>>> paths_;
+        std::vector<std::unique_ptr<MemoryArena>> memory_arenas_;
+        std::size_t part_size_;
+
+public:
+        LightPaths(const std::size_t count, const std::size_t part_size)
+                : paths_(count),
+                  memory_arenas_((count + part_size - 1) / part_size),
+                  part_size_(part_size)
+        {
+                ASSERT(count > 0 && part_size > 0);
+        }
+
+        [[nodiscard]] std::size_t part_count() const
+        {
+                return memory_arenas_.size();
+        }
+
+        [[nodiscard]] std::size_t part_size(const std::size_t part) const
+        {
+                ASSERT(part < memory_arenas_.size());
+                return std::min(part_size_, paths_.size() - part * part_size_);
+        }
+
+        template <typename Generate>
+        void generate(const std::size_t part, const Generate& generate)
+        {
+                ASSERT(part < memory_arenas_.size());
+
+                std::unique_ptr<MemoryArena>& memory_arena = memory_arenas_[part];
+                memory_arena = MemoryArena::create();
+
+                const MemoryArena::Scope scope(memory_arena.get());
+
+                const std::size_t begin = part * part_size_;
+                const std::size_t end = std::min(begin + part_size_, paths_.size());
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                        generate(&paths_[i]);
+                }
+        }
+
+        [[nodiscard]] std::size_t size() const
+        {
+                return paths_.size();
+        }
+
+        [[nodiscard]] const std::vector<vertex::Vertex<N, T, Color>>& operator[](const std::size_t index) const
+        {
+                ASSERT(index < paths_.size());
+                return paths_[index];
+        }
+};
+}
@@ -24,6 +24,14 @@ Elsevier, 2017.
 16.3.4 Multiple importance sampling
 */
 
+/*
+Eric Veach.
+Robust Monte Carlo methods for light transport simulation.
+PhD thesis, Stanford University, 1997.
+
+9.2.2 The balance heuristic with different sample counts
+*/
+
 #include "mis.h"
 
 #include "vertex_pdf.h"
@@ -114,7 +122,15 @@ void set_reversed(
         std::vector<Node<T>>* const camera_nodes)
 {
         ASSERT(s >= 0);
-        ASSERT(t >= 2);
+        ASSERT(t >= 1);
+
+        if (t == 1)
+        {
+                ASSERT(s >= 2);
+                (*light_nodes)[s - 1].reversed = compute_camera_pdf(camera[0], light[s - 1]);
+                (*light_nodes)[s - 2].reversed = compute_pdf(camera[0], light[s - 1], light[s - 2]);
+                return;
+        }
 
         if (s == 0)
         {
@@ -152,14 +168,29 @@ template <typename T>
         return v != 0 ? v : 1;
 }
 
+// Light sources are not connected to the camera directly (s = 1, t = 1),
+// they are found by the camera paths
 template <typename T>
-[[nodiscard]] T light_sum(const std::vector<Node<T>>& light)
+[[nodiscard]] T strategy_count(const int s, const int t, const StrategyCounts<T>& counts)
+{
+        if (t == 1)
+        {
+                return s >= 2 ? counts.light_tracing_count : 0;
+        }
+        return s >= 2 ? counts.light_path_count : 1;
+}
+
+template <typename T>
+[[nodiscard]] T light_sum(const std::vector<Node<T>>& light, const int t, const StrategyCounts<T>& counts)
 {
         if (light.empty())
         {
                 return 0;
         }
 
+        const int s = light.size();
+        const T count = strategy_count(s, t, counts);
+
         T sum = 0;
         T ri = 1;
         for (int i = light.size() - 1; i > 0; --i)
@@ -167,25 +198,28 @@ template <typename T>
                 ri *= map(light[i].reversed) / map(light[i].forward);
                 if (light[i].connectible && light[i - 1].connectible)
                 {
-                        sum += ri;
+                        sum += ri * (strategy_count(i, s + t - i, counts) / count);
                 }
         }
         if (light[0].connectible)
         {
                 ri *= map(light[0].reversed) / map(light[0].forward);
-                sum += ri;
+                sum += ri * (strategy_count(0, s + t, counts) / count);
         }
         return sum;
 }
 
 template <typename T>
-[[nodiscard]] T camera_sum(const std::vector<Node<T>>& camera)
+[[nodiscard]] T camera_sum(const std::vector<Node<T>>& camera, const int s, const StrategyCounts<T>& counts)
 {
         if (camera.size() <= 1)
         {
                 return 0;
         }
 
+        const int t = camera.size();
+        const T count = strategy_count(s, t, counts);
+
         T sum = 0;
         T ri = 1;
         for (int i = camera.size() - 1; i > 1; --i)
@@ -193,13 +227,13 @@ template <typename T>
                 ri *= map(camera[i].reversed) / map(camera[i].forward);
                 if (camera[i].connectible && camera[i - 1].connectible)
                 {
-                        sum += ri;
+                        sum += ri * (strategy_count(s + t - i, i, counts) / count);
                 }
         }
         if (camera[1].connectible && camera[0].connectible)
         {
                 ri *= map(camera[1].reversed) / map(camera[1].forward);
-                sum += ri;
+                sum += ri * (strategy_count(s + t - 1, 1, counts) / count);
         }
         return sum;
 }
@@ -210,10 +244,14 @@ T mis_weight(
         const std::vector<vertex::Vertex<N, T, Color>>& light_path,
         const std::vector<vertex::Vertex<N, T, Color>>& camera_path,
         const int s,
-        const int t)
+        const int t,
+        const StrategyCounts<T>& counts)
 {
         ASSERT(s >= 0);
-        ASSERT(t >= 2);
+        ASSERT(t >= 1);
+        ASSERT(counts.light_path_count >= 1);
+        ASSERT(counts.light_tracing_count >= 0);
+        ASSERT(t > 1 || counts.light_tracing_count > 0);
 
         if (s + t == 2)
         {
@@ -231,13 +269,13 @@ T mis_weight(
         set_connectible(&light_nodes);
         set_connectible(&camera_nodes);
 
-        return 1 / (1 + light_sum(light_nodes) + camera_sum(camera_nodes));
+        return 1 / (1 + light_sum(light_nodes, t, counts) + camera_sum(camera_nodes, s, counts));
 }
 
 #define TEMPLATE(N, T, C)                                                                                          \
         template T mis_weight(                                                                                     \
                 const std::vector<vertex::Vertex<(N), T, C>>&, const std::vector<vertex::Vertex<(N), T, C>>&, int, \
-                int);
+                int, const StrategyCounts<T>&);
 
 TEMPLATE_INSTANTIATION_N_T_C(TEMPLATE)
 }
@@ -24,10 +24,22 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 namespace ns::painter::integrators::bpt
 {
+// The numbers of samples of the strategies per camera path.
+// Light paths with at least 2 vertices are connected to each camera
+// path light_path_count times. Light paths are connected to the camera
+// (t = 1) light_tracing_count times, 0 if there are no such connections.
+template <typename T>
+struct StrategyCounts final
+{
+        int light_path_count;
+        T light_tracing_count;
+};
+
 template <std::size_t N, typename T, typename Color>
 [[nodiscard]] T mis_weight(
         const std::vector<vertex::Vertex<N, T, Color>>& light_path,
         const std::vector<vertex::Vertex<N, T, Color>>& camera_path,
         int s,
-        int t);
+        int t,
+        const StrategyCounts<T>& counts);
 }
@@ -17,8 +17,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "area_pdf.h"
+
 #include <src/com/error.h>
 #include <src/numerical/vector.h>
+#include <src/painter/objects.h>
 
 #include <cstddef>
 
@@ -27,12 +30,15 @@ namespace ns::painter::integrators::bpt::vertex
 template <std::size_t N, typename T, typename Color>
 class Camera final
 {
+        const Projector<N, T>* projector_;
         numerical::Vector<N, T> dir_to_camera_;
 
 public:
-        explicit Camera(const numerical::Vector<N, T>& dir)
-                : dir_to_camera_(-dir)
+        Camera(const Projector<N, T>* const projector, const numerical::Vector<N, T>& dir)
+                : projector_(projector),
+                  dir_to_camera_(-dir)
         {
+                ASSERT(projector_);
                 ASSERT(dir_to_camera_.is_unit());
         }
 
@@ -43,11 +49,22 @@ public:
 
         [[nodiscard]] T area_pdf(
                 [[maybe_unused]] const T angle_pdf,
-                const numerical::Vector<N, T>& /*next_pos*/,
-                const numerical::Vector<N, T>& /*next_normal*/) const
+                const numerical::Vector<N, T>& next_pos,
+                const numerical::Vector<N, T>& next_normal) const
         {
                 ASSERT(angle_pdf == 1);
-                return 1;
+                return area_pdf(next_pos, next_normal);
+        }
+
+        [[nodiscard]] T area_pdf(const numerical::Vector<N, T>& next_pos, const numerical::Vector<N, T>& next_normal)
+                const
+        {
+                const auto point = projector_->project(next_pos);
+                if (!point)
+                {
+                        return 0;
+                }
+                return pos_pdf_to_area_pdf(point->pdf, point->dir, next_normal);
         }
 
         [[nodiscard]] bool is_connectible() const
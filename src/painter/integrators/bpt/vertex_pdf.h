@@ -114,6 +114,20 @@ template <std::size_t N, typename T, typename Color>
                 light_vertex);
 }
 
+template <std::size_t N, typename T, typename Color>
+[[nodiscard]] T compute_camera_pdf(
+        const vertex::Vertex<N, T, Color>& camera_vertex,
+        const vertex::Vertex<N, T, Color>& next_vertex)
+{
+        ASSERT((std::holds_alternative<vertex::Camera<N, T, Color>>(camera_vertex)));
+        const auto& camera = std::get<vertex::Camera<N, T, Color>>(camera_vertex);
+
+        ASSERT((std::holds_alternative<vertex::Surface<N, T, Color>>(next_vertex)));
+        const auto& surface = std::get<vertex::Surface<N, T, Color>>(next_vertex);
+
+        return camera.area_pdf(surface.pos(), surface.normal());
+}
+
 template <std::size_t N, typename T, typename Color>
 [[nodiscard]] T compute_light_origin_pdf(const vertex::Vertex<N, T, Color>& light_vertex)
 {
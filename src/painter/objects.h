@@ -271,6 +271,25 @@ public:
         [[nodiscard]] virtual bool is_infinite_area() const = 0;
 };
 
+template <std::size_t N, typename T>
+struct ProjectorPoint final
+{
+        static_assert(std::is_floating_point_v<T>);
+
+        // The screen point of the camera ray to the point,
+        // it can be outside the screen
+        numerical::Vector<N - 1, T> screen_point;
+        // The unit direction from the point to the camera
+        numerical::Vector<N, T> dir;
+        T distance;
+        // The density of the camera rays per unit screen area
+        // converted to the area measure at the point for the area
+        // perpendicular to the ray. The pixel values are averages
+        // over unit screen areas, so the camera importance
+        // of the point is equal to the density.
+        T pdf;
+};
+
 template <std::size_t N, typename T>
 class Projector
 {
@@ -282,6 +301,10 @@ public:
         [[nodiscard]] virtual const std::array<int, N - 1>& screen_size() const = 0;
 
         [[nodiscard]] virtual numerical::Ray<N, T> ray(const numerical::Vector<N - 1, T>& point) const = 0;
+
+        // The camera ray to the point if the point is in front of the camera
+        [[nodiscard]] virtual std::optional<ProjectorPoint<N, T>> project(const numerical::Vector<N, T>& point)
+                const = 0;
 };
 
 template <std::size_t N, typename T, typename Color>
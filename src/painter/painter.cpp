@@ -30,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <thread>
@@ -38,12 +39,44 @@ namespace ns::painter
 {
 namespace
 {
+template <std::size_t N>
+[[nodiscard]] ScreenRegion<N> screen_region(
+        const std::array<int, N>& screen_size,
+        const std::optional<ScreenRegion<N>>& region)
+{
+        if (region)
+        {
+                return *region;
+        }
+
+        ScreenRegion<N> res;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                res.min[i] = 0;
+                res.max[i] = screen_size[i] - 1;
+        }
+        return res;
+}
+
+template <std::size_t N>
+[[nodiscard]] long long pixel_count(const ScreenRegion<N>& region)
+{
+        long long res = 1;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                res *= region.max[i] - region.min[i] + 1;
+        }
+        return res;
+}
+
 template <std::size_t N, typename T, typename Color>
 void check_parameters(
         Notifier<N - 1>* const notifier,
         const int samples_per_pixel,
+        const int bpt_light_path_connection_count,
         const std::optional<int> max_pass_count,
         const Scene<N, T, Color>* const scene,
+        const std::optional<ScreenRegion<N - 1>>& region,
         const int thread_count)
 {
         if (!notifier)
@@ -61,6 +94,27 @@ void check_parameters(
                 error("Painter samples per pixel (" + to_string(samples_per_pixel) + ") must be greater than 0");
         }
 
+        if (bpt_light_path_connection_count < 0)
+        {
+                error("Painter BPT light path connection count (" + to_string(bpt_light_path_connection_count)
+                      + ") must be greater than or equal to 0");
+        }
+
+        if (region)
+        {
+                const std::array<int, N - 1>& screen_size = scene->projector().screen_size();
+                for (std::size_t i = 0; i < N - 1; ++i)
+                {
+                        if (!(region->min[i] >= 0 && region->min[i] <= region->max[i]
+                              && region->max[i] < screen_size[i]))
+                        {
+                                error("Painter region min " + to_string(region->min) + " and max "
+                                      + to_string(region->max) + " are not inside the screen "
+                                      + to_string(screen_size));
+                        }
+                }
+        }
+
         if (thread_count < 1)
         {
                 error("Painter thread count (" + to_string(thread_count) + ") must be greater than 0");
@@ -98,15 +152,21 @@ public:
         Impl(const Integrator integrator,
              Notifier<N - 1>* const notifier,
              const int samples_per_pixel,
+             const int bpt_light_path_connection_count,
              const std::optional<int> max_pass_count,
              const Scene<N, T, Color>* const scene,
+             const std::optional<ScreenRegion<N - 1>>& region,
              const int thread_count,
-             const bool flat_shading)
+             const bool flat_shading,
+             const std::optional<std::uint_least32_t> seed)
         {
-                check_parameters(notifier, samples_per_pixel, max_pass_count, scene, thread_count);
+                check_parameters(
+                        notifier, samples_per_pixel, bpt_light_path_connection_count, max_pass_count, scene, region,
+                        thread_count);
+
+                const ScreenRegion<N - 1> screen = screen_region(scene->projector().screen_size(), region);
 
-                statistics_ = std::make_unique<painting::Statistics>(
-                        multiply_all<long long>(scene->projector().screen_size()));
+                statistics_ = std::make_unique<painting::Statistics>(pixel_count(screen));
 
                 thread_ = std::thread(
                         [=, stop = &stop_, statistics = statistics_.get(), scene = scene] noexcept
@@ -114,14 +174,16 @@ public:
                                 if (flat_shading)
                                 {
                                         painting::painting<true>(
-                                                integrator, notifier, statistics, samples_per_pixel, max_pass_count,
-                                                *scene, thread_count, stop);
+                                                integrator, notifier, statistics, samples_per_pixel,
+                                                bpt_light_path_connection_count, max_pass_count, *scene, screen,
+                                                thread_count, seed, stop);
                                 }
                                 else
                                 {
                                         painting::painting<false>(
-                                                integrator, notifier, statistics, samples_per_pixel, max_pass_count,
-                                                *scene, thread_count, stop);
+                                                integrator, notifier, statistics, samples_per_pixel,
+                                                bpt_light_path_connection_count, max_pass_count, *scene, screen,
+                                                thread_count, seed, stop);
                                 }
                         });
         }
@@ -141,18 +203,23 @@ std::unique_ptr<Painter> create_painter(
         const Integrator integrator,
         Notifier<N - 1>* const notifier,
         const int samples_per_pixel,
+        const int bpt_light_path_connection_count,
         const std::optional<int> max_pass_count,
         const Scene<N, T, Color>* const scene,
+        const std::optional<ScreenRegion<N - 1>>& region,
         const int thread_count,
-        const bool flat_shading)
+        const bool flat_shading,
+        const std::optional<std::uint_least32_t> seed)
 {
         return std::make_unique<Impl>(
-                integrator, notifier, samples_per_pixel, max_pass_count, scene, thread_count, flat_shading);
+                integrator, notifier, samples_per_pixel, bpt_light_path_connection_count, max_pass_count, scene,
+                region, thread_count, flat_shading, seed);
 }
 
-#define TEMPLATE(N, T, C)                                 \
-        template std::unique_ptr<Painter> create_painter( \
-                Integrator, Notifier<(N) - 1>*, int, std::optional<int>, const Scene<(N), T, C>*, int, bool);
+#define TEMPLATE(N, T, C)                                                                                    \
+        template std::unique_ptr<Painter> create_painter(                                                    \
+                Integrator, Notifier<(N) - 1>*, int, int, std::optional<int>, const Scene<(N), T, C>*,       \
+                const std::optional<ScreenRegion<(N) - 1>>&, int, bool, std::optional<std::uint_least32_t>);
 
 TEMPLATE_INSTANTIATION_N_T_C(TEMPLATE)
 }
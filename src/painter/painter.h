@@ -23,15 +23,21 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/numerical/vector.h>
 
 #include <array>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <shared_mutex>
+#include <span>
 #include <string>
 
 namespace ns::painter
 {
+// Double-buffered images.
+// Writing is to the back buffer, reading is from the front buffer,
+// the buffers are swapped when writing is done.
 template <std::size_t N>
 class Images final
 {
@@ -40,9 +46,16 @@ class Images final
         template <std::size_t>
         friend class ImagesWriting;
 
+        struct Buffer final
+        {
+                image::Image<N> image_with_background;
+                image::Image<N> image_without_background;
+        };
+
         mutable std::shared_mutex mutex_;
-        image::Image<N> image_with_background_;
-        image::Image<N> image_without_background_;
+        std::mutex write_mutex_;
+        std::array<Buffer, 2> buffers_;
+        int front_ = 0;
 
 public:
         Images() = default;
@@ -57,23 +70,34 @@ template <std::size_t N>
 class ImagesWriting final
 {
         Images<N>* images_;
-        std::unique_lock<std::shared_mutex> lock_;
+        std::unique_lock<std::mutex> lock_;
 
 public:
         explicit ImagesWriting(Images<N>* const images)
                 : images_(images),
-                  lock_(images_->mutex_)
+                  lock_(images_->write_mutex_)
+        {
+        }
+
+        ~ImagesWriting()
         {
+                const std::unique_lock lock(images_->mutex_);
+                images_->front_ = 1 - images_->front_;
         }
 
+        ImagesWriting(const ImagesWriting&) = delete;
+        ImagesWriting& operator=(const ImagesWriting&) = delete;
+        ImagesWriting(ImagesWriting&&) = delete;
+        ImagesWriting& operator=(ImagesWriting&&) = delete;
+
         [[nodiscard]] image::Image<N>& image_with_background() const
         {
-                return images_->image_with_background_;
+                return images_->buffers_[1 - images_->front_].image_with_background;
         }
 
         [[nodiscard]] image::Image<N>& image_without_background() const
         {
-                return images_->image_without_background_;
+                return images_->buffers_[1 - images_->front_].image_without_background;
         }
 };
 
@@ -92,12 +116,12 @@ public:
 
         [[nodiscard]] const image::Image<N>& image_with_background() const
         {
-                return images_->image_with_background_;
+                return images_->buffers_[images_->front_].image_with_background;
         }
 
         [[nodiscard]] const image::Image<N>& image_without_background() const
         {
-                return images_->image_without_background_;
+                return images_->buffers_[images_->front_].image_without_background;
         }
 };
 
@@ -108,9 +132,23 @@ protected:
         ~Notifier() = default;
 
 public:
-        virtual void thread_busy(unsigned thread_number, const std::array<int, N>& pixel) = 0;
+        // No thread and pixel notifications if there is no interval,
+        // otherwise it is the minimum interval between pixel notifications
+        [[nodiscard]] virtual std::optional<std::chrono::milliseconds> pixel_notification_interval() const = 0;
+
+        // The region from min to max inclusive
+        virtual void thread_busy(
+                unsigned thread_number,
+                const std::array<int, N>& min,
+                const std::array<int, N>& max) = 0;
         virtual void thread_free(unsigned thread_number) = 0;
-        virtual void pixel_set(const std::array<int, N>& pixel, const numerical::Vector<3, float>& rgb) = 0;
+
+        // The colors of the region from min to max inclusive,
+        // the first coordinate changes fastest
+        virtual void pixels_set(
+                const std::array<int, N>& min,
+                const std::array<int, N>& max,
+                std::span<const numerical::Vector<3, float>> rgb) = 0;
         [[nodiscard]] virtual Images<N>* images(long long pass_number) = 0;
         virtual void pass_done(long long pass_number) = 0;
 
@@ -146,13 +184,34 @@ enum class Integrator
         PT
 };
 
+// The region of the screen from min to max inclusive
+template <std::size_t N>
+struct ScreenRegion final
+{
+        std::array<int, N> min;
+        std::array<int, N> max;
+};
+
+// If the region is not specified, the whole screen is painted,
+// otherwise the images have the size of the region. The painter
+// window and the painting process paint the whole screen,
+// the region is for library callers.
+// If the seed is specified, the random engines are seeded from it
+// and from the pixel coordinates for reproducible images.
+// The BPT light path connection count is the number of light paths
+// of the pass pool connected to each camera path. If it is 0, then
+// a new light path is generated for each camera path and the light
+// paths are not connected to the camera.
 template <std::size_t N, typename T, typename Color>
 std::unique_ptr<Painter> create_painter(
         Integrator integrator,
         Notifier<N - 1>* notifier,
         int samples_per_pixel,
+        int bpt_light_path_connection_count,
         std::optional<int> max_pass_count,
         const Scene<N, T, Color>* scene,
+        const std::optional<ScreenRegion<N - 1>>& region,
         int thread_count,
-        bool flat_shading);
+        bool flat_shading,
+        std::optional<std::uint_least32_t> seed);
 }
@@ -0,0 +1,61 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <src/com/random/pcg.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ns::painter::painting
+{
+namespace engine_implementation
+{
+// SplitMix64 finalizer
+[[nodiscard]] constexpr std::uint64_t mix(std::uint64_t v)
+{
+        v += 0x9e37'79b9'7f4a'7c15;
+        v = (v ^ (v >> 30)) * 0xbf58'476d'1ce4'e5b9;
+        v = (v ^ (v >> 27)) * 0x94d0'49bb'1331'11eb;
+        return v ^ (v >> 31);
+}
+}
+
+// The engine depends only on the seed, the pass number and the values,
+// so the images are reproducible for the specified seed.
+// The values select the stream of the engine
+template <std::size_t N>
+[[nodiscard]] PCG create_engine(
+        const std::uint_least32_t seed,
+        const long long pass_number,
+        const std::array<int, N>& values)
+{
+        namespace impl = engine_implementation;
+
+        const std::uint64_t state = impl::mix(impl::mix(seed) ^ static_cast<std::uint64_t>(pass_number));
+
+        std::uint64_t stream = 0;
+        for (const int v : values)
+        {
+                stream = impl::mix(stream ^ static_cast<std::uint32_t>(v));
+        }
+
+        return PCG(state, stream);
+}
+}
@@ -17,6 +17,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "integrator_bpt.h"
 
+#include "engine.h"
 #include "statistics.h"
 #include "thread_notifier.h"
 
@@ -26,15 +27,19 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/numerical/ray.h>
 #include <src/numerical/vector.h>
 #include <src/painter/integrators/bpt/bpt.h>
+#include <src/painter/integrators/bpt/connect.h>
 #include <src/painter/integrators/bpt/light_distribution.h>
+#include <src/painter/integrators/bpt/mis.h>
 #include <src/painter/objects.h>
 #include <src/painter/painter.h>
 #include <src/painter/pixels/pixels.h>
 #include <src/settings/instantiation.h>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <vector>
 
@@ -43,17 +48,46 @@ namespace ns::painter::painting
 namespace
 {
 constexpr int PANTBRUSH_WIDTH = 20;
+constexpr bool PANTBRUSH_PREVIEW = true;
+
+// Light paths generated once per pass and shared by all pixels.
+// Each camera path is connected to several random light paths from
+// the pool. The pool size is proportional to the number of camera paths
+// of the pass, so each light path is used by about the same number
+// of camera paths and the noise correlation between pixels is limited.
+constexpr long long LIGHT_PATH_USE_COUNT = 64;
+constexpr long long LIGHT_PATH_POOL_MIN_SIZE = 1 << 12;
+constexpr long long LIGHT_PATH_POOL_MAX_SIZE = 1 << 16;
+constexpr std::size_t LIGHT_PATH_PART_SIZE = 1 << 8;
+
+template <std::size_t N>
+std::size_t light_path_pool_size(
+        const ScreenRegion<N>& region,
+        const int samples_per_pixel,
+        const int light_path_connection_count)
+{
+        long long pixel_count = 1;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                pixel_count *= region.max[i] - region.min[i] + 1;
+        }
+        const long long size = pixel_count * samples_per_pixel * light_path_connection_count / LIGHT_PATH_USE_COUNT;
+        return std::clamp(size, LIGHT_PATH_POOL_MIN_SIZE, LIGHT_PATH_POOL_MAX_SIZE);
+}
 }
 
 template <bool FLAT_SHADING, std::size_t N, typename T, typename Color>
 IntegratorBPT<FLAT_SHADING, N, T, Color>::IntegratorBPT(
         const Scene<N, T, Color>* const scene,
+        const ScreenRegion<N - 1>& region,
         const std::atomic_bool* const stop,
         Statistics* const statistics,
         Notifier<N - 1>* const notifier,
         pixels::Pixels<N - 1, T, Color>* const pixels,
         const int samples_per_pixel,
-        const unsigned thread_count)
+        const int light_path_connection_count,
+        const unsigned thread_count,
+        const std::optional<std::uint_least32_t> seed)
         : scene_(scene),
           projector_(&scene_->projector()),
           stop_(stop),
@@ -61,7 +95,8 @@ IntegratorBPT<FLAT_SHADING, N, T, Color>::IntegratorBPT(
           notifier_(notifier),
           pixels_(pixels),
           sampler_(samples_per_pixel),
-          paintbrush_(projector_->screen_size(), PANTBRUSH_WIDTH),
+          paintbrush_(region.min, region.max, PANTBRUSH_WIDTH, PANTBRUSH_PREVIEW),
+          seed_(seed),
           light_distributions_(thread_count, integrators::bpt::LightDistribution(scene->light_sources()))
 {
         ASSERT(scene_);
@@ -69,6 +104,57 @@ IntegratorBPT<FLAT_SHADING, N, T, Color>::IntegratorBPT(
         ASSERT(statistics_);
         ASSERT(notifier_);
         ASSERT(pixels_);
+        ASSERT(light_path_connection_count >= 0);
+
+        if (light_path_connection_count <= 0)
+        {
+                return;
+        }
+
+        const std::size_t pool_size = light_path_pool_size(region, samples_per_pixel, light_path_connection_count);
+
+        // Each pool path is connected to the camera once per pass,
+        // each pixel has samples_per_pixel camera paths per pass
+        strategy_counts_ = {
+                .light_path_count = light_path_connection_count,
+                .light_tracing_count = static_cast<T>(pool_size) / samples_per_pixel};
+
+        light_paths_.emplace(pool_size, LIGHT_PATH_PART_SIZE);
+        light_path_engines_.resize(light_paths_->part_count());
+}
+
+template <bool FLAT_SHADING, std::size_t N, typename T, typename Color>
+void IntegratorBPT<FLAT_SHADING, N, T, Color>::prepare_pass(const unsigned thread_number)
+{
+        if (!light_paths_)
+        {
+                return;
+        }
+
+        ASSERT(thread_number < light_distributions_.size());
+
+        thread_local std::vector<integrators::bpt::CameraConnection<N, T, Color>> camera_connections;
+
+        std::size_t part = 0;
+        while ((part = light_path_part_++) < light_paths_->part_count())
+        {
+                PCG& engine = light_path_engines_[part];
+                if (seed_)
+                {
+                        engine = create_engine(*seed_, pass_number_, std::array{static_cast<int>(part)});
+                }
+
+                camera_connections.clear();
+                integrators::bpt::generate_light_paths<FLAT_SHADING>(
+                        *scene_, light_distributions_[thread_number], part, strategy_counts_, engine,
+                        &*light_paths_, &camera_connections);
+
+                for (const integrators::bpt::CameraConnection<N, T, Color>& connection : camera_connections)
+                {
+                        pixels_->add_splat(thread_number, connection.screen_point, connection.color);
+                }
+                pixels_->merge_splats(thread_number, light_paths_->part_size(part));
+        }
 }
 
 template <bool FLAT_SHADING, std::size_t N, typename T, typename Color>
@@ -76,31 +162,28 @@ void IntegratorBPT<FLAT_SHADING, N, T, Color>::next_pass()
 {
         sampler_.next_pass();
         paintbrush_.next_pass();
+
+        ++pass_number_;
+
+        light_path_part_ = 0;
 }
 
 template <bool FLAT_SHADING, std::size_t N, typename T, typename Color>
-bool IntegratorBPT<FLAT_SHADING, N, T, Color>::integrate(
+void IntegratorBPT<FLAT_SHADING, N, T, Color>::integrate(
         const unsigned thread_number,
+        const std::array<int, N - 1>& pixel,
         PCG& engine,
         std::vector<numerical::Vector<N - 1, T>>& sample_points,
         std::vector<std::optional<Color>>& sample_colors)
 {
         MemoryArena::thread_local_instance().clear();
 
-        if (*stop_)
+        if (seed_)
         {
-                return false;
+                engine = create_engine(*seed_, pass_number_, pixel);
         }
 
-        const std::optional<std::array<int, N - 1>> pixel = paintbrush_.next_pixel();
-        if (!pixel)
-        {
-                return false;
-        }
-
-        const ThreadNotifier thread_busy(notifier_, thread_number, *pixel);
-
-        const numerical::Vector<N - 1, T> pixel_org = numerical::to_vector<T>(*pixel);
+        const numerical::Vector<N - 1, T> pixel_org = numerical::to_vector<T>(pixel);
 
         sampler_.generate(engine, &sample_points);
         sample_colors.resize(sample_points.size());
@@ -113,13 +196,20 @@ bool IntegratorBPT<FLAT_SHADING, N, T, Color>::integrate(
         {
                 const numerical::Ray<N, T> ray = projector_->ray(pixel_org + sample_points[i]);
 
-                sample_colors[i] = integrators::bpt::bpt<FLAT_SHADING>(*scene_, ray, light_distribution, engine);
+                if (light_paths_)
+                {
+                        sample_colors[i] = integrators::bpt::bpt<FLAT_SHADING>(
+                                *scene_, ray, *light_paths_, strategy_counts_, light_distribution, engine);
+                }
+                else
+                {
+                        sample_colors[i] =
+                                integrators::bpt::bpt<FLAT_SHADING>(*scene_, ray, light_distribution, engine);
+                }
         }
 
-        pixels_->add_samples(*pixel, sample_points, sample_colors);
+        pixels_->add_samples(thread_number, pixel, sample_points, sample_colors);
         statistics_->pixel_done(scene_->thread_ray_count() - ray_count, sample_points.size());
-
-        return true;
 }
 
 template <bool FLAT_SHADING, std::size_t N, typename T, typename Color>
@@ -130,9 +220,24 @@ void IntegratorBPT<FLAT_SHADING, N, T, Color>::integrate(const unsigned thread_n
         thread_local PCG engine;
         thread_local std::vector<numerical::Vector<N - 1, T>> sample_points;
         thread_local std::vector<std::optional<Color>> sample_colors;
+        thread_local std::vector<std::array<int, N - 1>> tile;
 
-        while (integrate(thread_number, engine, sample_points, sample_colors))
+        while (!*stop_ && paintbrush_.next_tile(&tile))
         {
+                const ThreadNotifier thread_busy(notifier_, thread_number, tile);
+
+                pixels_->begin_tile(thread_number, tile);
+
+                for (const std::array<int, N - 1>& pixel : tile)
+                {
+                        if (*stop_)
+                        {
+                                break;
+                        }
+                        integrate(thread_number, pixel, engine, sample_points, sample_colors);
+                }
+
+                pixels_->end_tile(thread_number);
         }
 }
 
@@ -24,12 +24,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/com/random/pcg.h>
 #include <src/numerical/vector.h>
 #include <src/painter/integrators/bpt/light_distribution.h>
+#include <src/painter/integrators/bpt/light_paths.h>
+#include <src/painter/integrators/bpt/mis.h>
 #include <src/painter/objects.h>
 #include <src/painter/painter.h>
 #include <src/painter/pixels/pixels.h>
 
+#include <array>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <vector>
 
@@ -48,29 +52,48 @@ class IntegratorBPT final
         const StratifiedJitteredSampler<N - 1, T> sampler_;
         Paintbrush<N - 1> paintbrush_;
 
+        const std::optional<std::uint_least32_t> seed_;
+        long long pass_number_ = 0;
+
         std::vector<integrators::bpt::LightDistribution<N, T, Color>> light_distributions_;
 
-        [[nodiscard]] bool integrate(
+        integrators::bpt::StrategyCounts<T> strategy_counts_{.light_path_count = 1, .light_tracing_count = 0};
+        std::vector<PCG> light_path_engines_;
+        std::optional<integrators::bpt::LightPaths<N, T, Color>> light_paths_;
+        std::atomic_size_t light_path_part_ = 0;
+
+        void integrate(
                 unsigned thread_number,
+                const std::array<int, N - 1>& pixel,
                 PCG& engine,
                 std::vector<numerical::Vector<N - 1, T>>& sample_points,
                 std::vector<std::optional<Color>>& sample_colors);
 
 public:
+        // If the light path connection count is 0, then a new light path
+        // is generated for each camera path, otherwise each camera path
+        // is connected to the specified number of light paths from
+        // the pool of the pass and the pool paths are connected
+        // to the camera
         IntegratorBPT(
                 const Scene<N, T, Color>* scene,
+                const ScreenRegion<N - 1>& region,
                 const std::atomic_bool* stop,
                 Statistics* statistics,
                 Notifier<N - 1>* notifier,
                 pixels::Pixels<N - 1, T, Color>* pixels,
                 int samples_per_pixel,
-                unsigned thread_count);
+                int light_path_connection_count,
+                unsigned thread_count,
+                std::optional<std::uint_least32_t> seed);
 
         IntegratorBPT(const IntegratorBPT&) = delete;
         IntegratorBPT(IntegratorBPT&&) = delete;
         IntegratorBPT& operator=(const IntegratorBPT&) = delete;
         IntegratorBPT& operator=(IntegratorBPT&&) = delete;
 
+        void prepare_pass(unsigned thread_number);
+
         void next_pass();
 
         void integrate(unsigned thread_number);
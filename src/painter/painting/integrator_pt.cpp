@@ -17,6 +17,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "integrator_pt.h"
 
+#include "engine.h"
 #include "statistics.h"
 #include "thread_notifier.h"
 
@@ -34,6 +35,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <array>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <vector>
 
@@ -42,16 +44,19 @@ namespace ns::painter::painting
 namespace
 {
 constexpr int PANTBRUSH_WIDTH = 20;
+constexpr bool PANTBRUSH_PREVIEW = true;
 }
 
 template <bool FLAT_SHADING, std::size_t N, typename T, typename Color>
 IntegratorPT<FLAT_SHADING, N, T, Color>::IntegratorPT(
         const Scene<N, T, Color>* const scene,
+        const ScreenRegion<N - 1>& region,
         const std::atomic_bool* const stop,
         Statistics* const statistics,
         Notifier<N - 1>* const notifier,
         pixels::Pixels<N - 1, T, Color>* const pixels,
-        const int samples_per_pixel)
+        const int samples_per_pixel,
+        const std::optional<std::uint_least32_t> seed)
         : scene_(scene),
           projector_(&scene_->projector()),
           stop_(stop),
@@ -59,7 +64,8 @@ IntegratorPT<FLAT_SHADING, N, T, Color>::IntegratorPT(
           notifier_(notifier),
           pixels_(pixels),
           sampler_(samples_per_pixel),
-          paintbrush_(projector_->screen_size(), PANTBRUSH_WIDTH)
+          paintbrush_(region.min, region.max, PANTBRUSH_WIDTH, PANTBRUSH_PREVIEW),
+          seed_(seed)
 {
         ASSERT(scene_);
         ASSERT(stop_);
@@ -73,31 +79,26 @@ void IntegratorPT<FLAT_SHADING, N, T, Color>::next_pass()
 {
         sampler_.next_pass();
         paintbrush_.next_pass();
+
+        ++pass_number_;
 }
 
 template <bool FLAT_SHADING, std::size_t N, typename T, typename Color>
-bool IntegratorPT<FLAT_SHADING, N, T, Color>::integrate(
+void IntegratorPT<FLAT_SHADING, N, T, Color>::integrate(
         const unsigned thread_number,
+        const std::array<int, N - 1>& pixel,
         PCG& engine,
         std::vector<numerical::Vector<N - 1, T>>& sample_points,
         std::vector<std::optional<Color>>& sample_colors)
 {
         MemoryArena::thread_local_instance().clear();
 
-        if (*stop_)
+        if (seed_)
         {
-                return false;
+                engine = create_engine(*seed_, pass_number_, pixel);
         }
 
-        const std::optional<std::array<int, N - 1>> pixel = paintbrush_.next_pixel();
-        if (!pixel)
-        {
-                return false;
-        }
-
-        const ThreadNotifier thread_busy(notifier_, thread_number, *pixel);
-
-        const numerical::Vector<N - 1, T> pixel_org = numerical::to_vector<T>(*pixel);
+        const numerical::Vector<N - 1, T> pixel_org = numerical::to_vector<T>(pixel);
 
         sampler_.generate(engine, &sample_points);
         sample_colors.resize(sample_points.size());
@@ -110,10 +111,8 @@ bool IntegratorPT<FLAT_SHADING, N, T, Color>::integrate(
                 sample_colors[i] = integrators::pt::pt<FLAT_SHADING>(*scene_, ray, engine);
         }
 
-        pixels_->add_samples(*pixel, sample_points, sample_colors);
+        pixels_->add_samples(thread_number, pixel, sample_points, sample_colors);
         statistics_->pixel_done(scene_->thread_ray_count() - ray_count, sample_points.size());
-
-        return true;
 }
 
 template <bool FLAT_SHADING, std::size_t N, typename T, typename Color>
@@ -122,9 +121,24 @@ void IntegratorPT<FLAT_SHADING, N, T, Color>::integrate(const unsigned thread_nu
         thread_local PCG engine;
         thread_local std::vector<numerical::Vector<N - 1, T>> sample_points;
         thread_local std::vector<std::optional<Color>> sample_colors;
+        thread_local std::vector<std::array<int, N - 1>> tile;
 
-        while (integrate(thread_number, engine, sample_points, sample_colors))
+        while (!*stop_ && paintbrush_.next_tile(&tile))
         {
+                const ThreadNotifier thread_busy(notifier_, thread_number, tile);
+
+                pixels_->begin_tile(thread_number, tile);
+
+                for (const std::array<int, N - 1>& pixel : tile)
+                {
+                        if (*stop_)
+                        {
+                                break;
+                        }
+                        integrate(thread_number, pixel, engine, sample_points, sample_colors);
+                }
+
+                pixels_->end_tile(thread_number);
         }
 }
 
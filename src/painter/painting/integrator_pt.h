@@ -27,8 +27,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/painter/painter.h>
 #include <src/painter/pixels/pixels.h>
 
+#include <array>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <vector>
 
@@ -47,8 +49,12 @@ class IntegratorPT final
         const StratifiedJitteredSampler<N - 1, T> sampler_;
         Paintbrush<N - 1> paintbrush_;
 
-        [[nodiscard]] bool integrate(
+        const std::optional<std::uint_least32_t> seed_;
+        long long pass_number_ = 0;
+
+        void integrate(
                 unsigned thread_number,
+                const std::array<int, N - 1>& pixel,
                 PCG& engine,
                 std::vector<numerical::Vector<N - 1, T>>& sample_points,
                 std::vector<std::optional<Color>>& sample_colors);
@@ -56,11 +62,17 @@ class IntegratorPT final
 public:
         IntegratorPT(
                 const Scene<N, T, Color>* scene,
+                const ScreenRegion<N - 1>& region,
                 const std::atomic_bool* stop,
                 Statistics* statistics,
                 Notifier<N - 1>* notifier,
                 pixels::Pixels<N - 1, T, Color>* pixels,
-                int samples_per_pixel);
+                int samples_per_pixel,
+                std::optional<std::uint_least32_t> seed);
+
+        void prepare_pass(unsigned /*thread_number*/)
+        {
+        }
 
         void next_pass();
 
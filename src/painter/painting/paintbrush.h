@@ -22,34 +22,24 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/com/print.h>
 #include <src/com/type/limit.h>
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
 #include <mutex>
-#include <optional>
+#include <span>
 #include <type_traits>
 #include <vector>
 
 namespace ns::painter::painting
 {
+// With the preview, the first pass paints pixels
+// with all coordinates divisible by 4, then by 2,
+// and then the other pixels
+inline constexpr std::array<int, 2> PAINTBRUSH_PREVIEW_STRIDES = {4, 2};
+
 namespace paintbrush_implementation
 {
-template <typename Dst, std::size_t N, typename T>
-std::optional<std::array<Dst, N>> to_type(const std::optional<std::array<T, N>>& p)
-{
-        static_assert(!std::is_same_v<Dst, T>);
-        if (p)
-        {
-                std::array<Dst, N> res;
-                for (std::size_t i = 0; i < N; ++i)
-                {
-                        res[i] = (*p)[i];
-                }
-                return res;
-        }
-        return std::nullopt;
-}
-
 // Example for 2D
 // for (int x = 0; x < screen[0]; x += paintbrush[0])
 // {
@@ -203,6 +193,139 @@ std::vector<std::array<T, N>> generate_pixels(std::array<int, N> screen_size, co
 
         return pixels;
 }
+
+template <typename T, std::size_t N>
+std::vector<std::array<T, N>> generate_pixels(
+        const std::array<int, N>& min,
+        const std::array<int, N>& max,
+        const int paint_height)
+{
+        std::array<int, N> size;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                if (!(min[i] >= 0 && min[i] <= max[i]))
+                {
+                        error("Paintbrush region min " + to_string(min) + " and max " + to_string(max)
+                              + " are not correct");
+                }
+
+                if (static_cast<unsigned>(max[i]) > Limits<T>::max())
+                {
+                        error("Paintbrush region max " + to_string(max) + " is greater than the largest value "
+                              + to_string(Limits<T>::max()) + " of pixel coordinates");
+                }
+
+                size[i] = max[i] - min[i] + 1;
+        }
+
+        std::vector<std::array<T, N>> pixels = generate_pixels<T>(size, paint_height);
+
+        for (std::array<T, N>& pixel : pixels)
+        {
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                        pixel[i] += min[i];
+                }
+        }
+
+        return pixels;
+}
+
+// Consecutive pixels within a band make up a tile.
+// A new band starts with the first column.
+template <typename T, std::size_t N>
+void generate_tile_ends(
+        const std::span<const std::array<T, N>> pixels,
+        const std::size_t offset,
+        const int paint_height,
+        std::vector<std::size_t>* const tile_ends)
+{
+        const std::size_t max_tile_size = static_cast<std::size_t>(paint_height) * paint_height;
+
+        std::size_t tile_begin = 0;
+        for (std::size_t i = 1; i < pixels.size(); ++i)
+        {
+                const bool new_band = pixels[i][0] < pixels[i - 1][0];
+                const bool new_column = pixels[i][0] != pixels[i - 1][0];
+                if (new_band || (new_column && i - tile_begin >= max_tile_size))
+                {
+                        tile_ends->push_back(offset + i);
+                        tile_begin = i;
+                }
+        }
+        tile_ends->push_back(offset + pixels.size());
+}
+
+template <typename T, std::size_t N>
+std::vector<std::size_t> generate_tile_ends(const std::vector<std::array<T, N>>& pixels, const int paint_height)
+{
+        std::vector<std::size_t> res;
+        generate_tile_ends(std::span<const std::array<T, N>>(pixels), 0, paint_height, &res);
+        return res;
+}
+
+template <typename T, std::size_t N>
+[[nodiscard]] std::size_t preview_stage(const std::array<T, N>& pixel)
+{
+        for (std::size_t stage = 0; stage < PAINTBRUSH_PREVIEW_STRIDES.size(); ++stage)
+        {
+                const int stride = PAINTBRUSH_PREVIEW_STRIDES[stage];
+                if (std::ranges::all_of(
+                            pixel,
+                            [&](const T v)
+                            {
+                                    return v % stride == 0;
+                            }))
+                {
+                        return stage;
+                }
+        }
+        return PAINTBRUSH_PREVIEW_STRIDES.size();
+}
+
+// The pixels of each preview stage and then the other pixels,
+// each part in the paintbrush order and with its own tiles
+template <typename T, std::size_t N>
+void generate_preview(
+        const std::vector<std::array<T, N>>& pixels,
+        const int paint_height,
+        std::vector<std::array<T, N>>* const preview_pixels,
+        std::vector<std::size_t>* const preview_tile_ends)
+{
+        constexpr std::size_t STAGE_COUNT = PAINTBRUSH_PREVIEW_STRIDES.size() + 1;
+
+        std::array<std::size_t, STAGE_COUNT + 1> stage_offsets{};
+        for (const std::array<T, N>& pixel : pixels)
+        {
+                ++stage_offsets[preview_stage(pixel) + 1];
+        }
+        for (std::size_t i = 1; i <= STAGE_COUNT; ++i)
+        {
+                stage_offsets[i] += stage_offsets[i - 1];
+        }
+        ASSERT(stage_offsets[STAGE_COUNT] == pixels.size());
+
+        preview_pixels->resize(pixels.size());
+        std::array<std::size_t, STAGE_COUNT> positions;
+        std::copy_n(stage_offsets.cbegin(), STAGE_COUNT, positions.begin());
+        for (const std::array<T, N>& pixel : pixels)
+        {
+                (*preview_pixels)[positions[preview_stage(pixel)]++] = pixel;
+        }
+
+        preview_tile_ends->clear();
+        for (std::size_t i = 0; i < STAGE_COUNT; ++i)
+        {
+                const std::size_t begin = stage_offsets[i];
+                const std::size_t end = stage_offsets[i + 1];
+                if (begin < end)
+                {
+                        generate_tile_ends(
+                                std::span<const std::array<T, N>>(preview_pixels->data() + begin, end - begin), begin,
+                                paint_height, preview_tile_ends);
+                }
+        }
+}
 }
 
 template <std::size_t N>
@@ -216,43 +339,98 @@ class Paintbrush final
         static_assert(std::is_unsigned_v<T>);
 
         std::vector<std::array<T, N>> pixels_;
+        std::vector<std::size_t> tile_ends_;
+        // The first pass order with the preview, empty after the first pass
+        std::vector<std::array<T, N>> preview_pixels_;
+        std::vector<std::size_t> preview_tile_ends_;
+        const std::vector<std::array<T, N>>* pass_pixels_;
+        const std::vector<std::size_t>* pass_tile_ends_;
         unsigned long long current_pixel_;
         mutable std::mutex lock_;
 
-        void init()
+        void init(const bool preview, const int paint_height)
         {
+                if (preview)
+                {
+                        paintbrush_implementation::generate_preview(
+                                pixels_, paint_height, &preview_pixels_, &preview_tile_ends_);
+                        pass_pixels_ = &preview_pixels_;
+                        pass_tile_ends_ = &preview_tile_ends_;
+                }
+                else
+                {
+                        pass_pixels_ = &pixels_;
+                        pass_tile_ends_ = &tile_ends_;
+                }
                 current_pixel_ = 0;
         }
 
 public:
-        Paintbrush(const std::array<int, N>& screen_size, const int paint_height)
-                : pixels_(paintbrush_implementation::generate_pixels<T>(screen_size, paint_height))
+        Paintbrush(const std::array<int, N>& screen_size, const int paint_height, const bool preview)
+                : pixels_(paintbrush_implementation::generate_pixels<T>(screen_size, paint_height)),
+                  tile_ends_(paintbrush_implementation::generate_tile_ends(pixels_, paint_height))
+        {
+                init(preview, paint_height);
+        }
+
+        // The region from min to max inclusive
+        Paintbrush(
+                const std::array<int, N>& min,
+                const std::array<int, N>& max,
+                const int paint_height,
+                const bool preview)
+                : pixels_(paintbrush_implementation::generate_pixels<T>(min, max, paint_height)),
+                  tile_ends_(paintbrush_implementation::generate_tile_ends(pixels_, paint_height))
         {
-                init();
+                init(preview, paint_height);
         }
 
+        Paintbrush(const Paintbrush&) = delete;
+        Paintbrush& operator=(const Paintbrush&) = delete;
+
         void next_pass()
         {
                 const std::lock_guard lg(lock_);
 
-                ASSERT(current_pixel_ == pixels_.size());
-                init();
+                ASSERT(current_pixel_ == pass_pixels_->size());
+
+                pass_pixels_ = &pixels_;
+                pass_tile_ends_ = &tile_ends_;
+                current_pixel_ = 0;
+
+                preview_pixels_.clear();
+                preview_pixels_.shrink_to_fit();
+                preview_tile_ends_.clear();
+                preview_tile_ends_.shrink_to_fit();
         }
 
-        std::optional<std::array<int, N>> next_pixel()
+        [[nodiscard]] bool next_tile(std::vector<std::array<int, N>>* const pixels)
         {
-                const auto res = [this] -> std::optional<std::array<T, N>>
+                pixels->clear();
+
+                const std::lock_guard lg(lock_);
+
+                if (current_pixel_ >= pass_pixels_->size())
                 {
-                        const std::lock_guard lg(lock_);
+                        return false;
+                }
+
+                const std::size_t begin = current_pixel_;
+                const std::size_t end = *std::upper_bound(pass_tile_ends_->cbegin(), pass_tile_ends_->cend(), begin);
+                current_pixel_ = end;
+
+                ASSERT(begin < end && end <= pass_pixels_->size());
 
-                        if (current_pixel_ < pixels_.size())
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                        std::array<int, N>& pixel = pixels->emplace_back();
+                        for (std::size_t n = 0; n < N; ++n)
                         {
-                                return pixels_[current_pixel_++];
+                                pixel[n] = (*pass_pixels_)[i][n];
                         }
-                        return std::nullopt;
-                }();
+                }
 
-                return paintbrush_implementation::to_type<int>(res);
+                return true;
         }
 };
 }
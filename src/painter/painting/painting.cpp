@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "integrator_bpt.h"
 #include "integrator_pt.h"
+#include "paintbrush.h"
 #include "statistics.h"
 
 #include <src/com/enum.h>
@@ -33,6 +34,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <atomic>
 #include <barrier>
 #include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <optional>
 #include <string>
@@ -55,6 +57,13 @@ class Painting final
         std::optional<int> pass_count_;
         std::atomic_int call_counter_ = 0;
 
+        std::optional<ImagesWriting<N>> images_writing_;
+
+        template <typename F>
+        void call(const F& f);
+
+        void begin_images(unsigned thread_number);
+
         void prepare_next_pass(unsigned thread_number);
 
         [[nodiscard]] bool paint_pass(unsigned thread_number, std::barrier<>* barrier);
@@ -89,22 +98,41 @@ public:
 };
 
 template <std::size_t N, typename T, typename Color, typename Integrator>
-void Painting<N, T, Color, Integrator>::prepare_next_pass(const unsigned thread_number)
+void Painting<N, T, Color, Integrator>::begin_images(const unsigned thread_number)
 {
         if (thread_number != 0)
         {
                 return;
         }
 
-        statistics_->pass_done();
+        images_writing_.emplace(notifier_->images(statistics_->statistics().pass_number));
+        pixels_->begin_images(
+                &images_writing_->image_with_background(), &images_writing_->image_without_background());
+}
 
-        const long long pass_number = statistics_->statistics().pass_number;
+template <std::size_t N, typename T, typename Color, typename Integrator>
+void Painting<N, T, Color, Integrator>::prepare_next_pass(const unsigned thread_number)
+{
+        if (thread_number != 0)
+        {
+                return;
+        }
 
+        if (images_writing_)
         {
-                const ImagesWriting lock(notifier_->images(pass_number));
-                pixels_->images(&lock.image_with_background(), &lock.image_without_background());
+                pixels_->end_images();
+                images_writing_.reset();
         }
 
+        if (*stop_)
+        {
+                return;
+        }
+
+        statistics_->pass_done();
+
+        const long long pass_number = statistics_->statistics().pass_number;
+
         notifier_->pass_done(pass_number);
 
         if (!pass_count_ || --*pass_count_ > 0)
@@ -119,11 +147,12 @@ void Painting<N, T, Color, Integrator>::prepare_next_pass(const unsigned thread_
 }
 
 template <std::size_t N, typename T, typename Color, typename Integrator>
-bool Painting<N, T, Color, Integrator>::paint_pass(const unsigned thread_number, std::barrier<>* const barrier)
+template <typename F>
+void Painting<N, T, Color, Integrator>::call(const F& f)
 {
         try
         {
-                integrator_->integrate(thread_number);
+                f();
         }
         catch (const std::exception& e)
         {
@@ -135,6 +164,24 @@ bool Painting<N, T, Color, Integrator>::paint_pass(const unsigned thread_number,
                 *stop_ = true;
                 notifier_->error_message("Unknown painter error");
         }
+}
+
+template <std::size_t N, typename T, typename Color, typename Integrator>
+bool Painting<N, T, Color, Integrator>::paint_pass(const unsigned thread_number, std::barrier<>* const barrier)
+{
+        call(
+                [&]
+                {
+                        integrator_->prepare_pass(thread_number);
+                });
+
+        barrier->arrive_and_wait();
+
+        call(
+                [&]
+                {
+                        integrator_->integrate(thread_number);
+                });
 
         barrier->arrive_and_wait();
 
@@ -143,20 +190,30 @@ bool Painting<N, T, Color, Integrator>::paint_pass(const unsigned thread_number,
                 return false;
         }
 
-        try
-        {
-                prepare_next_pass(thread_number);
-        }
-        catch (const std::exception& e)
-        {
-                *stop_ = true;
-                notifier_->error_message(std::string("Painter error:\n") + e.what());
-        }
-        catch (...)
-        {
-                *stop_ = true;
-                notifier_->error_message("Unknown painter error");
-        }
+        call(
+                [&]
+                {
+                        begin_images(thread_number);
+                });
+
+        barrier->arrive_and_wait();
+
+        call(
+                [&]
+                {
+                        if (images_writing_)
+                        {
+                                pixels_->update_images(thread_number);
+                        }
+                });
+
+        barrier->arrive_and_wait();
+
+        call(
+                [&]
+                {
+                        prepare_next_pass(thread_number);
+                });
 
         barrier->arrive_and_wait();
 
@@ -226,26 +283,32 @@ void painting_impl(
         Notifier<N - 1>* const notifier,
         Statistics* const statistics,
         const int samples_per_pixel,
+        const int bpt_light_path_connection_count,
         const std::optional<int> max_pass_count,
         const Scene<N, T, Color>& scene,
+        const ScreenRegion<N - 1>& region,
         const int thread_count,
+        const std::optional<std::uint_least32_t> seed,
         std::atomic_bool* const stop)
 {
-        pixels::Pixels<N - 1, T, Color> pixels(scene.projector().screen_size(), scene.background_color(), notifier);
+        pixels::Pixels<N - 1, T, Color> pixels(
+                region.min, region.max, scene.background_color(), notifier, thread_count,
+                PAINTBRUSH_PREVIEW_STRIDES);
 
         switch (integrator)
         {
         case Integrator::BPT:
         {
                 IntegratorBPT<FLAT_SHADING, N, T, Color> integrator_bpt(
-                        &scene, stop, statistics, notifier, &pixels, samples_per_pixel, thread_count);
+                        &scene, region, stop, statistics, notifier, &pixels, samples_per_pixel,
+                        bpt_light_path_connection_count, thread_count, seed);
                 painting_impl(stop, statistics, notifier, &pixels, &integrator_bpt, max_pass_count, thread_count);
                 return;
         }
         case Integrator::PT:
         {
                 IntegratorPT<FLAT_SHADING, N, T, Color> integrator_pt(
-                        &scene, stop, statistics, notifier, &pixels, samples_per_pixel);
+                        &scene, region, stop, statistics, notifier, &pixels, samples_per_pixel, seed);
                 painting_impl(stop, statistics, notifier, &pixels, &integrator_pt, max_pass_count, thread_count);
                 return;
         }
@@ -260,9 +323,12 @@ void painting(
         Notifier<N - 1>* const notifier,
         Statistics* const statistics,
         const int samples_per_pixel,
+        const int bpt_light_path_connection_count,
         const std::optional<int> max_pass_count,
         const Scene<N, T, Color>& scene,
+        const ScreenRegion<N - 1>& region,
         const int thread_count,
+        const std::optional<std::uint_least32_t> seed,
         std::atomic_bool* const stop) noexcept
 {
         try
@@ -270,8 +336,9 @@ void painting(
                 try
                 {
                         painting_impl<FLAT_SHADING>(
-                                integrator, notifier, statistics, samples_per_pixel, max_pass_count, scene,
-                                thread_count, stop);
+                                integrator, notifier, statistics, samples_per_pixel,
+                                bpt_light_path_connection_count, max_pass_count, scene, region, thread_count, seed,
+                                stop);
                 }
                 catch (const std::exception& e)
                 {
@@ -290,11 +357,11 @@ void painting(
 
 #define TEMPLATE(N, T, C)                                                                                           \
         template void painting<true, (N), T, C>(                                                                    \
-                Integrator, Notifier<(N) - 1>*, Statistics*, int, std::optional<int>, const Scene<(N), T, C>&, int, \
-                std::atomic_bool*) noexcept;                                                                        \
+                Integrator, Notifier<(N) - 1>*, Statistics*, int, int, std::optional<int>, const Scene<(N), T, C>&, \
+                const ScreenRegion<(N) - 1>&, int, std::optional<std::uint_least32_t>, std::atomic_bool*) noexcept; \
         template void painting<false, (N), T, C>(                                                                   \
-                Integrator, Notifier<(N) - 1>*, Statistics*, int, std::optional<int>, const Scene<(N), T, C>&, int, \
-                std::atomic_bool*) noexcept;
+                Integrator, Notifier<(N) - 1>*, Statistics*, int, int, std::optional<int>, const Scene<(N), T, C>&, \
+                const ScreenRegion<(N) - 1>&, int, std::optional<std::uint_least32_t>, std::atomic_bool*) noexcept;
 
 TEMPLATE_INSTANTIATION_N_T_C(TEMPLATE)
 }
@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <optional>
 
 namespace ns::painter::painting
@@ -34,8 +35,11 @@ void painting(
         Notifier<N - 1>* notifier,
         Statistics* statistics,
         int samples_per_pixel,
+        int bpt_light_path_connection_count,
         std::optional<int> max_pass_count,
         const Scene<N, T, Color>& scene,
+        const ScreenRegion<N - 1>& region,
         int thread_count,
+        std::optional<std::uint_least32_t> seed,
         std::atomic_bool* stop) noexcept;
 }
@@ -22,70 +22,112 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <array>
 #include <cstddef>
-#include <optional>
 #include <string>
+#include <vector>
 
 namespace ns::painter::painting
 {
 namespace
 {
-template <std::size_t N, typename T>
-std::string str(const std::optional<std::array<T, N>>& v)
+template <std::size_t N>
+void check_tile(Paintbrush<N>* const paintbrush, const std::vector<std::array<int, N>>& c)
 {
-        if (v)
+        std::vector<std::array<int, N>> tile;
+        if (!paintbrush->next_tile(&tile))
         {
-                return to_string(*v);
+                tile.clear();
+        }
+        if (tile != c)
+        {
+                error("Error paintbrush tile " + to_string(tile) + ", expected " + to_string(c));
         }
-        return "nullopt";
 }
 
-template <std::size_t N, typename T>
-void check_impl(const std::optional<std::array<T, N>>& p, const std::optional<std::array<T, N>>& c)
+template <std::size_t N>
+void check_pass(Paintbrush<N>* const paintbrush, const std::vector<std::array<int, N>>& c)
 {
-        if (p != c)
+        std::vector<std::array<int, N>> pixels;
+        std::vector<std::array<int, N>> tile;
+        while (paintbrush->next_tile(&tile))
+        {
+                pixels.insert(pixels.end(), tile.cbegin(), tile.cend());
+        }
+        if (pixels != c)
         {
-                error("Error paintbrush pixel " + str(p) + ", expected " + str(c));
+                error("Error paintbrush pixels " + to_string(pixels) + ", expected " + to_string(c));
         }
 }
 
-template <std::size_t N, typename T>
-void check(const std::optional<std::array<T, N>>& p, const std::array<T, N>& c)
+void test_pixels()
 {
-        check_impl<N, T>(p, c);
+        const std::vector<std::array<int, 2>> pixels = {{0, 3}, {0, 2}, {0, 1}, {1, 3}, {1, 2}, {1, 1},
+                                                        {2, 3}, {2, 2}, {2, 1}, {3, 3}, {3, 2}, {3, 1},
+                                                        {0, 0}, {1, 0}, {2, 0}, {3, 0}};
+
+        Paintbrush<2> paintbrush({4, 4}, 3, false);
+        for (int i = 0; i < 2; ++i)
+        {
+                check_pass(&paintbrush, pixels);
+                paintbrush.next_pass();
+        }
 }
 
-template <std::size_t N, typename T>
-void check(const std::optional<std::array<T, N>>& p, const std::nullopt_t& c)
+void test_tiles()
 {
-        check_impl<N, T>(p, c);
+        Paintbrush<2> paintbrush({4, 4}, 3, false);
+        for (int i = 0; i < 2; ++i)
+        {
+                check_tile(&paintbrush, {{0, 3}, {0, 2}, {0, 1}, {1, 3}, {1, 2}, {1, 1}, {2, 3}, {2, 2}, {2, 1}});
+                check_tile(&paintbrush, {{3, 3}, {3, 2}, {3, 1}});
+                check_tile(&paintbrush, {{0, 0}, {1, 0}, {2, 0}, {3, 0}});
+                check_tile(&paintbrush, {});
+                paintbrush.next_pass();
+        }
 }
 
-void test()
+void test_region()
 {
-        Paintbrush<2> paintbrush({4, 4}, 3);
+        Paintbrush<2> paintbrush({1, 2}, {4, 5}, 3, false);
         for (int i = 0; i < 2; ++i)
         {
-                check(paintbrush.next_pixel(), {0, 3});
-                check(paintbrush.next_pixel(), {0, 2});
-                check(paintbrush.next_pixel(), {0, 1});
-                check(paintbrush.next_pixel(), {1, 3});
-                check(paintbrush.next_pixel(), {1, 2});
-                check(paintbrush.next_pixel(), {1, 1});
-                check(paintbrush.next_pixel(), {2, 3});
-                check(paintbrush.next_pixel(), {2, 2});
-                check(paintbrush.next_pixel(), {2, 1});
-                check(paintbrush.next_pixel(), {3, 3});
-                check(paintbrush.next_pixel(), {3, 2});
-                check(paintbrush.next_pixel(), {3, 1});
-                check(paintbrush.next_pixel(), {0, 0});
-                check(paintbrush.next_pixel(), {1, 0});
-                check(paintbrush.next_pixel(), {2, 0});
-                check(paintbrush.next_pixel(), {3, 0});
-                check(paintbrush.next_pixel(), std::nullopt);
+                check_tile(&paintbrush, {{1, 5}, {1, 4}, {1, 3}, {2, 5}, {2, 4}, {2, 3}, {3, 5}, {3, 4}, {3, 3}});
+                check_tile(&paintbrush, {{4, 5}, {4, 4}, {4, 3}});
+                check_tile(&paintbrush, {{1, 2}, {2, 2}, {3, 2}, {4, 2}});
+                check_tile(&paintbrush, {});
                 paintbrush.next_pass();
         }
 }
 
+void test_preview()
+{
+        Paintbrush<2> paintbrush({4, 4}, 3, true);
+
+        check_tile(&paintbrush, {{0, 0}});
+        check_tile(&paintbrush, {{0, 2}, {2, 2}, {2, 0}});
+        check_tile(
+                &paintbrush, {{0, 3}, {0, 1}, {1, 3}, {1, 2}, {1, 1}, {2, 3}, {2, 1}, {3, 3}, {3, 2}, {3, 1}});
+        check_tile(&paintbrush, {{1, 0}, {3, 0}});
+        check_tile(&paintbrush, {});
+        paintbrush.next_pass();
+
+        for (int i = 0; i < 2; ++i)
+        {
+                check_tile(&paintbrush, {{0, 3}, {0, 2}, {0, 1}, {1, 3}, {1, 2}, {1, 1}, {2, 3}, {2, 2}, {2, 1}});
+                check_tile(&paintbrush, {{3, 3}, {3, 2}, {3, 1}});
+                check_tile(&paintbrush, {{0, 0}, {1, 0}, {2, 0}, {3, 0}});
+                check_tile(&paintbrush, {});
+                paintbrush.next_pass();
+        }
+}
+
+void test()
+{
+        test_pixels();
+        test_tiles();
+        test_region();
+        test_preview();
+}
+
 TEST_SMALL("Paintbrush", test)
 }
 }
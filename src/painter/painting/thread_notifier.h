@@ -18,9 +18,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <src/painter/painter.h>
+#include <src/painter/pixels/pixel_region.h>
 
 #include <array>
 #include <cstddef>
+#include <vector>
 
 namespace ns::painter::painting
 {
@@ -31,16 +33,23 @@ class ThreadNotifier final
         unsigned thread_;
 
 public:
-        ThreadNotifier(Notifier<N>* const notifier, const unsigned thread, const std::array<int, N>& pixel)
-                : notifier_(notifier),
+        ThreadNotifier(Notifier<N>* const notifier, const unsigned thread, const std::vector<std::array<int, N>>& tile)
+                : notifier_(notifier->pixel_notification_interval() ? notifier : nullptr),
                   thread_(thread)
         {
-                notifier_->thread_busy(thread_, pixel);
+                if (notifier_)
+                {
+                        const pixels::RegionBounds<N> bounds = pixels::region_bounds(tile);
+                        notifier_->thread_busy(thread_, bounds.min, bounds.max);
+                }
         }
 
         ~ThreadNotifier()
         {
-                notifier_->thread_free(thread_);
+                if (notifier_)
+                {
+                        notifier_->thread_free(thread_);
+                }
         }
 
         ThreadNotifier(const ThreadNotifier&) = delete;
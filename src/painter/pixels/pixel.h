@@ -38,6 +38,27 @@ class Pixel final
         samples::BackgroundSamples<COUNT, Color> background_samples_;
 
 public:
+        [[nodiscard]] bool empty() const
+        {
+                return color_samples_.empty() && background_samples_.empty();
+        }
+
+        [[nodiscard]] bool has_color_samples() const
+        {
+                return !color_samples_.empty();
+        }
+
+        [[nodiscard]] const samples::BackgroundSamples<COUNT, Color>& background_samples() const
+        {
+                return background_samples_;
+        }
+
+        void merge(const Pixel& pixel)
+        {
+                merge(pixel.color_samples_);
+                merge(pixel.background_samples_);
+        }
+
         void merge(const samples::ColorSamples<COUNT, Color>& samples)
         {
                 color_samples_ = samples::merge_samples(color_samples_, samples);
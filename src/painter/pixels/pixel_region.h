@@ -17,34 +17,26 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <src/com/error.h>
+
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <vector>
 
 namespace ns::painter::pixels
 {
 namespace pixel_region_implementation
 {
-template <std::size_t N>
-[[nodiscard]] std::array<int, N> max_values_for_size(const std::array<int, N>& size)
-{
-        std::array<int, N> res;
-        for (std::size_t i = 0; i < N; ++i)
-        {
-                res[i] = size[i] - 1;
-        }
-        return res;
-}
-
 template <std::size_t I, std::size_t N, typename F>
 void traverse(const std::array<int, N>& min, const std::array<int, N>& max, std::array<int, N>& p, const F& f)
 {
         for (int i = min[I]; i <= max[I]; ++i)
         {
                 p[I] = i;
-                if constexpr (I + 1 < N)
+                if constexpr (I > 0)
                 {
-                        traverse<I + 1>(min, max, p, f);
+                        traverse<I - 1>(min, max, p, f);
                 }
                 else
                 {
@@ -54,15 +46,50 @@ void traverse(const std::array<int, N>& min, const std::array<int, N>& max, std:
 }
 }
 
+// The first coordinate changes fastest
+template <std::size_t N, typename F>
+void traverse_region(const std::array<int, N>& min, const std::array<int, N>& max, const F& f)
+{
+        std::array<int, N> p;
+        pixel_region_implementation::traverse<N - 1>(min, max, p, f);
+}
+
+template <std::size_t N>
+struct RegionBounds final
+{
+        std::array<int, N> min;
+        std::array<int, N> max;
+};
+
+template <std::size_t N>
+[[nodiscard]] RegionBounds<N> region_bounds(const std::vector<std::array<int, N>>& pixels)
+{
+        ASSERT(!pixels.empty());
+
+        RegionBounds<N> res{.min = pixels.front(), .max = pixels.front()};
+        for (const std::array<int, N>& pixel : pixels)
+        {
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                        res.min[i] = std::min(res.min[i], pixel[i]);
+                        res.max[i] = std::max(res.max[i], pixel[i]);
+                }
+        }
+        return res;
+}
+
 template <std::size_t N>
 class PixelRegion final
 {
+        std::array<int, N> min_;
         std::array<int, N> max_;
         int integer_radius_;
 
 public:
-        PixelRegion(const std::array<int, N>& size, const int integer_radius)
-                : max_(pixel_region_implementation::max_values_for_size(size)),
+        // min and max are inclusive
+        PixelRegion(const std::array<int, N>& min, const std::array<int, N>& max, const int integer_radius)
+                : min_(min),
+                  max_(max),
                   integer_radius_(integer_radius)
         {
         }
@@ -74,11 +101,10 @@ public:
                 std::array<int, N> max;
                 for (std::size_t i = 0; i < N; ++i)
                 {
-                        min[i] = std::max(0, pixel[i] - integer_radius_);
+                        min[i] = std::max(min_[i], pixel[i] - integer_radius_);
                         max[i] = std::min(max_[i], pixel[i] + integer_radius_);
                 }
-                std::array<int, N> p;
-                pixel_region_implementation::traverse<0>(min, max, p, f);
+                traverse_region(min, max, f);
         }
 };
 }
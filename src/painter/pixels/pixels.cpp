@@ -19,28 +19,45 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "pixel.h"
 
+#include "pixel_region.h"
+#include "splat_buffer.h"
+#include "tile_buffer.h"
+
 #include "samples/create.h"
+#include "samples/merge.h"
 
+#include <src/com/arrays.h>
+#include <src/com/chrono.h>
 #include <src/com/error.h>
 #include <src/com/log.h>
+#include <src/com/print.h>
 #include <src/image/format.h>
 #include <src/image/image.h>
 #include <src/numerical/vector.h>
 #include <src/painter/painter.h>
 #include <src/settings/instantiation.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cmath>
 #include <cstddef>
 #include <cstring>
+#include <memory>
 #include <mutex>
 #include <optional>
+#include <span>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace ns::painter::pixels
 {
 namespace
 {
+constexpr std::size_t RGB_PIXEL_SIZE = 3 * sizeof(float);
+constexpr std::size_t RGBA_PIXEL_SIZE = 4 * sizeof(float);
+
 template <typename T, std::size_t N>
 [[nodiscard]] numerical::Vector<N, T> region_pixel_center(
         const std::array<int, N>& region_pixel,
@@ -53,17 +70,183 @@ template <typename T, std::size_t N>
         }
         return res;
 }
+
+template <std::size_t N>
+[[nodiscard]] std::array<int, N> block_coordinates(const GlobalIndex<N, long long>& index, long long block_index)
+{
+        std::array<int, N> res;
+        for (std::size_t i = N - 1; i > 0; --i)
+        {
+                res[i] = block_index / index.stride(i);
+                block_index -= res[i] * index.stride(i);
+        }
+        res[0] = block_index;
+        return res;
+}
+
+template <std::size_t N>
+[[nodiscard]] std::array<int, N> block_count(const std::array<int, N>& max, const int block_size)
+{
+        std::array<int, N> res;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                res[i] = max[i] / block_size + 1;
+        }
+        return res;
+}
+
+template <std::size_t N>
+[[nodiscard]] std::array<int, N> block_origin(const std::array<int, N>& min, const int block_size)
+{
+        std::array<int, N> res;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                ASSERT(min[i] >= 0);
+                res[i] = min[i] - min[i] % block_size;
+        }
+        return res;
+}
+
+template <std::size_t N>
+[[nodiscard]] std::array<int, N> subtract(const std::array<int, N>& a, const std::array<int, N>& b)
+{
+        std::array<int, N> res;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                res[i] = a[i] - b[i];
+        }
+        return res;
+}
+
+template <std::size_t N>
+[[nodiscard]] std::array<int, N> region_size(const std::array<int, N>& min, const std::array<int, N>& max)
+{
+        std::array<int, N> res;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                if (!(min[i] >= 0 && min[i] <= max[i]))
+                {
+                        error("Pixel region min " + to_string(min) + " and max " + to_string(max)
+                              + " are not correct");
+                }
+                res[i] = max[i] - min[i] + 1;
+        }
+        return res;
+}
+
+template <std::size_t N>
+[[nodiscard]] std::array<int, N> screen_max(const std::array<int, N>& screen_size)
+{
+        std::array<int, N> res;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                res[i] = screen_size[i] - 1;
+        }
+        return res;
+}
+
+template <typename T>
+[[nodiscard]] T splat_scale(const long long light_path_count)
+{
+        return light_path_count > 0 ? 1 / static_cast<T>(light_path_count) : 0;
+}
+
+template <int BLOCK_SIZE>
+[[nodiscard]] std::vector<int> sort_preview_strides(const std::span<const int> preview_strides)
+{
+        std::vector<int> res(preview_strides.begin(), preview_strides.end());
+        for (const int stride : res)
+        {
+                if (!(stride > 0 && BLOCK_SIZE % stride == 0))
+                {
+                        error("Preview stride " + to_string(stride) + " is not a divisor of block size "
+                              + to_string(BLOCK_SIZE));
+                }
+        }
+        std::ranges::sort(res);
+        return res;
+}
 }
 
 template <std::size_t N, typename T, typename Color>
 Pixels<N, T, Color>::Pixels(
-        const std::array<int, N>& screen_size,
+        const std::array<int, N>& min,
+        const std::array<int, N>& max,
         const std::type_identity_t<Color>& background,
-        Notifier<N>* const notifier)
-        : screen_size_(screen_size),
+        Notifier<N>* const notifier,
+        const unsigned thread_count,
+        const std::span<const int> preview_strides)
+        : origin_(block_origin(min, BLOCK_SIZE)),
+          min_(subtract(min, origin_)),
+          max_(subtract(max, origin_)),
+          size_(region_size(min, max)),
           background_(background.max_n(0)),
-          notifier_(notifier)
+          notifier_(notifier),
+          notification_interval_(notifier_->pixel_notification_interval()),
+          preview_strides_(sort_preview_strides<BLOCK_SIZE>(preview_strides)),
+          block_count_(block_count(max_, BLOCK_SIZE)),
+          tile_buffers_(thread_count),
+          splat_buffers_(thread_count)
+{
+        ASSERT(thread_count > 0);
+}
+
+template <std::size_t N, typename T, typename Color>
+Pixels<N, T, Color>::Pixels(
+        const std::array<int, N>& screen_size,
+        const std::type_identity_t<Color>& background,
+        Notifier<N>* const notifier,
+        const unsigned thread_count,
+        const std::span<const int> preview_strides)
+        : Pixels(make_array_value<int, N>(0),
+                 screen_max(screen_size),
+                 background,
+                 notifier,
+                 thread_count,
+                 preview_strides)
+{
+}
+
+template <std::size_t N, typename T, typename Color>
+std::array<int, N> Pixels<N, T, Color>::to_region(const std::array<int, N>& pixel) const
 {
+        std::array<int, N> res;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                res[i] = pixel[i] - origin_[i];
+                ASSERT(res[i] >= min_[i] && res[i] <= max_[i]);
+        }
+        return res;
+}
+
+template <std::size_t N, typename T, typename Color>
+std::array<int, N> Pixels<N, T, Color>::to_screen(const std::array<int, N>& pixel) const
+{
+        std::array<int, N> res;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                res[i] = pixel[i] + origin_[i];
+        }
+        return res;
+}
+
+template <std::size_t N, typename T, typename Color>
+void Pixels<N, T, Color>::begin_tile(const unsigned thread_number, const std::vector<std::array<int, N>>& pixels)
+{
+        ASSERT(thread_number < tile_buffers_.size());
+
+        const RegionBounds<N> pixel_bounds = region_bounds(pixels);
+
+        RegionBounds<N> bounds{.min = to_region(pixel_bounds.min), .max = to_region(pixel_bounds.max)};
+
+        const int radius = filter_.integer_radius();
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                bounds.min[i] = std::max(min_[i], bounds.min[i] - radius);
+                bounds.max[i] = std::min(max_[i], bounds.max[i] + radius);
+        }
+
+        tile_buffers_[thread_number].init(bounds.min, bounds.max);
 }
 
 template <std::size_t N, typename T, typename Color>
@@ -71,7 +254,8 @@ void Pixels<N, T, Color>::add_samples(
         const std::array<int, N>& region_pixel,
         const std::array<int, N>& sample_pixel,
         const std::vector<numerical::Vector<N, T>>& points,
-        const std::vector<std::optional<Color>>& colors)
+        const std::vector<std::optional<Color>>& colors,
+        PixelType* const pixel) const
 {
         thread_local std::vector<T> weights;
 
@@ -80,27 +264,24 @@ void Pixels<N, T, Color>::add_samples(
         const auto color_samples = samples::create_color_samples<FILTER_SAMPLE_COUNT>(colors, weights);
         const auto background_samples = samples::create_background_samples<FILTER_SAMPLE_COUNT>(colors, weights);
 
-        const long long index = global_index_.compute(region_pixel);
-        Pixel<FILTER_SAMPLE_COUNT, Color>& pixel = pixels_[index];
-
-        const std::lock_guard lg(pixel_locks_[index]);
         if (color_samples)
         {
-                pixel.merge(*color_samples);
+                pixel->merge(*color_samples);
         }
         if (background_samples)
         {
-                pixel.merge(*background_samples);
+                pixel->merge(*background_samples);
         }
-        notifier_->pixel_set(region_pixel, pixel.color_rgb(background_));
 }
 
 template <std::size_t N, typename T, typename Color>
 void Pixels<N, T, Color>::add_samples(
+        const unsigned thread_number,
         const std::array<int, N>& pixel,
         const std::vector<numerical::Vector<N, T>>& points,
         const std::vector<std::optional<Color>>& colors)
 {
+        ASSERT(thread_number < tile_buffers_.size());
         ASSERT(points.size() == colors.size());
         ASSERT(!points.empty());
 
@@ -112,27 +293,392 @@ void Pixels<N, T, Color>::add_samples(
                 }
         }
 
+        TileBuffer<N, PixelType>& tile_buffer = tile_buffers_[thread_number];
+
+        const std::array<int, N> sample_pixel = to_region(pixel);
+
+        tile_buffer.set_sampled(sample_pixel);
+
         pixel_region_.traverse(
-                pixel,
+                sample_pixel,
                 [&](const std::array<int, N>& region_pixel)
                 {
-                        add_samples(region_pixel, pixel, points, colors);
+                        add_samples(region_pixel, sample_pixel, points, colors, &tile_buffer.pixel(region_pixel));
+                });
+}
+
+template <std::size_t N, typename T, typename Color>
+void Pixels<N, T, Color>::set_block_changed(const long long block_index)
+{
+        dirty_blocks_[0][block_index] = true;
+        dirty_blocks_[1][block_index] = true;
+
+        if (notification_interval_ && !notification_blocks_[block_index])
+        {
+                notification_blocks_[block_index] = true;
+                const std::lock_guard lg(notification_list_lock_);
+                notification_list_.push_back(block_index);
+        }
+}
+
+template <std::size_t N, typename T, typename Color>
+Pixels<N, T, Color>::Block& Pixels<N, T, Color>::block_data(const long long block_index)
+{
+        std::unique_ptr<Block>& block = blocks_[block_index];
+        if (block)
+        {
+                return *block;
+        }
+
+        block = std::make_unique<Block>();
+
+        std::unique_ptr<BackgroundBlock>& background_block = background_blocks_[block_index];
+        if (background_block)
+        {
+                for (std::size_t i = 0; i < BLOCK_PIXEL_COUNT; ++i)
+                {
+                        if (!background_block->samples[i].empty())
+                        {
+                                block->pixels[i].merge(background_block->samples[i]);
+                        }
+                }
+                block->sampled = background_block->sampled;
+                background_block.reset();
+        }
+
+        return *block;
+}
+
+template <std::size_t N, typename T, typename Color>
+void Pixels<N, T, Color>::merge_background_block(
+        const long long block_index,
+        const std::array<int, N>& min,
+        const std::array<int, N>& max,
+        const TileBuffer<N, PixelType>& tile_buffer)
+{
+        std::unique_ptr<BackgroundBlock>& background_block = background_blocks_[block_index];
+        if (!background_block)
+        {
+                background_block = std::make_unique<BackgroundBlock>();
+        }
+
+        traverse_region(
+                min, max,
+                [&](const std::array<int, N>& p)
+                {
+                        const long long index = block_pixel_index(p);
+                        const auto& tile_samples = tile_buffer.pixel(p).background_samples();
+                        if (!tile_samples.empty())
+                        {
+                                auto& samples = background_block->samples[index];
+                                samples = samples::merge_samples(samples, tile_samples);
+                        }
+                        if (tile_buffer.sampled(p))
+                        {
+                                background_block->sampled[index] = true;
+                        }
+                });
+}
+
+template <std::size_t N, typename T, typename Color>
+void Pixels<N, T, Color>::merge_block(
+        const std::array<int, N>& block,
+        const TileBuffer<N, PixelType>& tile_buffer)
+{
+        std::array<int, N> min;
+        std::array<int, N> max;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                min[i] = std::max(tile_buffer.min()[i], block[i] * BLOCK_SIZE);
+                max[i] = std::min(tile_buffer.max()[i], block[i] * BLOCK_SIZE + BLOCK_SIZE - 1);
+        }
+
+        bool color_samples = false;
+        traverse_region(
+                min, max,
+                [&](const std::array<int, N>& p)
+                {
+                        color_samples = color_samples || tile_buffer.pixel(p).has_color_samples();
+                });
+
+        const long long block_index = block_index_.compute(block);
+
+        const std::lock_guard lg(block_locks_[block_index]);
+
+        set_block_changed(block_index);
+
+        if (!color_samples && !blocks_[block_index])
+        {
+                merge_background_block(block_index, min, max, tile_buffer);
+                return;
+        }
+
+        Block& data = block_data(block_index);
+
+        traverse_region(
+                min, max,
+                [&](const std::array<int, N>& p)
+                {
+                        const long long index = block_pixel_index(p);
+                        const PixelType& tile_pixel = tile_buffer.pixel(p);
+                        if (!tile_pixel.empty())
+                        {
+                                data.pixels[index].merge(tile_pixel);
+                        }
+                        if (tile_buffer.sampled(p))
+                        {
+                                data.sampled[index] = true;
+                        }
+                });
+}
+
+template <std::size_t N, typename T, typename Color>
+void Pixels<N, T, Color>::end_tile(const unsigned thread_number)
+{
+        ASSERT(thread_number < tile_buffers_.size());
+
+        const TileBuffer<N, PixelType>& tile_buffer = tile_buffers_[thread_number];
+
+        std::array<int, N> min;
+        std::array<int, N> max;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                min[i] = tile_buffer.min()[i] / BLOCK_SIZE;
+                max[i] = tile_buffer.max()[i] / BLOCK_SIZE;
+        }
+
+        traverse_region(
+                min, max,
+                [&](const std::array<int, N>& block)
+                {
+                        merge_block(block, tile_buffer);
                 });
+
+        notify_pixels();
+}
+
+template <std::size_t N, typename T, typename Color>
+void Pixels<N, T, Color>::add_splat(
+        const unsigned thread_number,
+        const numerical::Vector<N, T>& screen_point,
+        const Color& color)
+{
+        ASSERT(thread_number < splat_buffers_.size());
+
+        if (!color.is_finite())
+        {
+                LOG("Not finite splat color " + to_string(color));
+                return;
+        }
+
+        std::array<int, N> pixel;
+        std::array<int, N> block;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                const T p = std::floor(screen_point[i]) - origin_[i];
+                if (!(p >= min_[i] && p <= max_[i]))
+                {
+                        return;
+                }
+                pixel[i] = p;
+                block[i] = pixel[i] / BLOCK_SIZE;
+        }
+
+        splat_buffers_[thread_number].add(block_index_.compute(block), block_pixel_index(pixel), color);
+}
+
+template <std::size_t N, typename T, typename Color>
+void Pixels<N, T, Color>::merge_block_splats(
+        const long long block_index,
+        const std::span<const typename SplatBuffer<Color>::Splat> splats)
+{
+        const std::lock_guard lg(block_locks_[block_index]);
+
+        set_block_changed(block_index);
+
+        Block& data = block_data(block_index);
+        if (!data.splats)
+        {
+                data.splats = std::make_unique<std::array<Color, BLOCK_PIXEL_COUNT>>();
+                data.splats->fill(Color(0));
+        }
+
+        for (const auto& splat : splats)
+        {
+                ASSERT(splat.block == block_index);
+                (*data.splats)[splat.pixel] += splat.color;
+        }
+}
+
+template <std::size_t N, typename T, typename Color>
+void Pixels<N, T, Color>::merge_splats(const unsigned thread_number, const long long light_path_count)
+{
+        ASSERT(thread_number < splat_buffers_.size());
+        ASSERT(light_path_count >= 0);
+
+        SplatBuffer<Color>& splat_buffer = splat_buffers_[thread_number];
+
+        const auto splats = splat_buffer.sort();
+        auto begin = splats.begin();
+        while (begin != splats.end())
+        {
+                const long long block_index = begin->block;
+                const auto end = std::find_if(
+                        begin, splats.end(),
+                        [&](const auto& splat)
+                        {
+                                return splat.block != block_index;
+                        });
+                merge_block_splats(block_index, {begin, end});
+                begin = end;
+        }
+        splat_buffer.clear();
+
+        splat_path_count_.fetch_add(light_path_count, std::memory_order_relaxed);
+
+        notify_pixels();
 }
 
 template <std::size_t N, typename T, typename Color>
-void Pixels<N, T, Color>::images(image::Image<N>* const image_rgb, image::Image<N>* const image_rgba) const
+numerical::Vector<3, float> Pixels<N, T, Color>::splat_rgb(
+        const Block& block,
+        const long long index,
+        const T scale) const
 {
-        constexpr std::size_t RGB_PIXEL_SIZE = 3 * sizeof(float);
-        constexpr std::size_t RGBA_PIXEL_SIZE = 4 * sizeof(float);
+        if (!block.splats)
+        {
+                return numerical::Vector<3, float>(0);
+        }
+        return ((*block.splats)[index] * scale).rgb32();
+}
 
-        image_rgb->color_format = image::ColorFormat::R32G32B32;
-        image_rgb->size = screen_size_;
-        image_rgb->pixels.resize(RGB_PIXEL_SIZE * pixels_.size());
+template <std::size_t N, typename T, typename Color>
+RegionBounds<N> Pixels<N, T, Color>::block_region(const long long block_index) const
+{
+        const std::array<int, N> block = block_coordinates(block_index_, block_index);
 
-        image_rgba->color_format = image::ColorFormat::R32G32B32A32_PREMULTIPLIED;
-        image_rgba->size = screen_size_;
-        image_rgba->pixels.resize(RGBA_PIXEL_SIZE * pixels_.size());
+        RegionBounds<N> res;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                res.min[i] = std::max(min_[i], block[i] * BLOCK_SIZE);
+                res.max[i] = std::min(max_[i], block[i] * BLOCK_SIZE + BLOCK_SIZE - 1);
+        }
+        return res;
+}
+
+template <std::size_t N, typename T, typename Color>
+long long Pixels<N, T, Color>::block_pixel_index(const std::array<int, N>& pixel) const
+{
+        std::array<int, N> p;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                p[i] = pixel[i] % BLOCK_SIZE;
+        }
+        return block_pixel_index_.compute(p);
+}
+
+template <std::size_t N, typename T, typename Color>
+long long Pixels<N, T, Color>::notification_pixel_index(const Block& block, const std::array<int, N>& pixel) const
+{
+        const long long index = block_pixel_index(pixel);
+        if (block.sampled[index])
+        {
+                return index;
+        }
+
+        // The pixel is not sampled yet, its color is from the stride grid
+        // pixel even if the pixel has samples of the neighboring pixels.
+        // The block size is divisible by the strides and the origin
+        // is divisible by the block size, so the rounded pixels
+        // are in the same block and on the screen stride grid
+        for (const int stride : preview_strides_)
+        {
+                std::array<int, N> p;
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                        p[i] = pixel[i] - pixel[i] % stride;
+                }
+                const long long preview_index = block_pixel_index(p);
+                if (block.sampled[preview_index])
+                {
+                        return preview_index;
+                }
+        }
+
+        return index;
+}
+
+template <std::size_t N, typename T, typename Color>
+void Pixels<N, T, Color>::notify_pixels()
+{
+        if (!notification_interval_ || Clock::now() < notification_time_.load(std::memory_order_relaxed))
+        {
+                return;
+        }
+
+        const std::unique_lock lock(notification_mutex_, std::try_to_lock);
+        if (!lock.owns_lock())
+        {
+                return;
+        }
+
+        notification_time_.store(Clock::now() + *notification_interval_, std::memory_order_relaxed);
+
+        thread_local std::vector<long long> blocks;
+        thread_local std::vector<numerical::Vector<3, float>> rgb;
+
+        const T scale = splat_scale<T>(splat_path_count_.load(std::memory_order_relaxed));
+
+        blocks.clear();
+        {
+                const std::lock_guard lg(notification_list_lock_);
+                std::swap(blocks, notification_list_);
+        }
+
+        for (const long long i : blocks)
+        {
+                const RegionBounds<N> region = block_region(i);
+                {
+                        const std::lock_guard lg(block_locks_[i]);
+                        if (!notification_blocks_[i])
+                        {
+                                continue;
+                        }
+                        notification_blocks_[i] = false;
+
+                        const Block* const block = blocks_[i].get();
+
+                        rgb.clear();
+                        traverse_region(
+                                region.min, region.max,
+                                [&](const std::array<int, N>& p)
+                                {
+                                        if (!block)
+                                        {
+                                                rgb.push_back(background_.color_rgb32());
+                                                return;
+                                        }
+                                        const long long index = notification_pixel_index(*block, p);
+                                        rgb.push_back(
+                                                block->pixels[index].color_rgb(background_)
+                                                + splat_rgb(*block, block_pixel_index(p), scale));
+                                });
+                }
+                notifier_->pixels_set(to_screen(region.min), to_screen(region.max), rgb);
+        }
+}
+
+template <std::size_t N, typename T, typename Color>
+void Pixels<N, T, Color>::update_block_images(const long long block_index, const bool notify)
+{
+        const RegionBounds<N> region = block_region(block_index);
+
+        thread_local std::vector<numerical::Vector<3, float>> notification_rgb;
+        notification_rgb.clear();
+
+        const Block* const block = blocks_[block_index].get();
+
+        const T scale = splat_scale<T>(images_splat_path_count_);
 
         numerical::Vector<3, float> rgb;
         numerical::Vector<4, float> rgba;
@@ -140,29 +686,136 @@ void Pixels<N, T, Color>::images(image::Image<N>* const image_rgb, image::Image<
         static_assert(sizeof(rgb) == RGB_PIXEL_SIZE);
         static_assert(sizeof(rgba) == RGBA_PIXEL_SIZE);
 
-        std::byte* ptr_rgb = image_rgb->pixels.data();
-        std::byte* ptr_rgba = image_rgba->pixels.data();
-        for (std::size_t i = 0; i < pixels_.size(); ++i)
+        if (!block)
         {
+                rgb = background_.color_rgb32();
+                rgba = numerical::Vector<4, float>(0);
+        }
+
+        traverse_region(
+                region.min, region.max,
+                [&](const std::array<int, N>& p)
                 {
-                        const Pixel<FILTER_SAMPLE_COUNT, Color>& pixel = pixels_[i];
-                        const std::lock_guard lg(pixel_locks_[i]);
-                        rgb = pixel.color_rgb(background_);
-                        rgba = pixel.color_rgba(background_);
+                        const long long index = image_index_.compute(subtract(p, min_));
+
+                        if (block)
+                        {
+                                const long long pixel_index = block_pixel_index(p);
+                                const PixelType& pixel = block->pixels[pixel_index];
+                                rgb = pixel.color_rgb(background_);
+                                rgba = pixel.color_rgba(background_);
+                                if (block->splats)
+                                {
+                                        const numerical::Vector<3, float> splat = splat_rgb(*block, pixel_index, scale);
+                                        rgb += splat;
+                                        rgba[0] += splat[0];
+                                        rgba[1] += splat[1];
+                                        rgba[2] += splat[2];
+                                }
+                        }
+
+                        ASSERT(rgba[3] < 1 || !is_finite(rgba) || !is_finite(rgb)
+                               || (rgb[0] == rgba[0] && rgb[1] == rgba[1] && rgb[2] == rgba[2]));
+                        ASSERT(rgba[3] > 0 || !is_finite(rgb) || (block && block->splats)
+                               || (rgb == background_.color_rgb32()));
+
+                        std::memcpy(image_rgb_->pixels.data() + index * RGB_PIXEL_SIZE, &rgb, RGB_PIXEL_SIZE);
+                        std::memcpy(image_rgba_->pixels.data() + index * RGBA_PIXEL_SIZE, &rgba, RGBA_PIXEL_SIZE);
+
+                        if (notify)
+                        {
+                                notification_rgb.push_back(rgb);
+                        }
+                });
+
+        if (notify)
+        {
+                notification_blocks_[block_index] = false;
+                notifier_->pixels_set(to_screen(region.min), to_screen(region.max), notification_rgb);
+        }
+}
+
+template <std::size_t N, typename T, typename Color>
+void Pixels<N, T, Color>::begin_images(image::Image<N>* const image_rgb, image::Image<N>* const image_rgba)
+{
+        ASSERT(image_rgb && image_rgba);
+        ASSERT(!image_rgb_ && !image_rgba_);
+
+        const auto init = [&](image::Image<N>* const image, const image::ColorFormat format, const std::size_t size)
+        {
+                const std::size_t byte_count = size * image_index_.count();
+                if (image->color_format == format && image->size == size_ && image->pixels.size() == byte_count)
+                {
+                        return false;
                 }
+                image->color_format = format;
+                image->size = size_;
+                image->pixels.resize(byte_count);
+                return true;
+        };
+
+        const bool init_rgb = init(image_rgb, image::ColorFormat::R32G32B32, RGB_PIXEL_SIZE);
+        const bool init_rgba = init(image_rgba, image::ColorFormat::R32G32B32A32_PREMULTIPLIED, RGBA_PIXEL_SIZE);
+        if (init_rgb || init_rgba)
+        {
+                std::ranges::fill(dirty_blocks_[image_buffer_], true);
+        }
+
+        image_rgb_ = image_rgb;
+        image_rgba_ = image_rgba;
+
+        images_splat_path_count_ = splat_path_count_.load(std::memory_order_relaxed);
+}
+
+template <std::size_t N, typename T, typename Color>
+void Pixels<N, T, Color>::update_images(const unsigned thread_number)
+{
+        const std::size_t thread_count = tile_buffers_.size();
+
+        ASSERT(thread_number < thread_count);
+        ASSERT(image_rgb_ && image_rgba_);
 
-                ASSERT(rgba[3] < 1 || !is_finite(rgba) || !is_finite(rgb)
-                       || (rgb[0] == rgba[0] && rgb[1] == rgba[1] && rgb[2] == rgba[2]));
-                ASSERT(rgba[3] > 0 || !is_finite(rgb) || (rgb == background_.color_rgb32()));
+        std::vector<unsigned char>& dirty_blocks = dirty_blocks_[image_buffer_];
 
-                std::memcpy(ptr_rgb, &rgb, RGB_PIXEL_SIZE);
-                ptr_rgb += RGB_PIXEL_SIZE;
+        // The splat scale is common to all blocks, the blocks
+        // with splats change when the scale changes
+        const bool splats_changed = images_splat_path_count_ != image_splat_path_counts_[image_buffer_];
 
-                std::memcpy(ptr_rgba, &rgba, RGBA_PIXEL_SIZE);
-                ptr_rgba += RGBA_PIXEL_SIZE;
+        for (std::size_t i = thread_number; i < dirty_blocks.size(); i += thread_count)
+        {
+                const bool splats = splats_changed && blocks_[i] && blocks_[i]->splats;
+                if (dirty_blocks[i] || splats)
+                {
+                        update_block_images(i, notification_blocks_[i] || (notification_interval_ && splats));
+                        dirty_blocks[i] = false;
+                }
         }
-        ASSERT(ptr_rgb == image_rgb->pixels.data() + image_rgb->pixels.size());
-        ASSERT(ptr_rgba == image_rgba->pixels.data() + image_rgba->pixels.size());
+}
+
+template <std::size_t N, typename T, typename Color>
+void Pixels<N, T, Color>::end_images()
+{
+        ASSERT(image_rgb_ && image_rgba_);
+
+        image_rgb_ = nullptr;
+        image_rgba_ = nullptr;
+        image_splat_path_counts_[image_buffer_] = images_splat_path_count_;
+        image_buffer_ = 1 - image_buffer_;
+
+        // The notifications of the changed blocks
+        // are sent by update_images
+        notification_list_.clear();
+}
+
+template <std::size_t N, typename T, typename Color>
+long long Pixels<N, T, Color>::pixel_block_count() const
+{
+        return std::ranges::count_if(
+                blocks_,
+                [](const std::unique_ptr<Block>& block)
+                {
+                        return static_cast<bool>(block);
+                });
 }
 
 #define TEMPLATE_N_T_C(N, T, C) template class Pixels<(N) - 1, T, C>;
@@ -21,7 +21,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "pixel.h"
 #include "pixel_filter.h"
 #include "pixel_region.h"
+#include "splat_buffer.h"
+#include "tile_buffer.h"
 
+#include <src/com/arrays.h>
+#include <src/com/chrono.h>
+#include <src/com/exponent.h>
 #include <src/com/global_index.h>
 #include <src/com/spinlock.h>
 #include <src/image/image.h>
@@ -29,44 +34,194 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/painter/painter.h>
 
 #include <array>
+#include <atomic>
 #include <cstddef>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <type_traits>
 #include <vector>
 
 namespace ns::painter::pixels
 {
+// Each thread accumulates samples of a tile in its own buffer,
+// the buffer includes the filter apron around the tile.
+// The buffer is merged into the pixels when the tile is done,
+// locking blocks of pixels instead of single pixels.
+// The images are written directly to the back buffers of the painter
+// images. The two buffers alternate, so each buffer has its own flags
+// for the blocks changed since the buffer was last written.
+// The changed blocks are sent to the notifier not more often
+// than the notification interval and at the end of a pass.
+// The blocks are added to the notification list when they are
+// first changed after a notification, so a notification visits
+// only the changed blocks.
+// Only the blocks of the screen region are stored, and the images
+// have the size of the region. The block grid is aligned
+// to the screen coordinates, samples outside the region are ignored.
+// Pixels of a block are allocated when color samples or splats
+// are first added to the block. Until then the block has the
+// background color and stores only the background samples
+// of its pixels, so tiles that see only the background
+// do not allocate pixels.
+// For the preview, the notifications fill pixels that are not
+// sampled yet with the colors of the sampled pixels with coordinates
+// rounded down to the preview strides. A pixel is sampled when it is
+// the sample pixel of a tile, the filter apron of the neighboring
+// pixels does not make it sampled.
+// Light tracing samples are splatted to the pixels that contain
+// their screen points, without the filter. Each thread collects
+// its splats in its own buffer, the buffer is merged with one lock
+// per block. The pixel color is the filtered color plus the sum
+// of the splats divided by the number of the merged light paths.
 template <std::size_t N, typename T, typename Color>
 class Pixels final
 {
         static constexpr std::size_t FILTER_SAMPLE_COUNT = 4;
+        static constexpr int BLOCK_SIZE = (N <= 2) ? 16 : ((N == 3) ? 8 : 4);
+        static constexpr std::size_t BLOCK_PIXEL_COUNT = power<N>(static_cast<std::size_t>(BLOCK_SIZE));
+
+        using PixelType = Pixel<FILTER_SAMPLE_COUNT, Color>;
+
+        struct Block final
+        {
+                std::array<PixelType, BLOCK_PIXEL_COUNT> pixels;
+                std::array<bool, BLOCK_PIXEL_COUNT> sampled{};
+                std::unique_ptr<std::array<Color, BLOCK_PIXEL_COUNT>> splats;
+        };
+
+        struct BackgroundBlock final
+        {
+                std::array<samples::BackgroundSamples<FILTER_SAMPLE_COUNT, Color>, BLOCK_PIXEL_COUNT> samples;
+                std::array<bool, BLOCK_PIXEL_COUNT> sampled{};
+        };
 
         const PixelFilter<N, T> filter_;
-        const std::array<int, N> screen_size_;
-        const GlobalIndex<N, long long> global_index_{screen_size_};
-        const PixelRegion<N> pixel_region_{screen_size_, filter_.integer_radius()};
+        // The region min rounded down to the block size,
+        // the stored pixel coordinates are relative to it
+        const std::array<int, N> origin_;
+        const std::array<int, N> min_;
+        const std::array<int, N> max_;
+        const std::array<int, N> size_;
+        const GlobalIndex<N, long long> image_index_{size_};
+        const PixelRegion<N> pixel_region_{min_, max_, filter_.integer_radius()};
         const Background<Color> background_;
         Notifier<N>* const notifier_;
+        const std::optional<Clock::duration> notification_interval_;
+        const std::vector<int> preview_strides_;
+
+        const std::array<int, N> block_count_;
+        const GlobalIndex<N, long long> block_index_{block_count_};
+        const GlobalIndex<N, long long> block_pixel_index_{make_array_value<int, N>(BLOCK_SIZE)};
+        std::vector<std::unique_ptr<Block>> blocks_{static_cast<std::size_t>(block_index_.count())};
+        std::vector<std::unique_ptr<BackgroundBlock>> background_blocks_{blocks_.size()};
+        std::vector<Spinlock> block_locks_{blocks_.size()};
+        std::array<std::vector<unsigned char>, 2> dirty_blocks_{
+                std::vector<unsigned char>(block_locks_.size(), true),
+                std::vector<unsigned char>(block_locks_.size(), true)};
+        std::vector<unsigned char> notification_blocks_ = std::vector<unsigned char>(block_locks_.size(), false);
+        std::vector<long long> notification_list_;
+        Spinlock notification_list_lock_;
 
-        std::vector<Pixel<FILTER_SAMPLE_COUNT, Color>> pixels_{static_cast<std::size_t>(global_index_.count())};
-        mutable std::vector<Spinlock> pixel_locks_{pixels_.size()};
+        std::atomic<Clock::time_point> notification_time_{Clock::now()};
+        std::mutex notification_mutex_;
+
+        image::Image<N>* image_rgb_ = nullptr;
+        image::Image<N>* image_rgba_ = nullptr;
+        int image_buffer_ = 0;
+
+        std::vector<TileBuffer<N, PixelType>> tile_buffers_;
+
+        std::vector<SplatBuffer<Color>> splat_buffers_;
+        std::atomic<long long> splat_path_count_ = 0;
+        long long images_splat_path_count_ = 0;
+        std::array<long long, 2> image_splat_path_counts_{};
 
         void add_samples(
                 const std::array<int, N>& region_pixel,
                 const std::array<int, N>& sample_pixel,
                 const std::vector<numerical::Vector<N, T>>& points,
-                const std::vector<std::optional<Color>>& colors);
+                const std::vector<std::optional<Color>>& colors,
+                PixelType* pixel) const;
+
+        [[nodiscard]] Block& block_data(long long block_index);
+
+        void merge_background_block(
+                long long block_index,
+                const std::array<int, N>& min,
+                const std::array<int, N>& max,
+                const TileBuffer<N, PixelType>& tile_buffer);
+
+        void merge_block(
+                const std::array<int, N>& block,
+                const TileBuffer<N, PixelType>& tile_buffer);
+
+        [[nodiscard]] std::array<int, N> to_region(const std::array<int, N>& pixel) const;
+
+        [[nodiscard]] std::array<int, N> to_screen(const std::array<int, N>& pixel) const;
+
+        [[nodiscard]] RegionBounds<N> block_region(long long block_index) const;
+
+        [[nodiscard]] long long block_pixel_index(const std::array<int, N>& pixel) const;
+
+        [[nodiscard]] long long notification_pixel_index(const Block& block, const std::array<int, N>& pixel) const;
+
+        void set_block_changed(long long block_index);
+
+        void merge_block_splats(long long block_index, std::span<const typename SplatBuffer<Color>::Splat> splats);
+
+        [[nodiscard]] numerical::Vector<3, float> splat_rgb(const Block& block, long long index, T scale) const;
+
+        void update_block_images(long long block_index, bool notify);
+
+        void notify_pixels();
 
 public:
+        // The region of the screen from min to max inclusive
+        Pixels(const std::array<int, N>& min,
+               const std::array<int, N>& max,
+               const std::type_identity_t<Color>& background,
+               Notifier<N>* notifier,
+               unsigned thread_count,
+               std::span<const int> preview_strides);
+
         Pixels(const std::array<int, N>& screen_size,
                const std::type_identity_t<Color>& background,
-               Notifier<N>* notifier);
+               Notifier<N>* notifier,
+               unsigned thread_count,
+               std::span<const int> preview_strides);
+
+        void begin_tile(unsigned thread_number, const std::vector<std::array<int, N>>& pixels);
 
         void add_samples(
+                unsigned thread_number,
                 const std::array<int, N>& pixel,
                 const std::vector<numerical::Vector<N, T>>& points,
                 const std::vector<std::optional<Color>>& colors);
 
-        void images(image::Image<N>* image_rgb, image::Image<N>* image_rgba) const;
+        void end_tile(unsigned thread_number);
+
+        // If the screen point is not inside the screen region,
+        // then the splat is ignored
+        void add_splat(unsigned thread_number, const numerical::Vector<N, T>& screen_point, const Color& color);
+
+        // The splats added by the thread after the previous merge
+        // are the samples of the specified number of light paths
+        void merge_splats(unsigned thread_number, long long light_path_count);
+
+        // The back buffer images of the painter images,
+        // the buffers must alternate between calls
+        void begin_images(image::Image<N>* image_rgb, image::Image<N>* image_rgba);
+
+        // Called by all threads between begin_images and end_images,
+        // must not be called concurrently with end_tile and merge_splats
+        void update_images(unsigned thread_number);
+
+        void end_images();
+
+        // The number of blocks with allocated pixels,
+        // must not be called concurrently with end_tile and merge_splats
+        [[nodiscard]] long long pixel_block_count() const;
 };
 }
@@ -0,0 +1,64 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace ns::painter::pixels
+{
+template <typename Color>
+class SplatBuffer final
+{
+public:
+        struct Splat final
+        {
+                long long block;
+                int pixel;
+                Color color;
+        };
+
+private:
+        std::vector<Splat> splats_;
+
+public:
+        void add(const long long block, const int pixel, const Color& color)
+        {
+                splats_.push_back({.block = block, .pixel = pixel, .color = color});
+        }
+
+        // The splats sorted by the blocks
+        [[nodiscard]] std::span<const Splat> sort()
+        {
+                std::ranges::sort(
+                        splats_,
+                        [](const Splat& a, const Splat& b)
+                        {
+                                return a.block < b.block;
+                        });
+                return splats_;
+        }
+
+        void clear()
+        {
+                splats_.clear();
+        }
+};
+}
@@ -0,0 +1,214 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <src/color/color.h>
+#include <src/com/arrays.h>
+#include <src/com/error.h>
+#include <src/com/print.h>
+#include <src/com/random/pcg.h>
+#include <src/image/image.h>
+#include <src/numerical/vector.h>
+#include <src/painter/painter.h>
+#include <src/painter/painting/paintbrush.h>
+#include <src/painter/pixels/pixels.h>
+#include <src/test/test.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace ns::painter::pixels
+{
+namespace
+{
+constexpr int PAINTBRUSH_WIDTH = 20;
+constexpr int SAMPLES_PER_PIXEL = 4;
+constexpr int PASS_COUNT = 2;
+
+template <std::size_t N>
+class TestNotifier final : public Notifier<N>
+{
+        [[nodiscard]] std::optional<std::chrono::milliseconds> pixel_notification_interval() const override
+        {
+                return std::nullopt;
+        }
+
+        void thread_busy(unsigned, const std::array<int, N>&, const std::array<int, N>&) override
+        {
+        }
+
+        void thread_free(unsigned) override
+        {
+        }
+
+        void pixels_set(
+                const std::array<int, N>&,
+                const std::array<int, N>&,
+                std::span<const numerical::Vector<3, float>>) override
+        {
+        }
+
+        Images<N>* images(long long) override
+        {
+                error("Images are not supported");
+        }
+
+        void pass_done(long long) override
+        {
+        }
+
+        void error_message(const std::string& msg) override
+        {
+                error(msg);
+        }
+};
+
+template <std::size_t N>
+[[nodiscard]] bool inside(const std::array<int, N>& pixel, const int min, const int max)
+{
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                if (!(pixel[i] >= min && pixel[i] <= max))
+                {
+                        return false;
+                }
+        }
+        return true;
+}
+
+template <std::size_t N, typename T, typename Color>
+void paint(
+        const int object_min,
+        const int object_max,
+        const Color& object_color,
+        painting::Paintbrush<N>* const paintbrush,
+        Pixels<N, T, Color>* const pixels)
+{
+        PCG engine(N);
+        std::uniform_real_distribution<T> urd(0, 1);
+
+        std::vector<numerical::Vector<N, T>> points(SAMPLES_PER_PIXEL);
+        std::vector<std::optional<Color>> colors(SAMPLES_PER_PIXEL);
+        std::vector<std::array<int, N>> tile;
+
+        while (paintbrush->next_tile(&tile))
+        {
+                pixels->begin_tile(0, tile);
+
+                for (const std::array<int, N>& pixel : tile)
+                {
+                        const bool object = inside(pixel, object_min, object_max);
+                        for (std::size_t i = 0; i < points.size(); ++i)
+                        {
+                                for (std::size_t n = 0; n < N; ++n)
+                                {
+                                        points[i][n] = urd(engine);
+                                }
+                                if (object)
+                                {
+                                        colors[i] = object_color;
+                                }
+                                else
+                                {
+                                        colors[i].reset();
+                                }
+                        }
+                        pixels->add_samples(0, pixel, points, colors);
+                }
+
+                pixels->end_tile(0);
+        }
+}
+
+void compare(const numerical::Vector<3, float>& a, const numerical::Vector<3, float>& b)
+{
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+                if (!(std::abs(a[i] - b[i]) <= 1e-5f * std::max(std::abs(a[i]), std::abs(b[i]))))
+                {
+                        error("Colors are not equal: " + to_string(a) + " and " + to_string(b));
+                }
+        }
+}
+
+template <std::size_t N>
+[[nodiscard]] numerical::Vector<3, float> pixel_rgb(const image::Image<N>& image, const std::array<int, N>& pixel)
+{
+        long long index = 0;
+        for (std::size_t i = N; i > 0; --i)
+        {
+                index = index * image.size[i - 1] + pixel[i - 1];
+        }
+        numerical::Vector<3, float> res;
+        std::memcpy(&res, image.pixels.data() + index * sizeof(res), sizeof(res));
+        return res;
+}
+
+// A small object inside one block is painted on the background.
+// Only the block of the object has pixels, the other blocks
+// have only the background samples
+template <std::size_t N, typename T, typename Color>
+void test_object(const int screen_size, const int object_min, const int object_max)
+{
+        const Color background(0.25);
+        const Color object(1);
+
+        TestNotifier<N> notifier;
+        Pixels<N, T, Color> pixels(
+                make_array_value<int, N>(screen_size), background, &notifier, 1,
+                painting::PAINTBRUSH_PREVIEW_STRIDES);
+        painting::Paintbrush<N> paintbrush(make_array_value<int, N>(screen_size), PAINTBRUSH_WIDTH, true);
+
+        for (int pass = 0; pass < PASS_COUNT; ++pass)
+        {
+                paint(object_min, object_max, object, &paintbrush, &pixels);
+                paintbrush.next_pass();
+        }
+
+        const long long block_count = pixels.pixel_block_count();
+        if (block_count != 1)
+        {
+                error("Pixel block count " + to_string(block_count) + " is not equal to 1");
+        }
+
+        image::Image<N> image_rgb;
+        image::Image<N> image_rgba;
+        pixels.begin_images(&image_rgb, &image_rgba);
+        pixels.update_images(0);
+        pixels.end_images();
+
+        compare(pixel_rgb(image_rgb, make_array_value<int, N>(screen_size - 1)), background.rgb32());
+        compare(pixel_rgb(image_rgb, make_array_value<int, N>((object_min + object_max) / 2)), object.rgb32());
+}
+
+void test()
+{
+        test_object<2, float, color::Color>(96, 36, 43);
+        test_object<3, double, color::Spectrum>(24, 2, 5);
+}
+
+TEST_SMALL("Painter Pixels", test)
+}
+}
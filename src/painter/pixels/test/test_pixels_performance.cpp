@@ -0,0 +1,184 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <src/color/color.h>
+#include <src/com/chrono.h>
+#include <src/com/error.h>
+#include <src/com/log.h>
+#include <src/com/print.h>
+#include <src/com/random/pcg.h>
+#include <src/com/thread.h>
+#include <src/com/type/name.h>
+#include <src/numerical/vector.h>
+#include <src/painter/painter.h>
+#include <src/painter/painting/paintbrush.h>
+#include <src/painter/pixels/pixels.h>
+#include <src/progress/progress.h>
+#include <src/test/test.h>
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns::painter::pixels
+{
+namespace
+{
+constexpr int THREAD_COUNT = 64;
+constexpr int PAINTBRUSH_WIDTH = 20;
+constexpr bool PAINTBRUSH_PREVIEW = true;
+constexpr int SAMPLES_PER_PIXEL = 16;
+constexpr int PASS_COUNT = 2;
+
+template <std::size_t N>
+class TestNotifier final : public Notifier<N>
+{
+        [[nodiscard]] std::optional<std::chrono::milliseconds> pixel_notification_interval() const override
+        {
+                return std::nullopt;
+        }
+
+        void thread_busy(unsigned, const std::array<int, N>&, const std::array<int, N>&) override
+        {
+        }
+
+        void thread_free(unsigned) override
+        {
+        }
+
+        void pixels_set(
+                const std::array<int, N>&,
+                const std::array<int, N>&,
+                std::span<const numerical::Vector<3, float>>) override
+        {
+        }
+
+        Images<N>* images(long long) override
+        {
+                error("Images are not supported");
+        }
+
+        void pass_done(long long) override
+        {
+        }
+
+        void error_message(const std::string& msg) override
+        {
+                error(msg);
+        }
+};
+
+template <std::size_t N, typename T, typename Color>
+void add_samples(
+        const unsigned thread_number,
+        painting::Paintbrush<N>* const paintbrush,
+        Pixels<N, T, Color>* const pixels)
+{
+        PCG engine(thread_number);
+        std::uniform_real_distribution<T> urd(0, 1);
+
+        std::vector<numerical::Vector<N, T>> points(SAMPLES_PER_PIXEL);
+        std::vector<std::optional<Color>> colors(SAMPLES_PER_PIXEL);
+        std::vector<std::array<int, N>> tile;
+
+        while (paintbrush->next_tile(&tile))
+        {
+                pixels->begin_tile(thread_number, tile);
+
+                for (const std::array<int, N>& pixel : tile)
+                {
+                        for (std::size_t i = 0; i < points.size(); ++i)
+                        {
+                                for (std::size_t n = 0; n < N; ++n)
+                                {
+                                        points[i][n] = urd(engine);
+                                }
+                                if (urd(engine) < T{0.1})
+                                {
+                                        colors[i].reset();
+                                }
+                                else
+                                {
+                                        colors[i] = Color(urd(engine));
+                                }
+                        }
+                        pixels->add_samples(thread_number, pixel, points, colors);
+                }
+
+                pixels->end_tile(thread_number);
+        }
+}
+
+template <std::size_t N, typename T, typename Color>
+void test(const std::array<int, N>& screen_size)
+{
+        TestNotifier<N> notifier;
+        Pixels<N, T, Color> pixels(
+                screen_size, Color(0), &notifier, THREAD_COUNT, painting::PAINTBRUSH_PREVIEW_STRIDES);
+        painting::Paintbrush<N> paintbrush(screen_size, PAINTBRUSH_WIDTH, PAINTBRUSH_PREVIEW);
+
+        long long pixel_count = 1;
+        for (const int size : screen_size)
+        {
+                pixel_count *= size;
+        }
+
+        const Clock::time_point start_time = Clock::now();
+
+        for (int pass = 0; pass < PASS_COUNT; ++pass)
+        {
+                std::vector<std::thread> threads;
+                threads.reserve(THREAD_COUNT);
+                for (int i = 0; i < THREAD_COUNT; ++i)
+                {
+                        threads.emplace_back(
+                                [&, i]
+                                {
+                                        add_samples(i, &paintbrush, &pixels);
+                                });
+                }
+                for (std::thread& thread : threads)
+                {
+                        join_thread(&thread);
+                }
+                paintbrush.next_pass();
+        }
+
+        const double duration = duration_from(start_time);
+
+        LOG("Pixels<" + to_string(N) + ", " + std::string(type_name<T>()) + ", " + std::string(Color::name())
+            + ">, screen " + to_string(screen_size) + ", " + to_string(THREAD_COUNT) + " threads: "
+            + to_string(std::llround(pixel_count * PASS_COUNT / duration)) + " pixels per second");
+}
+
+void test_performance(progress::Ratio* const /*progress*/)
+{
+        test<2, float, color::Color>({1000, 1000});
+        test<2, double, color::Spectrum>({500, 500});
+        test<3, float, color::Color>({100, 100, 100});
+}
+
+TEST_PERFORMANCE("Painter Pixels", test_performance)
+}
+}
@@ -0,0 +1,100 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <src/com/error.h>
+#include <src/com/global_index.h>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace ns::painter::pixels
+{
+template <std::size_t N, typename Pixel>
+class TileBuffer final
+{
+        std::array<int, N> min_;
+        std::array<int, N> max_;
+        GlobalIndex<N, long long> global_index_;
+        std::vector<Pixel> pixels_;
+        std::vector<unsigned char> sampled_;
+
+        [[nodiscard]] long long index(const std::array<int, N>& pixel) const
+        {
+                std::array<int, N> p;
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                        ASSERT(pixel[i] >= min_[i] && pixel[i] <= max_[i]);
+                        p[i] = pixel[i] - min_[i];
+                }
+                return global_index_.compute(p);
+        }
+
+public:
+        // min and max are inclusive
+        void init(const std::array<int, N>& min, const std::array<int, N>& max)
+        {
+                std::array<int, N> size;
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                        ASSERT(min[i] <= max[i]);
+                        size[i] = max[i] - min[i] + 1;
+                }
+
+                min_ = min;
+                max_ = max;
+                global_index_ = GlobalIndex<N, long long>(size);
+
+                pixels_.clear();
+                pixels_.resize(global_index_.count());
+                sampled_.clear();
+                sampled_.resize(global_index_.count(), false);
+        }
+
+        [[nodiscard]] const std::array<int, N>& min() const
+        {
+                return min_;
+        }
+
+        [[nodiscard]] const std::array<int, N>& max() const
+        {
+                return max_;
+        }
+
+        [[nodiscard]] Pixel& pixel(const std::array<int, N>& pixel)
+        {
+                return pixels_[index(pixel)];
+        }
+
+        [[nodiscard]] const Pixel& pixel(const std::array<int, N>& pixel) const
+        {
+                return pixels_[index(pixel)];
+        }
+
+        void set_sampled(const std::array<int, N>& pixel)
+        {
+                sampled_[index(pixel)] = true;
+        }
+
+        [[nodiscard]] bool sampled(const std::array<int, N>& pixel) const
+        {
+                return sampled_[index(pixel)];
+        }
+};
+}
@@ -27,6 +27,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <array>
 #include <cstddef>
+#include <optional>
 #include <type_traits>
 
 namespace ns::painter::projectors
@@ -50,6 +51,17 @@ std::array<numerical::Vector<N, T>, N - 1> make_screen_axes(
         }
         return res;
 }
+
+template <std::size_t N, typename T>
+T screen_pdf(const std::array<numerical::Vector<N, T>, N - 1>& screen_axes)
+{
+        T pixel_area = 1;
+        for (const numerical::Vector<N, T>& axis : screen_axes)
+        {
+                pixel_area *= axis.norm();
+        }
+        return 1 / pixel_area;
+}
 }
 
 template <std::size_t N, typename T>
@@ -66,6 +78,31 @@ numerical::Ray<N, T> ParallelProjector<N, T>::ray(const numerical::Vector<N - 1,
         return numerical::Ray<N, T>(camera_org_ + screen_dir, camera_dir_);
 }
 
+template <std::size_t N, typename T>
+std::optional<ProjectorPoint<N, T>> ParallelProjector<N, T>::project(const numerical::Vector<N, T>& point) const
+{
+        const numerical::Vector<N, T> v = point - camera_org_;
+
+        const T distance = dot(v, camera_dir_);
+        if (!(distance > 0))
+        {
+                return std::nullopt;
+        }
+
+        ProjectorPoint<N, T> res;
+
+        for (std::size_t i = 0; i < N - 1; ++i)
+        {
+                res.screen_point[i] = dot(v, screen_axes_[i]) / screen_axes_[i].norm_squared() - screen_org_[i];
+        }
+
+        res.distance = distance;
+        res.dir = -camera_dir_;
+        res.pdf = pdf_;
+
+        return res;
+}
+
 template <std::size_t N, typename T>
 ParallelProjector<N, T>::ParallelProjector(
         const numerical::Vector<N, T>& camera_org,
@@ -77,7 +114,8 @@ ParallelProjector<N, T>::ParallelProjector(
           screen_axes_(make_screen_axes(screen_axes, units_per_pixel)),
           screen_org_(com::screen_org<T>(screen_size)),
           camera_org_(camera_org),
-          camera_dir_(camera_dir.normalized())
+          camera_dir_(camera_dir.normalized()),
+          pdf_(screen_pdf(screen_axes_))
 {
         com::check_orthogonality(camera_dir_, screen_axes_);
 }
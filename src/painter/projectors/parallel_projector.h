@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <array>
 #include <cstddef>
+#include <optional>
 #include <type_traits>
 
 namespace ns::painter::projectors
@@ -38,11 +39,14 @@ class ParallelProjector final : public Projector<N, T>
         numerical::Vector<N - 1, T> screen_org_;
         numerical::Vector<N, T> camera_org_;
         numerical::Vector<N, T> camera_dir_;
+        T pdf_;
 
         [[nodiscard]] const std::array<int, N - 1>& screen_size() const override;
 
         [[nodiscard]] numerical::Ray<N, T> ray(const numerical::Vector<N - 1, T>& point) const override;
 
+        [[nodiscard]] std::optional<ProjectorPoint<N, T>> project(const numerical::Vector<N, T>& point) const override;
+
 public:
         ParallelProjector(
                 const numerical::Vector<N, T>& camera_org,
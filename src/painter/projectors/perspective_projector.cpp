@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/com/constant.h>
 #include <src/com/conversion.h>
 #include <src/com/error.h>
+#include <src/com/exponent.h>
 #include <src/com/print.h>
 #include <src/numerical/ray.h>
 #include <src/numerical/vector.h>
@@ -30,6 +31,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <optional>
 #include <type_traits>
 
 namespace ns::painter::projectors
@@ -68,6 +70,35 @@ numerical::Ray<N, T> PerspectiveProjector<N, T>::ray(const numerical::Vector<N -
         return numerical::Ray<N, T>(camera_org_, camera_dir_ + screen_dir);
 }
 
+template <std::size_t N, typename T>
+std::optional<ProjectorPoint<N, T>> PerspectiveProjector<N, T>::project(const numerical::Vector<N, T>& point) const
+{
+        const numerical::Vector<N, T> v = point - camera_org_;
+
+        const T screen_distance = camera_dir_.norm();
+        const T z = dot(v, camera_dir_) / screen_distance;
+        if (!(z > 0))
+        {
+                return std::nullopt;
+        }
+
+        ProjectorPoint<N, T> res;
+
+        const T k = screen_distance / z;
+        for (std::size_t i = 0; i < N - 1; ++i)
+        {
+                res.screen_point[i] = k * dot(v, screen_axes_[i]) - screen_org_[i];
+        }
+
+        res.distance = v.norm();
+        res.dir = v / -res.distance;
+
+        // screen_distance^(N - 1) / (cos^N * distance^(N - 1))
+        res.pdf = power<N - 1>(screen_distance) * res.distance / power<N>(z);
+
+        return res;
+}
+
 template <std::size_t N, typename T>
 PerspectiveProjector<N, T>::PerspectiveProjector(
         const numerical::Vector<N, T>& camera_org,
@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <array>
 #include <cstddef>
+#include <optional>
 #include <type_traits>
 
 namespace ns::painter::projectors
@@ -43,6 +44,8 @@ class PerspectiveProjector final : public Projector<N, T>
 
         [[nodiscard]] numerical::Ray<N, T> ray(const numerical::Vector<N - 1, T>& point) const override;
 
+        [[nodiscard]] std::optional<ProjectorPoint<N, T>> project(const numerical::Vector<N, T>& point) const override;
+
 public:
         PerspectiveProjector(
                 const numerical::Vector<N, T>& camera_org,
@@ -30,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <optional>
 #include <type_traits>
 
 namespace ns::painter::projectors
@@ -85,6 +86,43 @@ numerical::Ray<N, T> SphericalProjector<N, T>::ray(const numerical::Vector<N - 1
         return numerical::Ray<N, T>(camera_org_, camera_dir_ * z + screen_dir);
 }
 
+template <std::size_t N, typename T>
+std::optional<ProjectorPoint<N, T>> SphericalProjector<N, T>::project(const numerical::Vector<N, T>& point) const
+{
+        const numerical::Vector<N, T> v = point - camera_org_;
+
+        const T distance = v.norm();
+        if (!(distance > 0))
+        {
+                return std::nullopt;
+        }
+
+        const numerical::Vector<N, T> dir = v / distance;
+
+        const T cosine = dot(dir, camera_dir_);
+        if (!(cosine > 0))
+        {
+                return std::nullopt;
+        }
+
+        ProjectorPoint<N, T> res;
+
+        const T radius = std::sqrt(square_radius_);
+        for (std::size_t i = 0; i < N - 1; ++i)
+        {
+                res.screen_point[i] = radius * dot(dir, screen_axes_[i]) - screen_org_[i];
+        }
+
+        res.distance = distance;
+        res.dir = -dir;
+
+        // the screen is the orthogonal projection of the hemisphere,
+        // radius^(N - 1) * cos / distance^(N - 1)
+        res.pdf = power<N - 1>(radius / distance) * cosine;
+
+        return res;
+}
+
 template <std::size_t N, typename T>
 SphericalProjector<N, T>::SphericalProjector(
         const numerical::Vector<N, T>& camera_org,
@@ -34,6 +34,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/painter/projectors/spherical_projector.h>
 #include <src/painter/shapes/hyperplane_parallelotope.h>
 #include <src/painter/shapes/parallelotope.h>
+#include <src/painter/shapes/shared.h>
 #include <src/progress/progress.h>
 #include <src/settings/instantiation.h>
 
@@ -42,6 +43,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <memory>
 #include <optional>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 namespace ns::painter::scenes
@@ -313,6 +315,7 @@ StorageScene<N, T, Color> create_cornell_box_scene(
         std::unique_ptr<const Shape<N, T, Color>>&& shape,
         const Color& light,
         const Color& background_light,
+        const std::optional<numerical::Vector<N + 1, std::type_identity_t<T>>>& clip_plane_equation,
         const std::array<int, N - 1>& screen_size,
         progress::Ratio* const progress)
 {
@@ -320,13 +323,20 @@ StorageScene<N, T, Color> create_cornell_box_scene(
 
         const auto [camera, center] = camera_and_center(shape->bounding_box());
 
+        if (clip_plane_equation)
+        {
+                shape = shapes::create_shared(
+                        std::shared_ptr<const Shape<N, T, Color>>(std::move(shape)), clip_plane_equation);
+        }
+
         return create_cornell_box_scene(
                 light, background_light, screen_size, camera, center, std::move(shape), progress);
 }
 
-#define TEMPLATE(N, T, C)                                                                                       \
-        template StorageScene<(N), T, C> create_cornell_box_scene(                                              \
-                std::unique_ptr<const Shape<(N), T, C>>&&, const C&, const C&, const std::array<int, (N) - 1>&, \
+#define TEMPLATE(N, T, C)                                                                             \
+        template StorageScene<(N), T, C> create_cornell_box_scene(                                    \
+                std::unique_ptr<const Shape<(N), T, C>>&&, const C&, const C&,                        \
+                const std::optional<numerical::Vector<(N) + 1, T>>&, const std::array<int, (N) - 1>&, \
                 progress::Ratio*);
 
 TEMPLATE_INSTANTIATION_N_T_C(TEMPLATE)
@@ -19,20 +19,25 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "storage.h"
 
+#include <src/numerical/vector.h>
 #include <src/painter/objects.h>
 #include <src/progress/progress.h>
 
 #include <array>
 #include <cstddef>
 #include <memory>
+#include <optional>
+#include <type_traits>
 
 namespace ns::painter::scenes
 {
+// The clip plane clips the shape, the box is not clipped
 template <std::size_t N, typename T, typename Color>
 StorageScene<N, T, Color> create_cornell_box_scene(
         std::unique_ptr<const Shape<N, T, Color>>&& shape,
         const Color& light,
         const Color& background_light,
+        const std::optional<numerical::Vector<N + 1, std::type_identity_t<T>>>& clip_plane_equation,
         const std::array<int, N - 1>& screen_size,
         progress::Ratio* progress);
 }
@@ -220,7 +220,9 @@ public:
                   light_sources_(std::move(light_sources)),
                   projector_(projector),
                   clip_polytope_(clip_plane_to_clip_polytope(clip_plane_equation)),
-                  bvh_(geometry::accelerators::bvh_objects(shapes_), progress)
+                  bvh_(
+                          geometry::accelerators::bvh_objects(shapes_), geometry::accelerators::BvhNodeFormat::FULL,
+                          progress)
         {
                 ASSERT(USE_CLIP_POLYTOPE == clip_polytope_.has_value());
         }
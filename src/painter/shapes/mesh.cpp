@@ -17,20 +17,25 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "mesh.h"
 
+#include "mesh/compact_facet.h"
 #include "mesh/data.h"
 #include "mesh/facet.h"
+#include "mesh/leaf_vertices.h"
 #include "mesh/material.h"
 
 #include <src/com/chrono.h>
+#include <src/com/enum.h>
 #include <src/com/error.h>
 #include <src/com/log.h>
 #include <src/com/memory_arena.h>
 #include <src/com/names.h>
 #include <src/com/print.h>
 #include <src/com/random/pcg.h>
+#include <src/com/type/limit.h>
 #include <src/com/type/name.h>
 #include <src/geometry/accelerators/bvh.h>
 #include <src/geometry/accelerators/bvh_object.h>
+#include <src/geometry/accelerators/bvh_report.h>
 #include <src/geometry/spatial/bounding_box.h>
 #include <src/geometry/spatial/parallelotope_aa.h>
 #include <src/geometry/spatial/ray_intersection.h>
@@ -40,6 +45,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/numerical/vector.h>
 #include <src/painter/objects.h>
 #include <src/progress/progress.h>
+#include <src/sampling/sphere_uniform.h>
 #include <src/settings/instantiation.h>
 #include <src/shading/ggx/brdf.h>
 #include <src/shading/ggx/metalness.h>
@@ -50,6 +56,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <functional>
 #include <memory>
 #include <optional>
+#include <random>
+#include <span>
 #include <tuple>
 #include <type_traits>
 #include <vector>
@@ -58,20 +66,36 @@ namespace ns::painter::shapes
 {
 namespace
 {
-template <std::size_t N, typename T, typename Color>
+constexpr int BVH_PROBE_RAY_COUNT = 10'000;
+
+// Facet is a pointer to the facet with the plane form
+// or a compact facet with its vertices
+template <std::size_t N, typename T, typename Color, typename Mesh, typename Facet>
 class SurfaceImpl final : public Surface<N, T, Color>
 {
-        const mesh::Mesh<N, T, Color>* mesh_;
-        const mesh::Facet<N, T>* facet_;
+        const Mesh* mesh_;
+        Facet facet_;
+
+        [[nodiscard]] const auto& facet() const
+        {
+                if constexpr (std::is_pointer_v<Facet>)
+                {
+                        return *facet_;
+                }
+                else
+                {
+                        return facet_;
+                }
+        }
 
         [[nodiscard]] shading::Colors<Color> surface_color(
                 const numerical::Vector<N, T>& point,
                 const mesh::Material<T, Color>& material) const
         {
-                if (facet_->has_texcoord() && material.image() >= 0)
+                if (facet().has_texcoord() && material.image() >= 0)
                 {
                         const numerical::Vector<3, float> rgb =
-                                mesh_->images[material.image()].color(facet_->texcoord(mesh_->texcoords, point));
+                                mesh_->images[material.image()].color(facet().texcoord(mesh_->texcoords, point));
                         const Color color = Color(rgb[0], rgb[1], rgb[2]);
                         return shading::ggx::compute_metalness(color, material.metalness());
                 }
@@ -82,18 +106,18 @@ class SurfaceImpl final : public Surface<N, T, Color>
 
         [[nodiscard]] numerical::Vector<N, T> point(const numerical::Ray<N, T>& ray, const T distance) const override
         {
-                return facet_->project(ray.point(distance));
+                return facet().project(ray.point(distance));
         }
 
         [[nodiscard]] numerical::Vector<N, T> geometric_normal(const numerical::Vector<N, T>& /*point*/) const override
         {
-                return facet_->geometric_normal();
+                return facet().geometric_normal();
         }
 
         [[nodiscard]] std::optional<numerical::Vector<N, T>> shading_normal(
                 const numerical::Vector<N, T>& point) const override
         {
-                return facet_->shading_normal(mesh_->normals, point);
+                return facet().shading_normal(mesh_->normals, point);
         }
 
         [[nodiscard]] const LightSource<N, T, Color>* light_source() const override
@@ -107,9 +131,9 @@ class SurfaceImpl final : public Surface<N, T, Color>
                 const numerical::Vector<N, T>& v,
                 const numerical::Vector<N, T>& l) const override
         {
-                ASSERT(facet_->material() >= 0);
+                ASSERT(facet().material() >= 0);
 
-                const mesh::Material<T, Color>& material = mesh_->materials[facet_->material()];
+                const mesh::Material<T, Color>& material = mesh_->materials[facet().material()];
 
                 return shading::ggx::brdf::f(material.roughness(), surface_color(point, material), n, v, l);
         }
@@ -120,9 +144,9 @@ class SurfaceImpl final : public Surface<N, T, Color>
                 const numerical::Vector<N, T>& v,
                 const numerical::Vector<N, T>& l) const override
         {
-                ASSERT(facet_->material() >= 0);
+                ASSERT(facet().material() >= 0);
 
-                const mesh::Material<T, Color>& material = mesh_->materials[facet_->material()];
+                const mesh::Material<T, Color>& material = mesh_->materials[facet().material()];
 
                 return shading::ggx::brdf::pdf(material.roughness(), n, v, l);
         }
@@ -133,9 +157,9 @@ class SurfaceImpl final : public Surface<N, T, Color>
                 const numerical::Vector<N, T>& n,
                 const numerical::Vector<N, T>& v) const override
         {
-                ASSERT(facet_->material() >= 0);
+                ASSERT(facet().material() >= 0);
 
-                const mesh::Material<T, Color>& material = mesh_->materials[facet_->material()];
+                const mesh::Material<T, Color>& material = mesh_->materials[facet().material()];
 
                 const shading::Sample<N, T, Color>& sample = shading::ggx::brdf::sample_f(
                         engine, material.roughness(), surface_color(point, material), n, v);
@@ -154,27 +178,27 @@ class SurfaceImpl final : public Surface<N, T, Color>
 
         [[nodiscard]] T alpha(const numerical::Vector<N, T>& /*point*/) const override
         {
-                ASSERT(facet_->material() >= 0);
+                ASSERT(facet().material() >= 0);
 
-                const mesh::Material<T, Color>& material = mesh_->materials[facet_->material()];
+                const mesh::Material<T, Color>& material = mesh_->materials[facet().material()];
 
                 return material.alpha();
         }
 
 public:
-        SurfaceImpl(const mesh::Mesh<N, T, Color>* const mesh, const mesh::Facet<N, T>* const facet)
+        SurfaceImpl(const Mesh* const mesh, const Facet& facet)
                 : mesh_(mesh),
                   facet_(facet)
         {
         }
 };
 
-template <std::size_t N, typename T, typename Color>
+template <std::size_t N, typename T, typename Color, typename Facet>
 [[nodiscard]] std::vector<geometry::accelerators::BvhObject<N, T>> bvh_objects(
-        const mesh::Mesh<N, T, Color>& mesh,
+        const mesh::Mesh<N, T, Color, Facet>& mesh,
         const std::vector<std::array<int, N>>& facet_vertex_indices)
 {
-        const std::vector<mesh::Facet<N, T>>& facets = mesh.facets;
+        const std::vector<Facet>& facets = mesh.facets;
         std::vector<geometry::accelerators::BvhObject<N, T>> res;
         res.reserve(facets.size());
         for (std::size_t i = 0; i < facets.size(); ++i)
@@ -187,10 +211,125 @@ template <std::size_t N, typename T, typename Color>
         return res;
 }
 
-template <std::size_t N, typename T, typename Color>
+template <std::size_t N, typename T>
+[[nodiscard]] std::optional<geometry::spatial::BoundingBox<N, T>> clip_bounds(
+        const std::optional<geometry::spatial::BoundingBox<N, T>>& bounds,
+        const geometry::spatial::BoundingBox<N, T>& clip)
+{
+        if (!bounds)
+        {
+                return std::nullopt;
+        }
+        const numerical::Vector<N, T> min = numerical::max(bounds->min(), clip.min());
+        const numerical::Vector<N, T> max = numerical::min(bounds->max(), clip.max());
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                if (min[i] > max[i])
+                {
+                        return std::nullopt;
+                }
+        }
+        return geometry::spatial::BoundingBox<N, T>(min, max);
+}
+
+template <std::size_t N, typename T>
+void merge_bounds(std::optional<geometry::spatial::BoundingBox<N, T>>* const bounds, const numerical::Vector<N, T>& p)
+{
+        if (*bounds)
+        {
+                (*bounds)->merge(p);
+        }
+        else
+        {
+                bounds->emplace(p);
+        }
+}
+
+// The bounds of the parts of the facet simplex on both sides of the plane
+// are computed from its vertices and the intersections of its edges with
+// the plane, then clipped by the bounds of the facet reference
+template <std::size_t N, typename T>
+[[nodiscard]] std::array<std::optional<geometry::spatial::BoundingBox<N, T>>, 2> split_facet(
+        const std::vector<numerical::Vector<N, T>>& vertices,
+        const std::array<int, N>& indices,
+        const geometry::spatial::BoundingBox<N, T>& bounds,
+        const unsigned axis,
+        const T position)
+{
+        std::array<std::optional<geometry::spatial::BoundingBox<N, T>>, 2> res;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                const numerical::Vector<N, T>& v = vertices[indices[i]];
+                if (v[axis] <= position)
+                {
+                        merge_bounds(&res[0], v);
+                }
+                if (v[axis] >= position)
+                {
+                        merge_bounds(&res[1], v);
+                }
+                for (std::size_t j = i + 1; j < N; ++j)
+                {
+                        const numerical::Vector<N, T>& w = vertices[indices[j]];
+                        if ((v[axis] < position && w[axis] > position) || (v[axis] > position && w[axis] < position))
+                        {
+                                const T t = (position - v[axis]) / (w[axis] - v[axis]);
+                                numerical::Vector<N, T> p = v + t * (w - v);
+                                p[axis] = position;
+                                merge_bounds(&res[0], p);
+                                merge_bounds(&res[1], p);
+                        }
+                }
+        }
+        return {clip_bounds(res[0], bounds), clip_bounds(res[1], bounds)};
+}
+
+[[nodiscard]] geometry::accelerators::BvhNodeFormat bvh_node_format(const MeshBvhNodes bvh_nodes)
+{
+        switch (bvh_nodes)
+        {
+        case MeshBvhNodes::FULL:
+                return geometry::accelerators::BvhNodeFormat::FULL;
+        case MeshBvhNodes::QUANTIZED:
+                return geometry::accelerators::BvhNodeFormat::QUANTIZED;
+        }
+        error("Unknown mesh BVH nodes " + to_string(enum_to_int(bvh_nodes)));
+}
+
+template <std::size_t N, typename T, typename Color, typename Facet>
+[[nodiscard]] geometry::accelerators::Bvh<N, T> create_bvh(
+        const mesh::Mesh<N, T, Color, Facet>& mesh,
+        const std::vector<std::array<int, N>>& facet_vertex_indices,
+        const MeshBvh bvh_type,
+        const MeshBvhNodes bvh_nodes,
+        progress::Ratio* const progress)
+{
+        const geometry::accelerators::BvhNodeFormat format = bvh_node_format(bvh_nodes);
+
+        switch (bvh_type)
+        {
+        case MeshBvh::OBJECT_SPLITS:
+                return geometry::accelerators::Bvh<N, T>(bvh_objects(mesh, facet_vertex_indices), format, progress);
+        case MeshBvh::SPATIAL_SPLITS:
+                return geometry::accelerators::Bvh<N, T>(
+                        bvh_objects(mesh, facet_vertex_indices),
+                        [&](const unsigned index, const geometry::spatial::BoundingBox<N, T>& bounds,
+                            const unsigned axis, const T position)
+                        {
+                                ASSERT(index < facet_vertex_indices.size());
+                                return split_facet(mesh.vertices, facet_vertex_indices[index], bounds, axis, position);
+                        },
+                        format, progress);
+        }
+        error("Unknown mesh BVH type " + to_string(enum_to_int(bvh_type)));
+}
+
+template <std::size_t N, typename T, typename Color, typename Facet>
 [[nodiscard]] geometry::accelerators::Bvh<N, T> create_bvh(
-        const mesh::Mesh<N, T, Color>& mesh,
+        const mesh::Mesh<N, T, Color, Facet>& mesh,
         const std::vector<std::array<int, N>>& facet_vertex_indices,
+        const MeshBvh bvh_type,
+        const MeshBvhNodes bvh_nodes,
         const bool write_log,
         progress::Ratio* const progress)
 {
@@ -199,24 +338,118 @@ template <std::size_t N, typename T, typename Color>
 
         const Clock::time_point start_time = Clock::now();
 
-        geometry::accelerators::Bvh<N, T> bvh(bvh_objects(mesh, facet_vertex_indices), progress);
+        geometry::accelerators::Bvh<N, T> bvh = create_bvh(mesh, facet_vertex_indices, bvh_type, bvh_nodes, progress);
 
         if (write_log)
         {
-                LOG("Painter mesh created, " + to_string_fixed(duration_from(start_time), 5) + " s");
+                LOG("Painter mesh created, " + to_string_fixed(duration_from(start_time), 5) + " s, SAH cost "
+                    + to_string_fixed(bvh.sah_cost(), 3) + ", facet references "
+                    + to_string(bvh.object_indices().size()) + "/" + to_string(mesh.facets.size()));
+                LOG(geometry::accelerators::bvh_report_text(bvh.report()));
         }
 
         return bvh;
 }
 
+// The facets and vertices of the mesh data are reordered
+// to the order of the BVH leaves, so the leaves refer to
+// consecutive facets and vertices of nearby facets are close
+template <std::size_t N, typename T, typename Color, typename Facet>
+[[nodiscard]] geometry::accelerators::Bvh<N, T> create_leaf_order_bvh(
+        mesh::MeshData<N, T, Color, Facet>* const mesh_data,
+        const MeshBvh bvh_type,
+        const MeshBvhNodes bvh_nodes,
+        const bool write_log,
+        progress::Ratio* const progress)
+{
+        geometry::accelerators::Bvh<N, T> bvh = create_bvh(
+                mesh_data->mesh, mesh_data->facet_vertex_indices, bvh_type, bvh_nodes, write_log, progress);
+
+        mesh::reorder_mesh_data(bvh.release_object_indices(), mesh_data);
+
+        return bvh;
+}
+
+// Rays from a sphere around the bounding box
+// to random points inside the box, the same rays
+// for the same box to compare build settings
+template <std::size_t N, typename T>
+[[nodiscard]] std::vector<numerical::Ray<N, T>> probe_rays(
+        const geometry::spatial::BoundingBox<N, T>& bounding_box,
+        const int count)
+{
+        PCG engine(0);
+        std::uniform_real_distribution<T> urd(0, 1);
+
+        const numerical::Vector<N, T> diagonal = bounding_box.diagonal();
+        const numerical::Vector<N, T> center = bounding_box.center();
+        const T radius = 2 * diagonal.norm();
+
+        std::vector<numerical::Ray<N, T>> res;
+        res.reserve(count);
+        for (int i = 0; i < count; ++i)
+        {
+                const numerical::Vector<N, T> org = center + radius * sampling::uniform_on_sphere<N, T>(engine);
+                numerical::Vector<N, T> point;
+                for (std::size_t n = 0; n < N; ++n)
+                {
+                        point[n] = bounding_box.min()[n] + urd(engine) * diagonal[n];
+                }
+                res.emplace_back(org, (point - org).normalized());
+        }
+        return res;
+}
+
+template <std::size_t N, typename T, typename ObjectIntersect>
+void log_bvh_traversal(const geometry::accelerators::Bvh<N, T>& bvh, const ObjectIntersect& object_intersect)
+{
+        const std::vector<numerical::Ray<N, T>> rays = probe_rays(bvh.bounding_box(), BVH_PROBE_RAY_COUNT);
+
+        const Clock::time_point start_time = Clock::now();
+
+        const geometry::accelerators::BvhCounters counters =
+                bvh.traversal(std::span(rays), Limits<T>::max(), object_intersect);
+
+        LOG(geometry::accelerators::bvh_counters_text(counters) + ", "
+            + to_string_fixed(duration_from(start_time), 5) + " s");
+}
+
+template <std::size_t N, typename T>
+[[nodiscard]] std::function<bool(const geometry::spatial::ShapeOverlap<geometry::spatial::ParallelotopeAA<N, T>>&)>
+        bounding_box_overlap_function(const geometry::spatial::BoundingBox<N, T>& bounding_box)
+{
+        auto root = std::make_shared<geometry::spatial::ParallelotopeAA<N, T>>(bounding_box.min(), bounding_box.max());
+        return [root = root, overlap_function = root->overlap_function()](
+                       const geometry::spatial::ShapeOverlap<geometry::spatial::ParallelotopeAA<N, T>>& p)
+        {
+                return overlap_function(p);
+        };
+}
+
 template <std::size_t N, typename T, typename Color>
 class Impl final : public Shape<N, T, Color>
 {
-        mesh::Mesh<N, T, Color> mesh_;
+        using Mesh = mesh::Mesh<N, T, Color, mesh::Facet<N, T>>;
+
         geometry::accelerators::Bvh<N, T> bvh_;
+        Mesh mesh_;
         geometry::spatial::BoundingBox<N, T> bounding_box_;
         T intersection_cost_;
 
+        [[nodiscard]] std::optional<std::tuple<T, const mesh::Facet<N, T>*>> intersect_facets(
+                const numerical::Ray<N, T>& ray,
+                const geometry::accelerators::BvhObjectRange& facets,
+                const T& max_distance) const
+        {
+                const std::tuple<T, const mesh::Facet<N, T>*> info =
+                        geometry::spatial::ray_intersection(mesh_.facets, facets, ray, max_distance);
+                if (std::get<1>(info))
+                {
+                        return info;
+                }
+                return std::nullopt;
+        }
+
         [[nodiscard]] T intersection_cost() const override
         {
                 return intersection_cost_;
@@ -235,23 +468,17 @@ class Impl final : public Shape<N, T, Color>
         {
                 const auto intersection = bvh_.intersect(
                         ray, max_distance,
-                        [facets = &mesh_.facets, &ray](const auto& indices, const auto& max)
-                                -> std::optional<std::tuple<T, const mesh::Facet<N, T>*>>
+                        [&](const geometry::accelerators::BvhObjectRange& facets, const T& max)
                         {
-                                const std::tuple<T, const mesh::Facet<N, T>*> info =
-                                        geometry::spatial::ray_intersection(*facets, indices, ray, max);
-                                if (std::get<1>(info))
-                                {
-                                        return info;
-                                }
-                                return std::nullopt;
+                                return intersect_facets(ray, facets, max);
                         });
                 if (!intersection)
                 {
                         return {0, nullptr};
                 }
                 const auto& [distance, facet] = *intersection;
-                return {distance, make_arena_ptr<SurfaceImpl<N, T, Color>>(&mesh_, facet)};
+                return {distance,
+                        make_arena_ptr<SurfaceImpl<N, T, Color, Mesh, const mesh::Facet<N, T>*>>(&mesh_, facet)};
         }
 
         [[nodiscard]] bool intersect_any(
@@ -261,9 +488,9 @@ class Impl final : public Shape<N, T, Color>
         {
                 return bvh_.intersect(
                         ray, max_distance,
-                        [facets = &mesh_.facets, &ray](const auto& indices, const auto& max) -> bool
+                        [&](const geometry::accelerators::BvhObjectRange& facets, const T& max) -> bool
                         {
-                                return geometry::spatial::ray_intersection_any(*facets, indices, ray, max);
+                                return geometry::spatial::ray_intersection_any(mesh_.facets, facets, ray, max);
                         });
         }
 
@@ -276,52 +503,244 @@ class Impl final : public Shape<N, T, Color>
                 bool(const geometry::spatial::ShapeOverlap<geometry::spatial::ParallelotopeAA<N, T>>&)>
                 overlap_function() const override
         {
-                auto root = std::make_shared<geometry::spatial::ParallelotopeAA<N, T>>(
-                        bounding_box_.min(), bounding_box_.max());
-                return [root = root, overlap_function = root->overlap_function()](
-                               const geometry::spatial::ShapeOverlap<geometry::spatial::ParallelotopeAA<N, T>>& p)
-                {
-                        return overlap_function(p);
-                };
+                return bounding_box_overlap_function(bounding_box_);
         }
 
-        Impl(mesh::MeshData<N, T, Color>&& mesh_data, const bool write_log, progress::Ratio* const progress)
-                : mesh_(std::move(mesh_data.mesh)),
-                  bvh_(create_bvh(mesh_, mesh_data.facet_vertex_indices, write_log, progress)),
+        Impl(mesh::MeshData<N, T, Color, mesh::Facet<N, T>>&& mesh_data,
+             const MeshBvh bvh_type,
+             const MeshBvhNodes bvh_nodes,
+             const bool write_log,
+             progress::Ratio* const progress)
+                : bvh_(create_leaf_order_bvh(&mesh_data, bvh_type, bvh_nodes, write_log, progress)),
+                  mesh_(std::move(mesh_data.mesh)),
                   bounding_box_(bvh_.bounding_box()),
-                  intersection_cost_(
-                          mesh_.facets.size()
-                          * std::remove_reference_t<decltype(mesh_.facets.front())>::intersection_cost())
+                  intersection_cost_(mesh_.facets.size() * mesh::Facet<N, T>::intersection_cost())
         {
+                if (write_log)
+                {
+                        log_bvh_traversal(
+                                bvh_,
+                                [&](const numerical::Ray<N, T>& ray,
+                                    const geometry::accelerators::BvhObjectRange& facets, const T& max)
+                                {
+                                        return intersect_facets(ray, facets, max);
+                                });
+                }
         }
 
 public:
         Impl(const std::vector<const model::mesh::MeshObject<N>*>& mesh_objects,
-             const std::optional<numerical::Vector<N + 1, T>>& clip_plane_equation,
+             const MeshBvh bvh_type,
+             const MeshBvhNodes bvh_nodes,
              const bool write_log,
              progress::Ratio* const progress)
-                : Impl(mesh::create_mesh_data<N, T, Color>(mesh_objects, clip_plane_equation, write_log),
+                : Impl(mesh::create_mesh_data<N, T, Color, mesh::Facet<N, T>>(mesh_objects, write_log),
+                       bvh_type,
+                       bvh_nodes,
                        write_log,
                        progress)
         {
         }
 };
+
+template <std::size_t N, typename T, typename Color>
+class CompactImpl final : public Shape<N, T, Color>
+{
+        using Mesh = mesh::Mesh<N, T, Color, mesh::CompactFacet<N, T>>;
+
+        geometry::accelerators::Bvh<N, T> bvh_;
+        Mesh mesh_;
+        mesh::LeafVertices<N> leaf_vertices_;
+        geometry::spatial::BoundingBox<N, T> bounding_box_;
+        T intersection_cost_;
+
+        [[nodiscard]] std::optional<std::tuple<T, unsigned>> intersect_facets(
+                const numerical::Ray<N, T>& ray,
+                const geometry::accelerators::BvhObjectRange& facets,
+                const T& max_distance) const
+        {
+                T min_distance = max_distance;
+                std::optional<unsigned> closest;
+                for (const unsigned facet : facets)
+                {
+                        const std::optional<T> distance = mesh::CompactFacet<N, T>::intersect(
+                                ray, leaf_vertices_.vertices(facet, mesh_.vertices));
+                        if (distance && *distance < min_distance)
+                        {
+                                min_distance = *distance;
+                                closest = facet;
+                        }
+                }
+                if (closest)
+                {
+                        return std::tuple(min_distance, *closest);
+                }
+                return std::nullopt;
+        }
+
+        [[nodiscard]] T intersection_cost() const override
+        {
+                return intersection_cost_;
+        }
+
+        [[nodiscard]] std::optional<T> intersect_bounds(const numerical::Ray<N, T>& ray, const T max_distance)
+                const override
+        {
+                return bvh_.intersect_root(ray, max_distance);
+        }
+
+        [[nodiscard]] ShapeIntersection<N, T, Color> intersect(
+                const numerical::Ray<N, T>& ray,
+                const T max_distance,
+                const T /*bounding_distance*/) const override
+        {
+                const auto intersection = bvh_.intersect(
+                        ray, max_distance,
+                        [&](const geometry::accelerators::BvhObjectRange& facets, const T& max)
+                        {
+                                return intersect_facets(ray, facets, max);
+                        });
+                if (!intersection)
+                {
+                        return {0, nullptr};
+                }
+                const auto& [distance, facet] = *intersection;
+                return {distance,
+                        make_arena_ptr<SurfaceImpl<N, T, Color, Mesh, mesh::CompactFacetVertices<N, T>>>(
+                                &mesh_, mesh::CompactFacetVertices<N, T>(
+                                                &mesh_.facets[facet], &mesh_.vertices, leaf_vertices_.indices(facet)))};
+        }
+
+        [[nodiscard]] bool intersect_any(
+                const numerical::Ray<N, T>& ray,
+                const T max_distance,
+                const T /*bounding_distance*/) const override
+        {
+                return bvh_.intersect(
+                        ray, max_distance,
+                        [&](const geometry::accelerators::BvhObjectRange& facets, const T& max) -> bool
+                        {
+                                for (const unsigned facet : facets)
+                                {
+                                        const std::optional<T> distance = mesh::CompactFacet<N, T>::intersect(
+                                                ray, leaf_vertices_.vertices(facet, mesh_.vertices));
+                                        if (distance && *distance < max)
+                                        {
+                                                return true;
+                                        }
+                                }
+                                return false;
+                        });
+        }
+
+        [[nodiscard]] geometry::spatial::BoundingBox<N, T> bounding_box() const override
+        {
+                return bounding_box_;
+        }
+
+        [[nodiscard]] std::function<
+                bool(const geometry::spatial::ShapeOverlap<geometry::spatial::ParallelotopeAA<N, T>>&)>
+                overlap_function() const override
+        {
+                return bounding_box_overlap_function(bounding_box_);
+        }
+
+        CompactImpl(
+                mesh::MeshData<N, T, Color, mesh::CompactFacet<N, T>>&& mesh_data,
+                const MeshBvh bvh_type,
+                const MeshBvhNodes bvh_nodes,
+                const bool write_log,
+                progress::Ratio* const progress)
+                : bvh_(create_leaf_order_bvh(&mesh_data, bvh_type, bvh_nodes, write_log, progress)),
+                  mesh_(std::move(mesh_data.mesh)),
+                  leaf_vertices_(mesh_data.facet_vertex_indices),
+                  bounding_box_(bvh_.bounding_box()),
+                  intersection_cost_(mesh_.facets.size() * mesh::CompactFacet<N, T>::intersection_cost())
+        {
+                if (write_log)
+                {
+                        log_bvh_traversal(
+                                bvh_,
+                                [&](const numerical::Ray<N, T>& ray,
+                                    const geometry::accelerators::BvhObjectRange& facets, const T& max)
+                                {
+                                        return intersect_facets(ray, facets, max);
+                                });
+                }
+        }
+
+public:
+        CompactImpl(
+                const std::vector<const model::mesh::MeshObject<N>*>& mesh_objects,
+                const MeshBvh bvh_type,
+                const MeshBvhNodes bvh_nodes,
+                const bool write_log,
+                progress::Ratio* const progress)
+                : CompactImpl(
+                          mesh::create_mesh_data<N, T, Color, mesh::CompactFacet<N, T>>(mesh_objects, write_log),
+                          bvh_type,
+                          bvh_nodes,
+                          write_log,
+                          progress)
+        {
+        }
+};
 }
 
 template <std::size_t N, typename T, typename Color>
 std::unique_ptr<Shape<N, T, Color>> create_mesh(
         const std::vector<const model::mesh::MeshObject<N>*>& mesh_objects,
-        const std::optional<numerical::Vector<N + 1, T>>& clip_plane_equation,
+        const MeshLayout layout,
+        const MeshBvh bvh,
+        const MeshBvhNodes bvh_nodes,
         const bool write_log,
         progress::Ratio* const progress)
 {
-        return std::make_unique<Impl<N, T, Color>>(mesh_objects, clip_plane_equation, write_log, progress);
+        switch (layout)
+        {
+        case MeshLayout::PLANES:
+                return std::make_unique<Impl<N, T, Color>>(mesh_objects, bvh, bvh_nodes, write_log, progress);
+        case MeshLayout::COMPACT:
+                return std::make_unique<CompactImpl<N, T, Color>>(mesh_objects, bvh, bvh_nodes, write_log, progress);
+        }
+        error("Unknown mesh layout " + to_string(enum_to_int(layout)));
 }
 
-#define TEMPLATE(N, T, C)                                                \
-        template std::unique_ptr<Shape<(N), T, C>> create_mesh(          \
-                const std::vector<const model::mesh::MeshObject<(N)>*>&, \
-                const std::optional<numerical::Vector<(N) + 1, T>>&, bool, progress::Ratio*);
+template <std::size_t N, typename T>
+std::size_t mesh_facet_size(const MeshLayout layout)
+{
+        switch (layout)
+        {
+        case MeshLayout::PLANES:
+                return sizeof(mesh::Facet<N, T>);
+        case MeshLayout::COMPACT:
+                return sizeof(mesh::CompactFacet<N, T>) + mesh::LeafVertices<N>::FACET_SIZE;
+        }
+        error("Unknown mesh layout " + to_string(enum_to_int(layout)));
+}
+
+template <std::size_t N, typename T>
+std::size_t mesh_bvh_leaf_size(const MeshBvhNodes bvh_nodes)
+{
+        switch (bvh_nodes)
+        {
+        case MeshBvhNodes::FULL:
+                return 2 * sizeof(geometry::accelerators::bvh_implementation::Node<N, T>);
+        case MeshBvhNodes::QUANTIZED:
+                return sizeof(geometry::accelerators::BvhQuantizedNode<N, T>);
+        }
+        error("Unknown mesh BVH nodes " + to_string(enum_to_int(bvh_nodes)));
+}
+
+#define TEMPLATE_N_T(N, T)                                             \
+        template std::size_t mesh_facet_size<(N), T>(MeshLayout);      \
+        template std::size_t mesh_bvh_leaf_size<(N), T>(MeshBvhNodes);
+
+#define TEMPLATE_N_T_C(N, T, C)                                                                                   \
+        template std::unique_ptr<Shape<(N), T, C>> create_mesh(                                                   \
+                const std::vector<const model::mesh::MeshObject<(N)>*>&, MeshLayout, MeshBvh, MeshBvhNodes, bool, \
+                progress::Ratio*);
 
-TEMPLATE_INSTANTIATION_N_T_C(TEMPLATE)
+TEMPLATE_INSTANTIATION_N_T(TEMPLATE_N_T)
+TEMPLATE_INSTANTIATION_N_T_C(TEMPLATE_N_T_C)
 }
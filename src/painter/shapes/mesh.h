@@ -18,21 +18,55 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <src/model/mesh_object.h>
-#include <src/numerical/vector.h>
 #include <src/painter/objects.h>
 #include <src/progress/progress.h>
 
 #include <cstddef>
 #include <memory>
-#include <optional>
 #include <vector>
 
 namespace ns::painter::shapes
 {
+enum class MeshLayout
+{
+        // Facets store the simplex hyperplane and the planes through its ridges
+        PLANES,
+        // Facets store only shading data, vertex indices are stored
+        // in the BVH leaf order and intersections use the edges of facets
+        COMPACT
+};
+
+enum class MeshBvh
+{
+        // Facets are partitioned between BVH nodes
+        OBJECT_SPLITS,
+        // Facets crossing split planes can be referenced in both BVH nodes
+        SPATIAL_SPLITS
+};
+
+enum class MeshBvhNodes
+{
+        // Node bounds in float or in the mesh type
+        FULL,
+        // Child bounds quantized to 8 bits relative to the node bounds
+        QUANTIZED
+};
+
 template <std::size_t N, typename T, typename Color>
 std::unique_ptr<Shape<N, T, Color>> create_mesh(
         const std::vector<const model::mesh::MeshObject<N>*>& mesh_objects,
-        const std::optional<numerical::Vector<N + 1, T>>& clip_plane_equation,
+        MeshLayout layout,
+        MeshBvh bvh,
+        MeshBvhNodes bvh_nodes,
         bool write_log,
         progress::Ratio* progress);
+
+// Facet memory without vertices, normals, texture coordinates and BVH nodes
+template <std::size_t N, typename T>
+[[nodiscard]] std::size_t mesh_facet_size(MeshLayout layout);
+
+// BVH node memory per leaf, a binary tree with L leaves
+// has 2L - 1 nodes or L - 1 quantized nodes
+template <std::size_t N, typename T>
+[[nodiscard]] std::size_t mesh_bvh_leaf_size(MeshBvhNodes bvh_nodes);
 }
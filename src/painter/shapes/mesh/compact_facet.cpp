@@ -0,0 +1,132 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "compact_facet.h"
+
+#include "normals.h"
+
+#include <src/com/alg.h>
+#include <src/com/error.h>
+#include <src/com/print.h>
+#include <src/geometry/spatial/hyperplane_simplex.h>
+#include <src/numerical/complement.h>
+#include <src/numerical/vector.h>
+#include <src/settings/instantiation.h>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace ns::painter::shapes::mesh
+{
+template <std::size_t N, typename T>
+void CompactFacet<N, T>::set_texcoords(const bool has_texcoords, const std::array<int, N>& texcoord_indices)
+{
+        ASSERT((has_texcoords && all_non_negative(texcoord_indices)) || !has_texcoords);
+
+        if (has_texcoords)
+        {
+                t_ = texcoord_indices;
+        }
+        else
+        {
+                t_[0] = -1;
+        }
+}
+
+template <std::size_t N, typename T>
+void CompactFacet<N, T>::set_normals(
+        const numerical::Vector<N, T>& geometric_normal,
+        const std::vector<numerical::Vector<N, T>>& normals,
+        const bool has_normals,
+        const std::array<int, N>& normal_indices)
+{
+        ASSERT((has_normals && all_non_negative(normal_indices)) || !has_normals);
+
+        if (!has_normals)
+        {
+                normal_type_ = NormalType::NONE;
+                return;
+        }
+
+        const std::array<T, N> dots = compute_normal_dots(normals, normal_indices, geometric_normal);
+
+        if (!normals_unidirectional(dots))
+        {
+                normal_type_ = NormalType::NONE;
+                return;
+        }
+
+        n_ = normal_indices;
+
+        if (all_positive(dots))
+        {
+                normal_type_ = NormalType::USE;
+                return;
+        }
+
+        if (all_negative(dots))
+        {
+                normal_type_ = NormalType::USE;
+                reverse_geometric_normal_ = true;
+                return;
+        }
+
+        normal_type_ = NormalType::REVERSE;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                reverse_normal_[i] = dots[i] < 0;
+        }
+}
+
+template <std::size_t N, typename T>
+CompactFacet<N, T>::CompactFacet(
+        const std::array<numerical::Vector<N, T>, N>& vertices,
+        const std::vector<numerical::Vector<N, T>>& normals,
+        const bool has_normals,
+        const std::array<int, N>& normal_indices,
+        const bool has_texcoords,
+        const std::array<int, N>& texcoord_indices,
+        const int material)
+        : material_(material),
+          reverse_geometric_normal_(false)
+{
+        const numerical::Vector<N, T> geometric_normal =
+                numerical::orthogonal_complement(compact_facet_implementation::edges(vertices)).normalized();
+        if (!is_finite(geometric_normal))
+        {
+                error("Mesh facet normal " + to_string(geometric_normal) + " is not finite, vertices "
+                      + to_string(vertices));
+        }
+
+        set_texcoords(has_texcoords, texcoord_indices);
+
+        set_normals(geometric_normal, normals, has_normals, normal_indices);
+}
+
+template <std::size_t N, typename T>
+T CompactFacet<N, T>::intersection_cost()
+{
+        // The relative cost is only used to build the BVH,
+        // the plane form cost is close enough
+        return geometry::spatial::HyperplaneSimplex<N, T>::intersection_cost();
+}
+
+#define TEMPLATE(N, T) template class CompactFacet<N, T>;
+
+TEMPLATE_INSTANTIATION_N_T(TEMPLATE)
+}
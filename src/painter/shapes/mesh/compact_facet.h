@@ -0,0 +1,381 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Tomas Möller, Ben Trumbore.
+Fast, Minimum Storage Ray/Triangle Intersection.
+Journal of Graphics Tools, 1997.
+*/
+
+#pragma once
+
+#include <src/com/enum.h>
+#include <src/com/error.h>
+#include <src/com/print.h>
+#include <src/numerical/complement.h>
+#include <src/numerical/ray.h>
+#include <src/numerical/solve.h>
+#include <src/numerical/vector.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace ns::painter::shapes::mesh
+{
+namespace compact_facet_implementation
+{
+template <std::size_t N, typename T>
+[[nodiscard]] std::array<numerical::Vector<N, T>, N - 1> edges(const std::array<numerical::Vector<N, T>, N>& vertices)
+{
+        std::array<numerical::Vector<N, T>, N - 1> res;
+        for (std::size_t i = 0; i < N - 1; ++i)
+        {
+                res[i] = vertices[i] - vertices[N - 1];
+        }
+        return res;
+}
+
+// Barycentric coordinates of a point in the facet hyperplane
+template <std::size_t N, typename T>
+[[nodiscard]] numerical::Vector<N, T> barycentric_coordinates(
+        const std::array<numerical::Vector<N, T>, N>& vertices,
+        const numerical::Vector<N, T>& normal,
+        const numerical::Vector<N, T>& point)
+{
+        const std::array<numerical::Vector<N, T>, N - 1> e = edges(vertices);
+
+        // point - vertices[N - 1] = sum(x[i] * e[i]) + x[N - 1] * normal
+        std::array<numerical::Vector<N, T>, N> a;
+        for (std::size_t r = 0; r < N; ++r)
+        {
+                for (std::size_t c = 0; c < N - 1; ++c)
+                {
+                        a[r][c] = e[c][r];
+                }
+                a[r][N - 1] = normal[r];
+        }
+
+        const numerical::Vector<N, T> x = numerical::linear_solve(a, point - vertices[N - 1]);
+
+        numerical::Vector<N, T> res;
+        res[N - 1] = 1;
+        for (std::size_t i = 0; i < N - 1; ++i)
+        {
+                res[i] = x[i];
+                res[N - 1] -= x[i];
+        }
+        return res;
+}
+
+template <std::size_t N, typename T, typename V>
+[[nodiscard]] V interpolate(const numerical::Vector<N, T>& barycentric, const std::array<V, N>& values)
+{
+        V res = barycentric[0] * values[0];
+        for (std::size_t i = 1; i < N; ++i)
+        {
+                res += barycentric[i] * values[i];
+        }
+        return res;
+}
+}
+
+// The facet geometry is computed from the mesh vertices
+// instead of being stored in the facet
+template <std::size_t N, typename T>
+class CompactFacet final
+{
+        static_assert(N >= 3);
+
+        enum class NormalType : char
+        {
+                NONE,
+                USE,
+                REVERSE
+        };
+
+        std::array<int, N> n_;
+        std::array<int, N> t_;
+        int material_;
+        NormalType normal_type_;
+        bool reverse_geometric_normal_;
+        std::array<bool, N> reverse_normal_;
+
+        void set_texcoords(bool has_texcoords, const std::array<int, N>& texcoord_indices);
+
+        void set_normals(
+                const numerical::Vector<N, T>& geometric_normal,
+                const std::vector<numerical::Vector<N, T>>& normals,
+                bool has_normals,
+                const std::array<int, N>& normal_indices);
+
+public:
+        // Not initialized, for construction in place
+        CompactFacet()
+        {
+        }
+
+        CompactFacet(
+                const std::array<numerical::Vector<N, T>, N>& vertices,
+                const std::vector<numerical::Vector<N, T>>& normals,
+                bool has_normals,
+                const std::array<int, N>& normal_indices,
+                bool has_texcoords,
+                const std::array<int, N>& texcoord_indices,
+                int material);
+
+        //
+
+        [[nodiscard]] int material() const
+        {
+                return material_;
+        }
+
+        [[nodiscard]] bool has_texcoord() const
+        {
+                return t_[0] >= 0;
+        }
+
+        [[nodiscard]] numerical::Vector<N - 1, T> texcoord(
+                const std::array<numerical::Vector<N, T>, N>& vertices,
+                const std::vector<numerical::Vector<N - 1, T>>& mesh_texcoords,
+                const numerical::Vector<N, T>& point) const
+        {
+                namespace impl = compact_facet_implementation;
+
+                if (has_texcoord())
+                {
+                        std::array<numerical::Vector<N - 1, T>, N> texcoords;
+                        for (std::size_t i = 0; i < N; ++i)
+                        {
+                                texcoords[i] = mesh_texcoords[t_[i]];
+                        }
+                        return impl::interpolate(
+                                impl::barycentric_coordinates(vertices, geometric_normal(vertices), point),
+                                texcoords);
+                }
+                error("Mesh facet texture coordinates request when there are no texture coordinates");
+        }
+
+        [[nodiscard]] numerical::Vector<N, T> shading_normal(
+                const std::array<numerical::Vector<N, T>, N>& vertices,
+                const std::vector<numerical::Vector<N, T>>& mesh_normals,
+                const numerical::Vector<N, T>& point) const
+        {
+                namespace impl = compact_facet_implementation;
+
+                const numerical::Vector<N, T> normal = geometric_normal(vertices);
+
+                switch (normal_type_)
+                {
+                case NormalType::NONE:
+                {
+                        return normal;
+                }
+                case NormalType::USE:
+                {
+                        std::array<numerical::Vector<N, T>, N> normals;
+                        for (std::size_t i = 0; i < N; ++i)
+                        {
+                                normals[i] = mesh_normals[n_[i]];
+                        }
+                        return impl::interpolate(impl::barycentric_coordinates(vertices, normal, point), normals)
+                                .normalized();
+                }
+                case NormalType::REVERSE:
+                {
+                        std::array<numerical::Vector<N, T>, N> normals;
+                        for (std::size_t i = 0; i < N; ++i)
+                        {
+                                normals[i] = reverse_normal_[i] ? -mesh_normals[n_[i]] : mesh_normals[n_[i]];
+                        }
+                        return impl::interpolate(impl::barycentric_coordinates(vertices, normal, point), normals)
+                                .normalized();
+                }
+                }
+                error_fatal("Unknown mesh facet normal type " + to_string(enum_to_int(normal_type_)));
+        }
+
+        //
+
+        [[nodiscard]] static T intersection_cost();
+
+        [[nodiscard]] static std::optional<T> intersect(
+                const numerical::Ray<N, T>& ray,
+                const std::array<numerical::Vector<N, T>, N>& vertices)
+        {
+                if constexpr (N == 3)
+                {
+                        // org + t * dir = v[2] + u * (v[0] - v[2]) + v * (v[1] - v[2])
+
+                        const numerical::Vector<3, T> e0 = vertices[0] - vertices[2];
+                        const numerical::Vector<3, T> e1 = vertices[1] - vertices[2];
+
+                        const numerical::Vector<3, T> p = cross(ray.dir(), e1);
+                        const T det = dot(e0, p);
+                        if (det == 0)
+                        {
+                                return std::nullopt;
+                        }
+                        const T det_reciprocal = 1 / det;
+
+                        const numerical::Vector<3, T> s = ray.org() - vertices[2];
+                        const T u = dot(s, p) * det_reciprocal;
+                        if (!(u > 0 && u < 1))
+                        {
+                                return std::nullopt;
+                        }
+
+                        const numerical::Vector<3, T> q = cross(s, e0);
+                        const T v = dot(ray.dir(), q) * det_reciprocal;
+                        if (!(v > 0 && u + v < 1))
+                        {
+                                return std::nullopt;
+                        }
+
+                        const T t = dot(e1, q) * det_reciprocal;
+                        if (!(t > 0))
+                        {
+                                return std::nullopt;
+                        }
+                        return t;
+                }
+                else
+                {
+                        // org + t * dir = v[N - 1] + sum(x[i] * (v[i] - v[N - 1]))
+
+                        const std::array<numerical::Vector<N, T>, N - 1> e =
+                                compact_facet_implementation::edges(vertices);
+
+                        std::array<numerical::Vector<N, T>, N> a;
+                        for (std::size_t r = 0; r < N; ++r)
+                        {
+                                for (std::size_t c = 0; c < N - 1; ++c)
+                                {
+                                        a[r][c] = e[c][r];
+                                }
+                                a[r][N - 1] = -ray.dir()[r];
+                        }
+
+                        const numerical::Vector<N, T> x = numerical::linear_solve(a, ray.org() - vertices[N - 1]);
+
+                        const T t = x[N - 1];
+                        if (!(t > 0))
+                        {
+                                return std::nullopt;
+                        }
+
+                        T sum = 0;
+                        for (std::size_t i = 0; i < N - 1; ++i)
+                        {
+                                if (!(x[i] > 0 && x[i] < 1))
+                                {
+                                        return std::nullopt;
+                                }
+                                sum += x[i];
+                        }
+                        if (!(sum < 1))
+                        {
+                                return std::nullopt;
+                        }
+                        return t;
+                }
+        }
+
+        [[nodiscard]] numerical::Vector<N, T> geometric_normal(
+                const std::array<numerical::Vector<N, T>, N>& vertices) const
+        {
+                const numerical::Vector<N, T> normal =
+                        numerical::orthogonal_complement(compact_facet_implementation::edges(vertices)).normalized();
+                return reverse_geometric_normal_ ? -normal : normal;
+        }
+
+        [[nodiscard]] numerical::Vector<N, T> project(
+                const std::array<numerical::Vector<N, T>, N>& vertices,
+                const numerical::Vector<N, T>& point) const
+        {
+                const numerical::Vector<N, T> normal = geometric_normal(vertices);
+                return point - normal * dot(normal, point - vertices[N - 1]);
+        }
+};
+
+// The interface of the facet with the plane form
+template <std::size_t N, typename T>
+class CompactFacetVertices final
+{
+        const CompactFacet<N, T>* facet_;
+        const std::vector<numerical::Vector<N, T>>* mesh_vertices_;
+        std::array<std::uint32_t, N> indices_;
+
+        [[nodiscard]] std::array<numerical::Vector<N, T>, N> vertices() const
+        {
+                std::array<numerical::Vector<N, T>, N> res;
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                        res[i] = (*mesh_vertices_)[indices_[i]];
+                }
+                return res;
+        }
+
+public:
+        CompactFacetVertices(
+                const CompactFacet<N, T>* const facet,
+                const std::vector<numerical::Vector<N, T>>* const mesh_vertices,
+                const std::array<std::uint32_t, N>& indices)
+                : facet_(facet),
+                  mesh_vertices_(mesh_vertices),
+                  indices_(indices)
+        {
+        }
+
+        [[nodiscard]] int material() const
+        {
+                return facet_->material();
+        }
+
+        [[nodiscard]] bool has_texcoord() const
+        {
+                return facet_->has_texcoord();
+        }
+
+        [[nodiscard]] numerical::Vector<N - 1, T> texcoord(
+                const std::vector<numerical::Vector<N - 1, T>>& mesh_texcoords,
+                const numerical::Vector<N, T>& point) const
+        {
+                return facet_->texcoord(vertices(), mesh_texcoords, point);
+        }
+
+        [[nodiscard]] numerical::Vector<N, T> shading_normal(
+                const std::vector<numerical::Vector<N, T>>& mesh_normals,
+                const numerical::Vector<N, T>& point) const
+        {
+                return facet_->shading_normal(vertices(), mesh_normals, point);
+        }
+
+        [[nodiscard]] numerical::Vector<N, T> geometric_normal() const
+        {
+                return facet_->geometric_normal(vertices());
+        }
+
+        [[nodiscard]] numerical::Vector<N, T> project(const numerical::Vector<N, T>& point) const
+        {
+                return facet_->project(vertices(), point);
+        }
+};
+}
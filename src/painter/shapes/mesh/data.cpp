@@ -17,14 +17,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "data.h"
 
-#include "optimize.h"
-
 #include <src/com/chrono.h>
 #include <src/com/error.h>
 #include <src/com/log.h>
 #include <src/com/print.h>
+#include <src/com/thread.h>
 #include <src/model/mesh.h>
 #include <src/model/mesh_object.h>
+#include <src/model/mesh_utility.h>
 #include <src/numerical/matrix.h>
 #include <src/numerical/transform.h>
 #include <src/numerical/vector.h>
@@ -32,14 +32,19 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <optional>
+#include <utility>
 #include <vector>
 
 namespace ns::painter::shapes::mesh
 {
 namespace
 {
+// Facets are created in parallel in chunks of this size
+constexpr std::size_t FACET_CHUNK_SIZE = 1 << 14;
+
 template <std::size_t N>
 [[nodiscard]] std::array<int, N> add_offset(const std::array<int, N>& src, const int offset, const bool add)
 {
@@ -85,11 +90,11 @@ template <std::size_t N, typename T>
         return res;
 }
 
-template <std::size_t N, typename T, typename Color>
+template <std::size_t N, typename T, typename Color, typename FacetType>
 void write_vertices_and_normals(
         const model::mesh::Reading<N>& mesh_object,
         const model::mesh::Mesh<N>& mesh,
-        MeshData<N, T, Color>* const data)
+        MeshData<N, T, Color, FacetType>* const data)
 {
         const numerical::Matrix<N + 1, N + 1, T> mesh_matrix = numerical::to_matrix<T>(mesh_object.matrix());
 
@@ -110,7 +115,7 @@ void write_vertices_and_normals(
         }
 }
 
-template <std::size_t N, typename T, typename Color>
+template <std::size_t N, typename T, typename Color, typename FacetType>
 void write_facets_and_materials(
         const model::mesh::Reading<N>& mesh_object,
         const model::mesh::Mesh<N>& mesh,
@@ -120,30 +125,48 @@ void write_facets_and_materials(
         const int texcoords_offset,
         const int materials_offset,
         const int images_offset,
-        MeshData<N, T, Color>* const data)
+        MeshData<N, T, Color, FacetType>* const data)
 {
         const int default_material_index = mesh.materials.size();
 
-        bool facets_without_material = false;
+        const std::size_t facet_count = mesh.facets.size();
+        // The facets are constructed in place at the chunk offsets
+        const std::size_t facets_offset = data->mesh.facets.size();
+        data->mesh.facets.resize(facets_offset + facet_count);
+        data->facet_vertex_indices.resize(facets_offset + facet_count);
 
-        for (const typename model::mesh::Mesh<N>::Facet& facet : mesh.facets)
-        {
-                const bool no_material = facet.material < 0;
-                const int facet_material = no_material ? default_material_index : facet.material;
+        std::atomic_bool facets_without_material = false;
 
-                const std::array<int, N> vertices = add_offset(facet.vertices, vertices_offset);
-                const std::array<int, N> normals = add_offset(facet.normals, normals_offset, facet.has_normal);
-                const std::array<int, N> texcoords = add_offset(facet.texcoords, texcoords_offset, facet.has_texcoord);
-                const int material = facet_material + materials_offset;
+        run_in_chunks(
+                facet_count, FACET_CHUNK_SIZE,
+                [&](const std::size_t begin, const std::size_t end)
+                {
+                        bool without_material = false;
+                        for (std::size_t i = begin; i < end; ++i)
+                        {
+                                const typename model::mesh::Mesh<N>::Facet& facet = mesh.facets[i];
 
-                data->mesh.facets.emplace_back(
-                        vertices_to_array(data->mesh.vertices, vertices), data->mesh.normals, facet.has_normal, normals,
-                        facet.has_texcoord, texcoords, material);
+                                const int facet_material = facet.material < 0 ? default_material_index : facet.material;
 
-                data->facet_vertex_indices.push_back(vertices);
+                                const std::array<int, N> vertices = add_offset(facet.vertices, vertices_offset);
+                                const std::array<int, N> normals =
+                                        add_offset(facet.normals, normals_offset, facet.has_normal);
+                                const std::array<int, N> texcoords =
+                                        add_offset(facet.texcoords, texcoords_offset, facet.has_texcoord);
+                                const int material = facet_material + materials_offset;
 
-                facets_without_material = facets_without_material || no_material;
-        }
+                                data->mesh.facets[facets_offset + i] = FacetType(
+                                        vertices_to_array(data->mesh.vertices, vertices), data->mesh.normals,
+                                        facet.has_normal, normals, facet.has_texcoord, texcoords, material);
+                                data->facet_vertex_indices[facets_offset + i] = vertices;
+
+                                without_material = without_material || facet.material < 0;
+                        }
+                        if (without_material)
+                        {
+                                facets_without_material.store(true, std::memory_order_relaxed);
+                        }
+                });
 
         for (const typename model::mesh::Mesh<N>::Material& material : mesh.materials)
         {
@@ -152,7 +175,7 @@ void write_facets_and_materials(
                         mesh_object.metalness(), mesh_object.roughness(), material.color, image, alpha);
         }
 
-        if (facets_without_material)
+        if (facets_without_material.load(std::memory_order_relaxed))
         {
                 ASSERT(materials_offset + default_material_index == static_cast<int>(data->mesh.materials.size()));
                 data->mesh.materials.emplace_back(
@@ -160,11 +183,8 @@ void write_facets_and_materials(
         }
 }
 
-template <std::size_t N, typename T, typename Color>
-void add_mesh(
-        const model::mesh::Reading<N>& mesh_object,
-        const std::optional<numerical::Vector<N + 1, T>>& clip_plane_equation,
-        MeshData<N, T, Color>* const data)
+template <std::size_t N, typename T, typename Color, typename FacetType>
+void add_mesh(const model::mesh::Reading<N>& mesh_object, MeshData<N, T, Color, FacetType>* const data)
 {
         const T alpha = std::clamp<T>(mesh_object.alpha(), 0, 1);
 
@@ -173,7 +193,7 @@ void add_mesh(
                 return;
         }
 
-        const model::mesh::Mesh<N> mesh = optimize_mesh(mesh_object, clip_plane_equation);
+        const model::mesh::Mesh<N> mesh = model::mesh::optimize(mesh_object.mesh());
 
         if (mesh.vertices.empty())
         {
@@ -208,8 +228,8 @@ void add_mesh(
         }
 }
 
-template <std::size_t N, typename T, typename Color>
-void reserve_mesh_data(const std::vector<model::mesh::Reading<N>>& mesh_objects, MeshData<N, T, Color>& data)
+template <std::size_t N, typename T, typename Color, typename FacetType>
+void reserve_mesh_data(const std::vector<model::mesh::Reading<N>>& mesh_objects, MeshData<N, T, Color, FacetType>& data)
 {
         std::size_t vertex_count = 0;
         std::size_t normal_count = 0;
@@ -246,23 +266,21 @@ void reserve_mesh_data(const std::vector<model::mesh::Reading<N>>& mesh_objects,
         data.facet_vertex_indices.reserve(facet_count);
 }
 
-template <std::size_t N, typename T, typename Color>
-MeshData<N, T, Color> create_mesh_data(
-        const std::vector<model::mesh::Reading<N>>& mesh_objects,
-        const std::optional<numerical::Vector<N + 1, T>>& clip_plane_equation)
+template <std::size_t N, typename T, typename Color, typename FacetType>
+MeshData<N, T, Color, FacetType> create_mesh_data(const std::vector<model::mesh::Reading<N>>& mesh_objects)
 {
         if (mesh_objects.empty())
         {
                 error("No objects to paint");
         }
 
-        MeshData<N, T, Color> data;
+        MeshData<N, T, Color, FacetType> data;
 
         reserve_mesh_data(mesh_objects, data);
 
         for (const model::mesh::Reading<N>& mesh_object : mesh_objects)
         {
-                add_mesh(mesh_object, clip_plane_equation, &data);
+                add_mesh(mesh_object, &data);
         }
 
         if (data.mesh.facets.empty())
@@ -274,10 +292,9 @@ MeshData<N, T, Color> create_mesh_data(
 }
 }
 
-template <std::size_t N, typename T, typename Color>
-MeshData<N, T, Color> create_mesh_data(
+template <std::size_t N, typename T, typename Color, typename FacetType>
+MeshData<N, T, Color, FacetType> create_mesh_data(
         const std::vector<const model::mesh::MeshObject<N>*>& mesh_objects,
-        const std::optional<numerical::Vector<N + 1, T>>& clip_plane_equation,
         const bool write_log)
 {
         const std::optional<Clock::time_point> start_time = [&] -> std::optional<Clock::time_point>
@@ -296,7 +313,7 @@ MeshData<N, T, Color> create_mesh_data(
                 reading.emplace_back(*mesh_object);
         }
 
-        MeshData<N, T, Color> res = create_mesh_data<N, T, Color>(reading, clip_plane_equation);
+        MeshData<N, T, Color, FacetType> res = create_mesh_data<N, T, Color, FacetType>(reading);
 
         ASSERT(write_log == start_time.has_value());
         if (write_log)
@@ -309,10 +326,52 @@ MeshData<N, T, Color> create_mesh_data(
         return res;
 }
 
-#define TEMPLATE(N, T, C)                                                \
-        template MeshData<N, T, C> create_mesh_data(                     \
-                const std::vector<const model::mesh::MeshObject<(N)>*>&, \
-                const std::optional<numerical::Vector<(N) + 1, T>>&, const bool);
+template <std::size_t N, typename T, typename Color, typename FacetType>
+void reorder_mesh_data(const std::vector<unsigned>& leaf_facets, MeshData<N, T, Color, FacetType>* const mesh_data)
+{
+        ASSERT(mesh_data->mesh.facets.size() == mesh_data->facet_vertex_indices.size());
+
+        std::vector<FacetType> facets;
+        std::vector<std::array<int, N>> facet_vertex_indices;
+        facets.reserve(leaf_facets.size());
+        facet_vertex_indices.reserve(leaf_facets.size());
+
+        std::vector<int> vertex_map(mesh_data->mesh.vertices.size(), -1);
+        std::vector<numerical::Vector<N, T>> vertices;
+        vertices.reserve(mesh_data->mesh.vertices.size());
+
+        for (const unsigned facet : leaf_facets)
+        {
+                ASSERT(facet < mesh_data->mesh.facets.size());
+
+                facets.push_back(mesh_data->mesh.facets[facet]);
+
+                std::array<int, N>& indices = facet_vertex_indices.emplace_back();
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                        const int index = mesh_data->facet_vertex_indices[facet][i];
+                        ASSERT(index >= 0 && static_cast<std::size_t>(index) < vertex_map.size());
+                        if (vertex_map[index] < 0)
+                        {
+                                vertex_map[index] = vertices.size();
+                                vertices.push_back(mesh_data->mesh.vertices[index]);
+                        }
+                        indices[i] = vertex_map[index];
+                }
+        }
+
+        mesh_data->mesh.facets = std::move(facets);
+        mesh_data->mesh.vertices = std::move(vertices);
+        mesh_data->facet_vertex_indices = std::move(facet_vertex_indices);
+}
+
+#define TEMPLATE(N, T, C)                                                                                      \
+        template MeshData<N, T, C, Facet<N, T>> create_mesh_data(                                              \
+                const std::vector<const model::mesh::MeshObject<(N)>*>&, const bool);                          \
+        template MeshData<N, T, C, CompactFacet<N, T>> create_mesh_data(                                       \
+                const std::vector<const model::mesh::MeshObject<(N)>*>&, const bool);                          \
+        template void reorder_mesh_data(const std::vector<unsigned>&, MeshData<N, T, C, Facet<N, T>>*);        \
+        template void reorder_mesh_data(const std::vector<unsigned>&, MeshData<N, T, C, CompactFacet<N, T>>*);
 
 TEMPLATE_INSTANTIATION_N_T_C(TEMPLATE)
 }
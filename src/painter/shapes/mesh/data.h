@@ -17,6 +17,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "compact_facet.h"
 #include "facet.h"
 #include "material.h"
 #include "texture.h"
@@ -26,12 +27,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <array>
 #include <cstddef>
-#include <optional>
 #include <vector>
 
 namespace ns::painter::shapes::mesh
 {
-template <std::size_t N, typename T, typename Color>
+template <std::size_t N, typename T, typename Color, typename FacetType>
 struct Mesh final
 {
         std::vector<numerical::Vector<N, T>> vertices;
@@ -39,19 +39,24 @@ struct Mesh final
         std::vector<numerical::Vector<N - 1, T>> texcoords;
         std::vector<Material<T, Color>> materials;
         std::vector<Texture<N - 1>> images;
-        std::vector<Facet<N, T>> facets;
+        std::vector<FacetType> facets;
 };
 
-template <std::size_t N, typename T, typename Color>
+template <std::size_t N, typename T, typename Color, typename FacetType>
 struct MeshData final
 {
-        Mesh<N, T, Color> mesh;
+        Mesh<N, T, Color, FacetType> mesh;
         std::vector<std::array<int, N>> facet_vertex_indices;
 };
 
-template <std::size_t N, typename T, typename Color>
-MeshData<N, T, Color> create_mesh_data(
+template <std::size_t N, typename T, typename Color, typename FacetType>
+MeshData<N, T, Color, FacetType> create_mesh_data(
         const std::vector<const model::mesh::MeshObject<N>*>& mesh_objects,
-        const std::optional<numerical::Vector<N + 1, T>>& clip_plane_equation,
         bool write_log);
+
+// Facets in the order of the BVH leaves and vertices in the order
+// of their first use by the facets. With spatial splits, facets
+// referenced by several leaves are copied
+template <std::size_t N, typename T, typename Color, typename FacetType>
+void reorder_mesh_data(const std::vector<unsigned>& leaf_facets, MeshData<N, T, Color, FacetType>* mesh_data);
 }
@@ -17,6 +17,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "facet.h"
 
+#include "normals.h"
+
 #include <src/com/alg.h>
 #include <src/com/error.h>
 #include <src/geometry/spatial/hyperplane_simplex.h>
@@ -24,47 +26,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/settings/instantiation.h>
 
 #include <array>
-#include <cmath>
 #include <cstddef>
 #include <vector>
 
 namespace ns::painter::shapes::mesh
 {
-namespace
-{
-template <typename T>
-constexpr T MIN_COSINE_VERTEX_NORMAL_FACET_NORMAL = 0.7;
-
-template <std::size_t N, typename T>
-[[nodiscard]] std::array<T, N> compute_dots(
-        const std::vector<numerical::Vector<N, T>>& normals,
-        const std::array<int, N>& normal_indices,
-        const numerical::Vector<N, T>& simplex_normal)
-{
-        std::array<T, N> res;
-        for (std::size_t i = 0; i < N; ++i)
-        {
-                res[i] = dot(normals[normal_indices[i]], simplex_normal);
-        }
-        return res;
-}
-
-template <std::size_t N, typename T>
-[[nodiscard]] bool all_unidirectional(const std::array<T, N>& dots)
-{
-        static_assert(MIN_COSINE_VERTEX_NORMAL_FACET_NORMAL<T> > 0);
-
-        for (std::size_t i = 0; i < N; ++i)
-        {
-                if (!(std::isfinite(dots[i]) && std::abs(dots[i]) >= MIN_COSINE_VERTEX_NORMAL_FACET_NORMAL<T>))
-                {
-                        return false;
-                }
-        }
-        return true;
-}
-}
-
 template <std::size_t N, typename T>
 void Facet<N, T>::set_texcoords(const bool has_texcoords, const std::array<int, N>& texcoord_indices)
 {
@@ -94,9 +60,9 @@ void Facet<N, T>::set_normals(
                 return;
         }
 
-        const std::array<T, N> dots = compute_dots(normals, normal_indices, simplex_.normal());
+        const std::array<T, N> dots = compute_normal_dots(normals, normal_indices, simplex_.normal());
 
-        if (!all_unidirectional(dots))
+        if (!normals_unidirectional(dots))
         {
                 normal_type_ = NormalType::NONE;
                 return;
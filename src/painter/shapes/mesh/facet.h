@@ -57,6 +57,11 @@ class Facet final
                 const std::array<int, N>& normal_indices);
 
 public:
+        // Not initialized, for construction in place
+        Facet()
+        {
+        }
+
         Facet(const std::array<numerical::Vector<N, T>, N>& vertices,
               const std::vector<numerical::Vector<N, T>>& normals,
               bool has_normals,
@@ -0,0 +1,82 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <src/com/error.h>
+#include <src/numerical/vector.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ns::painter::shapes::mesh
+{
+// Facet vertex indices in the order of the BVH leaves,
+// a separate array for each facet vertex
+template <std::size_t N>
+class LeafVertices final
+{
+        std::array<std::vector<std::uint32_t>, N> indices_;
+
+public:
+        static constexpr std::size_t FACET_SIZE = N * sizeof(std::uint32_t);
+
+        explicit LeafVertices(const std::vector<std::array<int, N>>& facet_vertex_indices)
+        {
+                for (std::size_t n = 0; n < N; ++n)
+                {
+                        indices_[n].reserve(facet_vertex_indices.size());
+                }
+
+                for (const std::array<int, N>& indices : facet_vertex_indices)
+                {
+                        for (std::size_t n = 0; n < N; ++n)
+                        {
+                                ASSERT(indices[n] >= 0);
+                                indices_[n].push_back(indices[n]);
+                        }
+                }
+        }
+
+        [[nodiscard]] std::array<std::uint32_t, N> indices(const std::size_t index) const
+        {
+                std::array<std::uint32_t, N> res;
+                for (std::size_t n = 0; n < N; ++n)
+                {
+                        ASSERT(index < indices_[n].size());
+                        res[n] = indices_[n][index];
+                }
+                return res;
+        }
+
+        template <typename T>
+        [[nodiscard]] std::array<numerical::Vector<N, T>, N> vertices(
+                const std::size_t index,
+                const std::vector<numerical::Vector<N, T>>& mesh_vertices) const
+        {
+                std::array<numerical::Vector<N, T>, N> res;
+                for (std::size_t n = 0; n < N; ++n)
+                {
+                        ASSERT(index < indices_[n].size());
+                        res[n] = mesh_vertices[indices_[n][index]];
+                }
+                return res;
+        }
+};
+}
@@ -0,0 +1,61 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <src/com/error.h>
+#include <src/numerical/vector.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace ns::painter::shapes::mesh
+{
+template <typename T>
+inline constexpr T MIN_COSINE_VERTEX_NORMAL_FACET_NORMAL = 0.7;
+
+template <std::size_t N, typename T>
+[[nodiscard]] std::array<T, N> compute_normal_dots(
+        const std::vector<numerical::Vector<N, T>>& normals,
+        const std::array<int, N>& normal_indices,
+        const numerical::Vector<N, T>& facet_normal)
+{
+        std::array<T, N> res;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                res[i] = dot(normals[normal_indices[i]], facet_normal);
+        }
+        return res;
+}
+
+template <std::size_t N, typename T>
+[[nodiscard]] bool normals_unidirectional(const std::array<T, N>& dots)
+{
+        static_assert(MIN_COSINE_VERTEX_NORMAL_FACET_NORMAL<T> > 0);
+
+        for (std::size_t i = 0; i < N; ++i)
+        {
+                if (!(std::isfinite(dots[i]) && std::abs(dots[i]) >= MIN_COSINE_VERTEX_NORMAL_FACET_NORMAL<T>))
+                {
+                        return false;
+                }
+        }
+        return true;
+}
+}
@@ -18,6 +18,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <src/com/error.h>
+#include <src/com/thread.h>
 #include <src/image/conversion.h>
 #include <src/image/format.h>
 #include <src/image/image.h>
@@ -34,15 +35,16 @@ namespace ns::painter::shapes::mesh
 template <std::size_t N>
 class Texture final
 {
-        [[nodiscard]] static std::vector<numerical::Vector<3, float>> to_rgb32(const image::Image<N>& image)
-        {
-                const std::size_t pixel_count = image.pixels.size() / format_pixel_size_in_bytes(image.color_format);
-
-                std::vector<numerical::Vector<3, float>> pixels(pixel_count);
+        // Pixels are converted in parallel in chunks of this size
+        static constexpr std::size_t PIXEL_CHUNK_SIZE = 1 << 16;
 
+        static void to_rgb32(
+                const image::ColorFormat color_format,
+                const std::span<const std::byte> bytes,
+                const std::span<numerical::Vector<3, float>> pixels)
+        {
                 image::format_conversion(
-                        image.color_format, image.pixels, image::ColorFormat::R32G32B32,
-                        std::as_writable_bytes(std::span(pixels.data(), pixels.size())));
+                        color_format, bytes, image::ColorFormat::R32G32B32, std::as_writable_bytes(pixels));
 
                 for (numerical::Vector<3, float>& c : pixels)
                 {
@@ -55,6 +57,24 @@ class Texture final
                         c[1] = std::clamp<float>(c[1], 0, 1);
                         c[2] = std::clamp<float>(c[2], 0, 1);
                 }
+        }
+
+        [[nodiscard]] static std::vector<numerical::Vector<3, float>> to_rgb32(const image::Image<N>& image)
+        {
+                const std::size_t pixel_size = format_pixel_size_in_bytes(image.color_format);
+                const std::size_t pixel_count = image.pixels.size() / pixel_size;
+                std::vector<numerical::Vector<3, float>> pixels(pixel_count);
+
+                run_in_chunks(
+                        pixel_count, PIXEL_CHUNK_SIZE,
+                        [&](const std::size_t begin, const std::size_t end)
+                        {
+                                const std::size_t count = end - begin;
+                                to_rgb32(
+                                        image.color_format,
+                                        std::span(image.pixels).subspan(begin * pixel_size, count * pixel_size),
+                                        std::span(pixels).subspan(begin, count));
+                        });
 
                 return pixels;
         }
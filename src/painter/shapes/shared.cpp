@@ -0,0 +1,186 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "shared.h"
+
+#include <src/com/error.h>
+#include <src/geometry/spatial/bounding_box.h>
+#include <src/geometry/spatial/clip_plane.h>
+#include <src/geometry/spatial/convex_polytope.h>
+#include <src/geometry/spatial/parallelotope_aa.h>
+#include <src/geometry/spatial/shape_overlap.h>
+#include <src/numerical/ray.h>
+#include <src/numerical/vector.h>
+#include <src/painter/objects.h>
+#include <src/settings/instantiation.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace ns::painter::shapes
+{
+namespace
+{
+template <std::size_t N, typename T, typename Color, bool USE_CLIP_POLYTOPE>
+class Impl final : public Shape<N, T, Color>
+{
+        const std::shared_ptr<const Shape<N, T, Color>> shape_;
+        const std::optional<geometry::spatial::ConvexPolytope<N, T>> clip_polytope_;
+
+        // The part of the ray inside the clip polytope
+        // is from near to far
+        [[nodiscard]] bool clip_ray(const numerical::Ray<N, T>& ray, T* const near, T* const far) const
+        {
+                *near = 0;
+
+                if constexpr (!USE_CLIP_POLYTOPE)
+                {
+                        ASSERT(!clip_polytope_);
+                        return true;
+                }
+
+                ASSERT(clip_polytope_);
+                return clip_polytope_->intersect(ray, near, far);
+        }
+
+        [[nodiscard]] T intersection_cost() const override
+        {
+                return shape_->intersection_cost();
+        }
+
+        [[nodiscard]] std::optional<T> intersect_bounds(const numerical::Ray<N, T>& ray, const T max_distance)
+                const override
+        {
+                T near;
+                T far = max_distance;
+                if (!clip_ray(ray, &near, &far))
+                {
+                        return std::nullopt;
+                }
+                const std::optional<T> distance = shape_->intersect_bounds(ray, far);
+                if (!distance)
+                {
+                        return std::nullopt;
+                }
+                return std::max(*distance, near);
+        }
+
+        [[nodiscard]] ShapeIntersection<N, T, Color> intersect(
+                const numerical::Ray<N, T>& ray,
+                const T max_distance,
+                const T bounding_distance) const override
+        {
+                T near;
+                T far = max_distance;
+                if (!clip_ray(ray, &near, &far))
+                {
+                        return {0, nullptr};
+                }
+                if (near <= 0)
+                {
+                        return shape_->intersect(ray, far, bounding_distance);
+                }
+                const numerical::Ray<N, T> clipped_ray = numerical::Ray<N, T>(ray).move(near);
+                ShapeIntersection<N, T, Color> res =
+                        shape_->intersect(clipped_ray, far - near, std::max(bounding_distance - near, T{0}));
+                res.distance += near;
+                return res;
+        }
+
+        [[nodiscard]] bool intersect_any(
+                const numerical::Ray<N, T>& ray,
+                const T max_distance,
+                const T bounding_distance) const override
+        {
+                T near;
+                T far = max_distance;
+                if (!clip_ray(ray, &near, &far))
+                {
+                        return false;
+                }
+                if (near <= 0)
+                {
+                        return shape_->intersect_any(ray, far, bounding_distance);
+                }
+                const numerical::Ray<N, T> clipped_ray = numerical::Ray<N, T>(ray).move(near);
+                return shape_->intersect_any(clipped_ray, far - near, std::max(bounding_distance - near, T{0}));
+        }
+
+        [[nodiscard]] geometry::spatial::BoundingBox<N, T> bounding_box() const override
+        {
+                return shape_->bounding_box();
+        }
+
+        [[nodiscard]] std::function<
+                bool(const geometry::spatial::ShapeOverlap<geometry::spatial::ParallelotopeAA<N, T>>&)>
+                overlap_function() const override
+        {
+                return shape_->overlap_function();
+        }
+
+public:
+        Impl(std::shared_ptr<const Shape<N, T, Color>>&& shape,
+             std::optional<geometry::spatial::ConvexPolytope<N, T>>&& clip_polytope)
+                : shape_(std::move(shape)),
+                  clip_polytope_(std::move(clip_polytope))
+        {
+                ASSERT(shape_);
+                ASSERT(USE_CLIP_POLYTOPE == clip_polytope_.has_value());
+        }
+};
+}
+
+template <std::size_t N, typename T, typename Color>
+std::unique_ptr<Shape<N, T, Color>> create_shared(std::shared_ptr<const Shape<N, T, Color>> shape)
+{
+        if (!shape)
+        {
+                error("No shape to share");
+        }
+        return std::make_unique<Impl<N, T, Color, false>>(std::move(shape), std::nullopt);
+}
+
+template <std::size_t N, typename T, typename Color>
+std::unique_ptr<Shape<N, T, Color>> create_shared(
+        std::shared_ptr<const Shape<N, T, Color>> shape,
+        const std::optional<numerical::Vector<N + 1, T>>& clip_plane_equation)
+{
+        if (!clip_plane_equation)
+        {
+                return create_shared(std::move(shape));
+        }
+        if (!shape)
+        {
+                error("No shape to share");
+        }
+        return std::make_unique<Impl<N, T, Color, true>>(
+                std::move(shape),
+                geometry::spatial::ConvexPolytope<N, T>{
+                        {geometry::spatial::clip_plane_equation_to_clip_plane(*clip_plane_equation)}});
+}
+
+#define TEMPLATE(N, T, C)                                                                                  \
+        template std::unique_ptr<Shape<(N), T, C>> create_shared(std::shared_ptr<const Shape<(N), T, C>>); \
+        template std::unique_ptr<Shape<(N), T, C>> create_shared(                                          \
+                std::shared_ptr<const Shape<(N), T, C>>, const std::optional<numerical::Vector<(N) + 1, T>>&);
+
+TEMPLATE_INSTANTIATION_N_T_C(TEMPLATE)
+}
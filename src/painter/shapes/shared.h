@@ -0,0 +1,41 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <src/numerical/vector.h>
+#include <src/painter/objects.h>
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+namespace ns::painter::shapes
+{
+// Scenes can use the same shape, for example,
+// a mesh painted with different clip planes
+template <std::size_t N, typename T, typename Color>
+std::unique_ptr<Shape<N, T, Color>> create_shared(std::shared_ptr<const Shape<N, T, Color>> shape);
+
+// The rays are clipped by the clip plane before they are passed
+// to the shape, the parts of the rays on the clipped side
+// do not traverse the shape and its BVH
+template <std::size_t N, typename T, typename Color>
+std::unique_ptr<Shape<N, T, Color>> create_shared(
+        std::shared_ptr<const Shape<N, T, Color>> shape,
+        const std::optional<numerical::Vector<N + 1, T>>& clip_plane_equation);
+}
@@ -17,6 +17,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <src/com/error.h>
 #include <src/geometry/core/convex_hull.h>
 #include <src/geometry/shapes/simplex_volume.h>
 #include <src/geometry/spatial/bounding_box.h>
@@ -35,8 +36,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <cmath>
 #include <cstddef>
 #include <memory>
-#include <optional>
 #include <random>
+#include <string_view>
 #include <vector>
 
 namespace ns::painter::shapes::test
@@ -133,6 +134,42 @@ float random_radius(RandomEngine& engine)
 }
 }
 
+inline std::string_view mesh_layout_name(const MeshLayout layout)
+{
+        switch (layout)
+        {
+        case MeshLayout::PLANES:
+                return "planes";
+        case MeshLayout::COMPACT:
+                return "compact";
+        }
+        error_fatal("Unknown mesh layout");
+}
+
+inline std::string_view mesh_bvh_name(const MeshBvh bvh)
+{
+        switch (bvh)
+        {
+        case MeshBvh::OBJECT_SPLITS:
+                return "object splits";
+        case MeshBvh::SPATIAL_SPLITS:
+                return "spatial splits";
+        }
+        error_fatal("Unknown mesh BVH");
+}
+
+inline std::string_view mesh_bvh_nodes_name(const MeshBvhNodes bvh_nodes)
+{
+        switch (bvh_nodes)
+        {
+        case MeshBvhNodes::FULL:
+                return "full nodes";
+        case MeshBvhNodes::QUANTIZED:
+                return "quantized nodes";
+        }
+        error_fatal("Unknown mesh BVH nodes");
+}
+
 template <std::size_t N, typename T, typename Color>
 struct SphericalMesh final
 {
@@ -145,6 +182,9 @@ struct SphericalMesh final
 template <std::size_t N, typename T, typename Color, typename RandomEngine>
 SphericalMesh<N, T, Color> create_spherical_mesh_scene(
         const int point_count,
+        const MeshLayout layout,
+        const MeshBvh bvh,
+        const MeshBvhNodes bvh_nodes,
         RandomEngine& engine,
         progress::Ratio* const progress)
 {
@@ -173,10 +213,8 @@ SphericalMesh<N, T, Color> create_spherical_mesh_scene(
         std::vector<const model::mesh::MeshObject<N>*> mesh_objects;
         mesh_objects.push_back(&mesh_object);
 
-        static constexpr std::optional<numerical::Vector<N + 1, T>> CLIP_PLANE_EQUATION;
-
         std::unique_ptr<const Shape<N, T, Color>> painter_mesh =
-                create_mesh<N, T, Color>(mesh_objects, CLIP_PLANE_EQUATION, impl::WRITE_LOG, progress);
+                create_mesh<N, T, Color>(mesh_objects, layout, bvh, bvh_nodes, impl::WRITE_LOG, progress);
 
         res.bounding_box = painter_mesh->bounding_box();
 
@@ -30,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/numerical/ray.h>
 #include <src/numerical/vector.h>
 #include <src/painter/objects.h>
+#include <src/painter/shapes/mesh.h>
 #include <src/progress/progress.h>
 #include <src/settings/dimensions.h>
 #include <src/test/test.h>
@@ -201,18 +202,26 @@ struct Parameters final
 };
 
 template <std::size_t N, typename T>
-void test(const Parameters& parameters, progress::Ratio* const progress)
+void test(
+        const Parameters& parameters,
+        const MeshLayout layout,
+        const MeshBvh bvh,
+        const MeshBvhNodes bvh_nodes,
+        progress::Ratio* const progress)
 {
         using Color = color::Spectrum;
 
-        const std::string name = "Test mesh intersections, " + space_name(N) + ", " + type_name<T>();
+        const std::string name = "Test mesh intersections, " + space_name(N) + ", " + type_name<T>() + ", "
+                                 + std::string(test::mesh_layout_name(layout)) + ", "
+                                 + std::string(test::mesh_bvh_name(bvh)) + ", "
+                                 + std::string(test::mesh_bvh_nodes_name(bvh_nodes));
 
         LOG(name);
 
         PCG engine;
 
-        const test::SphericalMesh<N, T, Color> mesh =
-                test::create_spherical_mesh_scene<N, T, Color>(parameters.point_count, engine, progress);
+        const test::SphericalMesh<N, T, Color> mesh = test::create_spherical_mesh_scene<N, T, Color>(
+                parameters.point_count, layout, bvh, bvh_nodes, engine, progress);
 
         test_intersections(
                 mesh, test::create_spherical_mesh_center_rays(mesh.bounding_box, parameters.ray_count, engine),
@@ -228,8 +237,17 @@ void test(const Parameters& parameters, progress::Ratio* const progress)
 template <std::size_t N>
 void test(const Parameters& parameters, progress::Ratio* const progress)
 {
-        test<N, float>(parameters, progress);
-        test<N, double>(parameters, progress);
+        for (const MeshLayout layout : {MeshLayout::PLANES, MeshLayout::COMPACT})
+        {
+                for (const MeshBvh bvh : {MeshBvh::OBJECT_SPLITS, MeshBvh::SPATIAL_SPLITS})
+                {
+                        for (const MeshBvhNodes bvh_nodes : {MeshBvhNodes::FULL, MeshBvhNodes::QUANTIZED})
+                        {
+                                test<N, float>(parameters, layout, bvh, bvh_nodes, progress);
+                                test<N, double>(parameters, layout, bvh, bvh_nodes, progress);
+                        }
+                }
+        }
 }
 
 template <std::size_t N>
@@ -30,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/numerical/ray.h>
 #include <src/numerical/vector.h>
 #include <src/painter/objects.h>
+#include <src/painter/shapes/mesh.h>
 #include <src/progress/progress.h>
 #include <src/settings/dimensions.h>
 #include <src/test/test.h>
@@ -88,7 +89,12 @@ void test_f(const test::SphericalMesh<N, T, Color>& mesh, const std::vector<nume
 }
 
 template <bool ANY, std::size_t N, typename T, typename Color>
-void test(const test::SphericalMesh<N, T, Color>& mesh, const std::vector<numerical::Ray<N, T>>& rays)
+void test(
+        const test::SphericalMesh<N, T, Color>& mesh,
+        const MeshLayout layout,
+        const MeshBvh bvh,
+        const MeshBvhNodes bvh_nodes,
+        const std::vector<numerical::Ray<N, T>>& rays)
 {
         const long long start_ray_count = mesh.scene.scene->thread_ray_count();
         const Clock::time_point start_time = Clock::now();
@@ -103,11 +109,16 @@ void test(const test::SphericalMesh<N, T, Color>& mesh, const std::vector<numeri
 
         std::string s;
         s += "Mesh intersections <" + space_name(N) + ", " + type_name<T>() + ">";
+        s += " " + std::string(test::mesh_layout_name(layout));
+        s += ", " + std::string(test::mesh_bvh_name(bvh));
+        s += ", " + std::string(test::mesh_bvh_nodes_name(bvh_nodes));
         if (ANY)
         {
                 s += " any";
         }
         s += ": " + to_string_digit_groups(mesh.facet_count) + " facets";
+        s += ", " + to_string(mesh_facet_size<N, T>(layout)) + " bytes per facet";
+        s += ", " + to_string(mesh_bvh_leaf_size<N, T>(bvh_nodes)) + " BVH bytes per leaf";
         s += ", " + to_string_digit_groups(std::llround(ray_count / duration)) + " o/s";
         LOG(s);
 }
@@ -123,13 +134,29 @@ void test(const Parameters& parameters, progress::Ratio* const progress)
 {
         using Color = color::Spectrum;
 
-        PCG engine;
-
-        const test::SphericalMesh<N, T, Color> mesh =
-                test::create_spherical_mesh_scene<N, T, Color>(parameters.point_count, engine, progress);
-
-        test<false>(mesh, test::create_spherical_mesh_center_rays(mesh.bounding_box, parameters.ray_count, engine));
-        test<true>(mesh, test::create_spherical_mesh_center_rays(mesh.bounding_box, parameters.ray_count, engine));
+        for (const MeshLayout layout : {MeshLayout::PLANES, MeshLayout::COMPACT})
+        {
+                for (const MeshBvh bvh : {MeshBvh::OBJECT_SPLITS, MeshBvh::SPATIAL_SPLITS})
+                {
+                        for (const MeshBvhNodes bvh_nodes : {MeshBvhNodes::FULL, MeshBvhNodes::QUANTIZED})
+                        {
+                                PCG engine;
+
+                                const test::SphericalMesh<N, T, Color> mesh =
+                                        test::create_spherical_mesh_scene<N, T, Color>(
+                                                parameters.point_count, layout, bvh, bvh_nodes, engine, progress);
+
+                                test<false>(
+                                        mesh, layout, bvh, bvh_nodes,
+                                        test::create_spherical_mesh_center_rays(
+                                                mesh.bounding_box, parameters.ray_count, engine));
+                                test<true>(
+                                        mesh, layout, bvh, bvh_nodes,
+                                        test::create_spherical_mesh_center_rays(
+                                                mesh.bounding_box, parameters.ray_count, engine));
+                        }
+                }
+        }
 }
 
 template <std::size_t N>
@@ -51,12 +51,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <filesystem>
 #include <memory>
 #include <optional>
 #include <random>
+#include <span>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -101,7 +103,12 @@ class Image final : public Notifier<N>
         std::unique_ptr<Images<N>> images_ = std::make_unique<Images<N>>();
         std::atomic_bool images_ready_ = false;
 
-        void thread_busy(unsigned, const std::array<int, N>&) override
+        [[nodiscard]] std::optional<std::chrono::milliseconds> pixel_notification_interval() const override
+        {
+                return std::nullopt;
+        }
+
+        void thread_busy(unsigned, const std::array<int, N>&, const std::array<int, N>&) override
         {
         }
 
@@ -109,7 +116,10 @@ class Image final : public Notifier<N>
         {
         }
 
-        void pixel_set(const std::array<int, N>&, const numerical::Vector<3, float>&) override
+        void pixels_set(
+                const std::array<int, N>&,
+                const std::array<int, N>&,
+                std::span<const numerical::Vector<3, float>>) override
         {
         }
 
@@ -144,8 +154,12 @@ public:
                 {
                         error("No painter image to write to files");
                 }
-                const ImagesWriting lock(images_.get());
-                save_image(path_, std::move(lock.image_with_background()));
+                image::Image<N> image;
+                {
+                        const ImagesReading lock(images_.get());
+                        image = lock.image_with_background();
+                }
+                save_image(path_, std::move(image));
         }
 };
 
@@ -202,6 +216,7 @@ std::unique_ptr<const model::mesh::Mesh<N>> file_mesh(const std::string& file_na
 template <std::size_t N, typename T, typename Color>
 void test_painter_file(const int samples_per_pixel, const int thread_count, scenes::StorageScene<N, T, Color>&& scene)
 {
+        constexpr int BPT_LIGHT_PATH_CONNECTION_COUNT = 4;
         constexpr int MAX_PASS_COUNT = 1;
         constexpr bool FLAT_SHADING = false;
 
@@ -211,8 +226,8 @@ void test_painter_file(const int samples_per_pixel, const int thread_count, scen
         const Clock::time_point start_time = Clock::now();
         {
                 std::unique_ptr<Painter> painter = create_painter(
-                        INTEGRATOR, &image, samples_per_pixel, MAX_PASS_COUNT, scene.scene.get(), thread_count,
-                        FLAT_SHADING);
+                        INTEGRATOR, &image, samples_per_pixel, BPT_LIGHT_PATH_CONNECTION_COUNT, MAX_PASS_COUNT,
+                        scene.scene.get(), std::nullopt, thread_count, FLAT_SHADING, std::nullopt);
                 painter->wait();
         }
         LOG("Painted, " + to_string_fixed(duration_from(start_time), 5) + " s");
@@ -262,9 +277,9 @@ void test_painter(
                 std::vector<const model::mesh::MeshObject<N>*> mesh_objects;
                 mesh_objects.push_back(&mesh_object);
 
-                static constexpr std::optional<numerical::Vector<N + 1, T>> CLIP_PLANE_EQUATION;
-
-                painter_mesh = shapes::create_mesh<N, T, Color>(mesh_objects, CLIP_PLANE_EQUATION, WRITE_LOG, progress);
+                painter_mesh = shapes::create_mesh<N, T, Color>(
+                        mesh_objects, shapes::MeshLayout::PLANES, shapes::MeshBvh::OBJECT_SPLITS,
+                        shapes::MeshBvhNodes::FULL, WRITE_LOG, progress);
         }
 
         scenes::StorageScene<N, T, Color> scene = scenes::create_simple_scene(
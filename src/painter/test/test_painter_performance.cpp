@@ -0,0 +1,358 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <src/color/color.h>
+#include <src/color/rgb8.h>
+#include <src/com/arrays.h>
+#include <src/com/chrono.h>
+#include <src/com/error.h>
+#include <src/com/log.h>
+#include <src/com/print.h>
+#include <src/com/thread.h>
+#include <src/com/type/name.h>
+#include <src/image/format.h>
+#include <src/image/image.h>
+#include <src/model/mesh.h>
+#include <src/model/mesh_object.h>
+#include <src/numerical/matrix.h>
+#include <src/numerical/vector.h>
+#include <src/painter/objects.h>
+#include <src/painter/painter.h>
+#include <src/painter/scenes/cornell_box.h>
+#include <src/painter/scenes/simple.h>
+#include <src/painter/scenes/storage.h>
+#include <src/painter/shapes/mesh.h>
+#include <src/progress/progress.h>
+#include <src/storage/repository/mesh_objects.h>
+#include <src/test/test.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ns::painter
+{
+namespace
+{
+constexpr color::RGB8 BACKGROUND_LIGHT(50, 100, 150);
+constexpr float LIGHTING_INTENSITY = 1;
+constexpr float FRONT_LIGHT_PROPORTION = 0.2;
+
+constexpr int SAMPLES_PER_PIXEL = 4;
+constexpr int BPT_LIGHT_PATH_CONNECTION_COUNT = 4;
+constexpr int MAX_PASS_COUNT = 2;
+constexpr bool FLAT_SHADING = false;
+
+constexpr bool WRITE_LOG = false;
+
+// The pixel samples are reproducible with the seed, but the order
+// of adding filtered samples from neighboring tiles depends on threads,
+// so the image mean is compared instead of a bitwise checksum
+constexpr std::uint_least32_t SEED = 1;
+
+constexpr std::string_view REPOSITORY_OBJECT_NAME = "Sphere";
+
+enum class SceneType
+{
+        CORNELL_BOX,
+        SIMPLE
+};
+
+std::string_view scene_type_name(const SceneType type)
+{
+        switch (type)
+        {
+        case SceneType::CORNELL_BOX:
+                return "cornell_box";
+        case SceneType::SIMPLE:
+                return "simple";
+        }
+        error_fatal("Unknown scene type");
+}
+
+std::string_view integrator_name(const Integrator integrator)
+{
+        switch (integrator)
+        {
+        case Integrator::BPT:
+                return "bpt";
+        case Integrator::PT:
+                return "pt";
+        }
+        error_fatal("Unknown integrator");
+}
+
+// Linux only, the peak resident set size is set to the current resident set size
+void reset_peak_memory()
+{
+#if defined(__linux__)
+        std::ofstream file("/proc/self/clear_refs");
+        file << "5";
+#endif
+}
+
+// Linux only, the peak resident set size of the process since the last reset
+std::optional<long long> peak_memory_kib()
+{
+#if defined(__linux__)
+        std::ifstream file("/proc/self/status");
+        std::string line;
+        while (std::getline(file, line))
+        {
+                constexpr std::string_view NAME = "VmHWM:";
+                if (line.starts_with(NAME))
+                {
+                        return std::stoll(line.substr(NAME.size()));
+                }
+        }
+#endif
+        return std::nullopt;
+}
+
+template <std::size_t N>
+numerical::Vector<3, double> image_mean(const image::Image<N>& image)
+{
+        ASSERT(image.color_format == image::ColorFormat::R32G32B32);
+
+        constexpr std::size_t PIXEL_SIZE = 3 * sizeof(float);
+        ASSERT(image.pixels.size() % PIXEL_SIZE == 0);
+
+        const std::size_t count = image.pixels.size() / PIXEL_SIZE;
+        ASSERT(count > 0);
+
+        numerical::Vector<3, double> sum(0);
+        numerical::Vector<3, float> rgb;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+                std::memcpy(&rgb, image.pixels.data() + i * PIXEL_SIZE, PIXEL_SIZE);
+                sum += to_vector<double>(rgb);
+        }
+        return sum / static_cast<double>(count);
+}
+
+template <std::size_t N>
+class Image final : public Notifier<N>
+{
+        std::unique_ptr<Images<N>> images_ = std::make_unique<Images<N>>();
+        std::atomic_bool images_ready_ = false;
+
+        [[nodiscard]] std::optional<std::chrono::milliseconds> pixel_notification_interval() const override
+        {
+                return std::nullopt;
+        }
+
+        void thread_busy(unsigned, const std::array<int, N>&, const std::array<int, N>&) override
+        {
+        }
+
+        void thread_free(unsigned) override
+        {
+        }
+
+        void pixels_set(
+                const std::array<int, N>&,
+                const std::array<int, N>&,
+                std::span<const numerical::Vector<3, float>>) override
+        {
+        }
+
+        Images<N>* images(long long) override
+        {
+                return images_.get();
+        }
+
+        void pass_done(long long) override
+        {
+                images_ready_ = true;
+        }
+
+        void error_message(const std::string& msg) override
+        {
+                LOG("Painter error message\n" + msg);
+        }
+
+public:
+        [[nodiscard]] numerical::Vector<3, double> mean() const
+        {
+                if (!images_ready_)
+                {
+                        error("No painter image");
+                }
+                const ImagesReading lock(images_.get());
+                return image_mean(lock.image_with_background());
+        }
+};
+
+template <std::size_t N, typename T, typename Color>
+scenes::StorageScene<N, T, Color> create_scene(
+        const SceneType scene_type,
+        const model::mesh::MeshObject<N>& mesh_object,
+        const int screen_size,
+        progress::Ratio* const progress)
+{
+        std::unique_ptr<const Shape<N, T, Color>> shape = shapes::create_mesh<N, T, Color>(
+                {&mesh_object}, shapes::MeshLayout::PLANES, shapes::MeshBvh::OBJECT_SPLITS, shapes::MeshBvhNodes::FULL,
+                WRITE_LOG, progress);
+
+        const Color light = Color::illuminant(LIGHTING_INTENSITY, LIGHTING_INTENSITY, LIGHTING_INTENSITY);
+        const Color background = Color::illuminant(BACKGROUND_LIGHT);
+
+        switch (scene_type)
+        {
+        case SceneType::CORNELL_BOX:
+                return scenes::create_cornell_box_scene(
+                        std::move(shape), light, background, std::nullopt, make_array_value<int, N - 1>(screen_size),
+                        progress);
+        case SceneType::SIMPLE:
+                return scenes::create_simple_scene(
+                        std::move(shape), light, background, std::nullopt, FRONT_LIGHT_PROPORTION, screen_size,
+                        progress);
+        }
+        error_fatal("Unknown scene type");
+}
+
+template <std::size_t N, typename T, typename Color>
+void test(
+        const Integrator integrator,
+        const SceneType scene_type,
+        const model::mesh::MeshObject<N>& mesh_object,
+        const int screen_size,
+        progress::Ratio* const progress)
+{
+        reset_peak_memory();
+
+        const scenes::StorageScene<N, T, Color> scene =
+                create_scene<N, T, Color>(scene_type, mesh_object, screen_size, progress);
+
+        const int thread_count = hardware_concurrency();
+
+        Image<N - 1> image;
+
+        const Clock::time_point start_time = Clock::now();
+        Statistics statistics;
+        {
+                const std::unique_ptr<Painter> painter = create_painter(
+                        integrator, &image, SAMPLES_PER_PIXEL, BPT_LIGHT_PATH_CONNECTION_COUNT, MAX_PASS_COUNT,
+                        scene.scene.get(), std::nullopt, thread_count, FLAT_SHADING, SEED);
+                painter->wait();
+                statistics = painter->statistics();
+        }
+        const double duration = duration_from(start_time);
+
+        const numerical::Vector<3, double> mean = image.mean();
+        const std::optional<long long> peak_memory = peak_memory_kib();
+
+        std::string s;
+        s += "{\"test\": \"painter\"";
+        s += ", \"integrator\": \"" + std::string(integrator_name(integrator)) + "\"";
+        s += ", \"scene\": \"" + std::string(scene_type_name(scene_type)) + "\"";
+        s += ", \"dimension\": " + to_string(N);
+        s += ", \"type\": \"" + std::string(type_name<T>()) + "\"";
+        s += ", \"color\": \"" + std::string(Color::name()) + "\"";
+        s += ", \"facets\": " + to_string(model::mesh::Reading(mesh_object).mesh().facets.size());
+        s += ", \"screen_size\": " + to_string(screen_size);
+        s += ", \"samples_per_pixel\": " + to_string(SAMPLES_PER_PIXEL);
+        s += ", \"bpt_light_path_connections\": " + to_string(BPT_LIGHT_PATH_CONNECTION_COUNT);
+        s += ", \"passes\": " + to_string(statistics.pass_number);
+        s += ", \"threads\": " + to_string(thread_count);
+        s += ", \"seed\": " + to_string(SEED);
+        s += ", \"seconds\": " + to_string_fixed(duration, 5);
+        s += ", \"rays_per_second\": " + to_string(std::llround(statistics.ray_count / duration));
+        s += ", \"samples_per_second\": " + to_string(std::llround(statistics.sample_count / duration));
+        s += ", \"peak_memory_kib\": " + (peak_memory ? to_string(*peak_memory) : std::string("null"));
+        s += ", \"image_mean\": [" + to_string_fixed(mean[0], 6) + ", " + to_string_fixed(mean[1], 6) + ", "
+             + to_string_fixed(mean[2], 6) + "]";
+        s += "}";
+        LOG(s);
+}
+
+template <std::size_t N, typename T>
+void test(
+        const SceneType scene_type,
+        const model::mesh::MeshObject<N>& mesh_object,
+        const int screen_size,
+        progress::Ratio* const progress)
+{
+        for (const Integrator integrator : {Integrator::PT, Integrator::BPT})
+        {
+                test<N, T, color::Color>(integrator, scene_type, mesh_object, screen_size, progress);
+                test<N, T, color::Spectrum>(integrator, scene_type, mesh_object, screen_size, progress);
+        }
+}
+
+struct Parameters final
+{
+        unsigned facet_count;
+        int screen_size;
+};
+
+template <std::size_t N>
+Parameters parameters()
+{
+        static_assert(N >= 3);
+        switch (N)
+        {
+        case 3:
+                return {.facet_count = 20'000, .screen_size = 250};
+        case 4:
+                return {.facet_count = 10'000, .screen_size = 40};
+        default:
+                return {.facet_count = 5'000, .screen_size = 16};
+        }
+}
+
+template <std::size_t N>
+void test(progress::Ratio* const progress)
+{
+        const Parameters p = parameters<N>();
+
+        const std::unique_ptr<const storage::repository::MeshObjects<N>> repository =
+                storage::repository::create_mesh_objects<N>();
+
+        const model::mesh::MeshObject<N> mesh_object(
+                repository->facet_object(std::string(REPOSITORY_OBJECT_NAME), p.facet_count),
+                numerical::IDENTITY_MATRIX<N + 1, double>, "");
+
+        for (const SceneType scene_type : {SceneType::CORNELL_BOX, SceneType::SIMPLE})
+        {
+                test<N, float>(scene_type, mesh_object, p.screen_size, progress);
+                test<N, double>(scene_type, mesh_object, p.screen_size, progress);
+        }
+}
+
+void test_performance(progress::Ratio* const progress)
+{
+        test<3>(progress);
+        test<4>(progress);
+        test<5>(progress);
+}
+
+TEST_PERFORMANCE("Painter", test_performance)
+}
+}
@@ -17,9 +17,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "compute_meshes.h"
 
+#include "manifold_constructor_cache.h"
+
 #include <src/com/chrono.h>
 #include <src/com/error.h>
 #include <src/com/log.h>
+#include <src/com/memory.h>
 #include <src/com/names.h>
 #include <src/com/print.h>
 #include <src/com/thread.h>
@@ -49,6 +52,10 @@ namespace
 {
 constexpr bool WRITE_LOG = true;
 
+// Delaunay objects and Voronoi poles are kept for repeated reconstructions
+// in the specified part of the physical memory
+constexpr std::size_t MANIFOLD_CONSTRUCTOR_CACHE_MEMORY_DIVISOR = 4;
+
 template <typename T>
 std::string bound_cocone_text_rho_alpha(const T rho, const T alpha)
 {
@@ -209,6 +216,14 @@ void mst(
         obj->insert(parent_id);
 }
 
+template <std::size_t N>
+ManifoldConstructorCache<N>& manifold_constructor_cache()
+{
+        static const std::shared_ptr<ManifoldConstructorCache<N>> cache = std::make_shared<ManifoldConstructorCache<N>>(
+                physical_memory_size() / MANIFOLD_CONSTRUCTOR_CACHE_MEMORY_DIVISOR);
+        return *cache;
+}
+
 template <std::size_t N>
 std::unique_ptr<geometry::reconstruction::ManifoldConstructor<N>> create_manifold_constructor(
         progress::RatioList* const progress_list,
@@ -226,25 +241,17 @@ std::unique_ptr<geometry::reconstruction::ManifoldConstructor<N>> create_manifol
 }
 
 template <std::size_t N>
-void manifold_constructor(
+void manifold_meshes(
         progress::RatioList* const progress_list,
         const bool build_cocone,
         const bool build_bound_cocone,
         const bool build_mst,
         const numerical::Matrix<N + 1, N + 1, double>& matrix,
         const model::ObjectId id,
-        const std::vector<numerical::Vector<N, float>>& points,
+        const geometry::reconstruction::ManifoldConstructor<N>& constructor,
         const double rho,
         const double alpha)
 {
-        if (!build_cocone && !build_bound_cocone && !build_mst)
-        {
-                return;
-        }
-
-        std::unique_ptr<const geometry::reconstruction::ManifoldConstructor<N>> manifold_constructor =
-                create_manifold_constructor(progress_list, points);
-
         Threads threads(3);
         try
         {
@@ -253,7 +260,7 @@ void manifold_constructor(
                         threads.add(
                                 [&]
                                 {
-                                        cocone(progress_list, id, *manifold_constructor, matrix);
+                                        cocone(progress_list, id, constructor, matrix);
                                 });
                 }
 
@@ -262,7 +269,7 @@ void manifold_constructor(
                         threads.add(
                                 [&]
                                 {
-                                        bound_cocone(progress_list, id, *manifold_constructor, matrix, rho, alpha);
+                                        bound_cocone(progress_list, id, constructor, matrix, rho, alpha);
                                 });
                 }
 
@@ -271,7 +278,7 @@ void manifold_constructor(
                         threads.add(
                                 [&]
                                 {
-                                        mst(progress_list, id, *manifold_constructor, matrix);
+                                        mst(progress_list, id, constructor, matrix);
                                 });
                 }
         }
@@ -282,6 +289,63 @@ void manifold_constructor(
         }
         threads.join();
 }
+
+template <std::size_t N>
+void manifold_constructor(
+        progress::RatioList* const progress_list,
+        const bool build_cocone,
+        const bool build_bound_cocone,
+        const bool build_mst,
+        const model::mesh::MeshObject<N>& mesh_object,
+        const double rho,
+        const double alpha)
+{
+        if (!build_cocone && !build_bound_cocone && !build_mst)
+        {
+                return;
+        }
+
+        std::optional<numerical::Matrix<N + 1, N + 1, double>> matrix;
+        std::optional<model::ObjectId> id;
+        std::optional<int> version;
+        std::shared_ptr<const geometry::reconstruction::ManifoldConstructor<N>> constructor;
+        std::vector<numerical::Vector<N, float>> points;
+        {
+                const model::mesh::Reading reading(mesh_object);
+                matrix = reading.matrix();
+                id = reading.id();
+                constructor = manifold_constructor_cache<N>().find(reading);
+                if (constructor)
+                {
+                        LOG("Manifold constructor found in cache");
+                }
+                else
+                {
+                        points = !reading.mesh().facets.empty() ? unique_facet_vertices(reading.mesh())
+                                                                : unique_point_vertices(reading.mesh());
+                        version = reading.version();
+                }
+        }
+
+        const bool cached = constructor != nullptr;
+        if (!cached)
+        {
+                constructor = create_manifold_constructor(progress_list, points);
+        }
+
+        manifold_meshes(
+                progress_list, build_cocone, build_bound_cocone, build_mst, *matrix, *id, *constructor, rho, alpha);
+
+        if (cached)
+        {
+                return;
+        }
+
+        // Attaching the cache entry locks the object for writing,
+        // so it is done after the meshes are created, not while
+        // the convex hull may be reading the object
+        manifold_constructor_cache<N>().insert(mesh_object, *id, *version, std::move(constructor));
+}
 }
 
 template <std::size_t N>
@@ -313,20 +377,9 @@ void compute_meshes(
                         threads.add(
                                 [&]
                                 {
-                                        std::optional<numerical::Matrix<N + 1, N + 1, double>> matrix;
-                                        std::optional<model::ObjectId> id;
-                                        std::vector<numerical::Vector<N, float>> points;
-                                        {
-                                                const model::mesh::Reading reading(mesh_object);
-                                                points = !reading.mesh().facets.empty()
-                                                                 ? unique_facet_vertices(reading.mesh())
-                                                                 : unique_point_vertices(reading.mesh());
-                                                matrix = reading.matrix();
-                                                id = reading.id();
-                                        }
                                         manifold_constructor(
-                                                progress_list, build_cocone, build_bound_cocone, build_mst, *matrix,
-                                                *id, points, rho, alpha);
+                                                progress_list, build_cocone, build_bound_cocone, build_mst,
+                                                mesh_object, rho, alpha);
                                 });
                 }
         }
@@ -0,0 +1,177 @@
+/*
+Copyright (C) 2017-2026 Topological Manifold
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <src/com/error.h>
+#include <src/geometry/reconstruction/cocone.h>
+#include <src/model/mesh_object.h>
+#include <src/model/object_id.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ns::process
+{
+// Constructors are evicted when their objects have mesh updates,
+// when the memory size is exceeded, and when their objects are destroyed
+template <std::size_t N>
+class ManifoldConstructorCache final : public std::enable_shared_from_this<ManifoldConstructorCache<N>>
+{
+        using Constructor = geometry::reconstruction::ManifoldConstructor<N>;
+
+        struct Entry final
+        {
+                model::ObjectId id;
+                int version;
+                std::shared_ptr<const Constructor> constructor;
+                std::size_t memory_size;
+                unsigned long long use;
+                unsigned long long generation;
+        };
+
+        const std::size_t max_memory_size_;
+
+        std::vector<Entry> entries_;
+        std::size_t memory_size_ = 0;
+        unsigned long long use_ = 0;
+        unsigned long long generation_ = 0;
+
+        std::mutex mutex_;
+
+        // the constructor is returned to be destroyed without the lock
+        [[nodiscard]] std::shared_ptr<const Constructor> erase(const typename std::vector<Entry>::iterator iter)
+        {
+                ASSERT(memory_size_ >= iter->memory_size);
+                memory_size_ -= iter->memory_size;
+                std::shared_ptr<const Constructor> res = std::move(iter->constructor);
+                entries_.erase(iter);
+                return res;
+        }
+
+        [[nodiscard]] std::shared_ptr<const Constructor> erase_least_recently_used()
+        {
+                ASSERT(!entries_.empty());
+                return erase(std::ranges::min_element(
+                        entries_,
+                        [](const Entry& a, const Entry& b)
+                        {
+                                return a.use < b.use;
+                        }));
+        }
+
+        void erase(const unsigned long long generation)
+        {
+                std::shared_ptr<const Constructor> constructor;
+                {
+                        const std::lock_guard lock(mutex_);
+                        const auto iter = std::ranges::find(entries_, generation, &Entry::generation);
+                        if (iter != entries_.end())
+                        {
+                                constructor = erase(iter);
+                        }
+                }
+        }
+
+public:
+        explicit ManifoldConstructorCache(const std::size_t max_memory_size)
+                : max_memory_size_(max_memory_size)
+        {
+        }
+
+        ManifoldConstructorCache(const ManifoldConstructorCache&) = delete;
+        ManifoldConstructorCache& operator=(const ManifoldConstructorCache&) = delete;
+        ManifoldConstructorCache(ManifoldConstructorCache&&) = delete;
+        ManifoldConstructorCache& operator=(ManifoldConstructorCache&&) = delete;
+
+        [[nodiscard]] std::shared_ptr<const Constructor> find(const model::mesh::Reading<N>& object)
+        {
+                std::shared_ptr<const Constructor> constructor;
+                {
+                        const std::lock_guard lock(mutex_);
+
+                        const auto iter = std::ranges::find(entries_, object.id(), &Entry::id);
+                        if (iter == entries_.end())
+                        {
+                                return nullptr;
+                        }
+
+                        if (!object.updates_after(iter->version)[model::mesh::UPDATE_MESH])
+                        {
+                                iter->version = object.version();
+                                iter->use = ++use_;
+                                return iter->constructor;
+                        }
+
+                        constructor = erase(iter);
+                }
+                return nullptr;
+        }
+
+        // The version is the object version at the time of reading the points.
+        // The object must not be locked by the calling thread
+        void insert(
+                const model::mesh::MeshObject<N>& object,
+                const model::ObjectId id,
+                const int version,
+                std::shared_ptr<const Constructor> constructor)
+        {
+                ASSERT(constructor);
+
+                const std::size_t memory_size = constructor->memory_size();
+
+                std::vector<std::shared_ptr<const Constructor>> erased;
+                unsigned long long generation;
+                {
+                        const std::lock_guard lock(mutex_);
+
+                        const auto iter = std::ranges::find(entries_, id, &Entry::id);
+                        if (iter != entries_.end())
+                        {
+                                erased.push_back(erase(iter));
+                        }
+
+                        if (memory_size > max_memory_size_)
+                        {
+                                return;
+                        }
+
+                        while (memory_size_ + memory_size > max_memory_size_)
+                        {
+                                erased.push_back(erase_least_recently_used());
+                        }
+
+                        generation = ++generation_;
+
+                        entries_.push_back(
+                                {.id = id,
+                                 .version = version,
+                                 .constructor = std::move(constructor),
+                                 .memory_size = memory_size,
+                                 .use = ++use_,
+                                 .generation = generation});
+                        memory_size_ += memory_size;
+                }
+
+                object.attach_eviction(this, &ManifoldConstructorCache::erase, generation);
+        }
+};
+}
@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/com/enum.h>
 #include <src/com/error.h>
 #include <src/com/exponent.h>
+#include <src/com/memory.h>
 #include <src/com/message.h>
 #include <src/com/print.h>
 #include <src/com/thread.h>
@@ -33,6 +34,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/gui/dialogs/painter_parameters_nd.h>
 #include <src/gui/painter_window/painter_window.h>
 #include <src/model/mesh_object.h>
+#include <src/model/object_id.h>
+#include <src/numerical/matrix.h>
 #include <src/numerical/vector.h>
 #include <src/painter/objects.h>
 #include <src/painter/painter.h>
@@ -40,6 +43,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <src/painter/scenes/simple.h>
 #include <src/painter/scenes/storage.h>
 #include <src/painter/shapes/mesh.h>
+#include <src/painter/shapes/shared.h>
 #include <src/progress/progress.h>
 #include <src/progress/progress_list.h>
 #include <src/storage/types.h>
@@ -50,6 +54,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <flat_set>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <tuple>
@@ -69,6 +74,17 @@ constexpr int SAMPLES_PER_PIXEL_MAXIMUM = power<N - 1>(10u);
 
 constexpr int SCREEN_SIZE_3D_MAXIMUM = 10000;
 
+// Large meshes use less memory with the compact layout
+// and with the quantized BVH nodes
+constexpr std::size_t COMPACT_MESH_FACET_COUNT = 5'000'000;
+
+// Spatial splits duplicate facet references and take longer to build
+constexpr std::size_t SPATIAL_SPLIT_MESH_FACET_COUNT = 1'000'000;
+
+// Painter meshes larger than the physical memory size
+// divided by this value are released with the painters
+constexpr std::size_t MESH_CACHE_MEMORY_DIVISOR = 4;
+
 constexpr int SCREEN_SIZE_ND_MINIMUM = 50;
 constexpr int SCREEN_SIZE_ND_MAXIMUM = 5000;
 template <std::size_t N>
@@ -167,10 +183,180 @@ std::optional<T> make_clip_plane_position(const view::info::ClipPlane& clip_plan
         return clip_plane.position;
 }
 
+template <std::size_t N>
+struct MeshKey final
+{
+        model::ObjectId id;
+        int version;
+        numerical::Matrix<N + 1, N + 1, double> matrix;
+        float alpha;
+        color::Color color;
+        float metalness;
+        float roughness;
+
+        explicit MeshKey(const model::mesh::Reading<N>& mesh)
+                : id(mesh.id()),
+                  version(mesh.version()),
+                  matrix(mesh.matrix()),
+                  alpha(mesh.alpha()),
+                  color(mesh.color()),
+                  metalness(mesh.metalness()),
+                  roughness(mesh.roughness())
+        {
+        }
+
+        // The mesh is not updated after the key version
+        // and the painted properties are equal
+        [[nodiscard]] bool matches(const model::mesh::Reading<N>& mesh) const
+        {
+                return id == mesh.id() && !mesh.updates_after(version)[model::mesh::UPDATE_MESH]
+                       && matrix == mesh.matrix() && alpha == mesh.alpha() && color == mesh.color()
+                       && metalness == mesh.metalness() && roughness == mesh.roughness();
+        }
+};
+
+template <std::size_t N>
+std::vector<MeshKey<N>> mesh_keys(const std::vector<std::shared_ptr<const model::mesh::MeshObject<N>>>& objects)
+{
+        std::vector<MeshKey<N>> res;
+        res.reserve(objects.size());
+        for (const std::shared_ptr<const model::mesh::MeshObject<N>>& object : objects)
+        {
+                res.emplace_back(model::mesh::Reading(*object));
+        }
+        return res;
+}
+
+// The painter mesh of the last painted objects is kept,
+// so painting with another clip plane does not rebuild
+// the mesh and its BVH. Clip planes are applied by scenes
+// and shared shapes.
+// The mesh is held strongly if its memory size is within
+// the maximum size, otherwise it is held weakly and is released
+// with the painters that use it.
+// The mesh is evicted when it is looked up with other objects
+// or after their mesh updates, and when any of its objects
+// is destroyed
 template <std::size_t N, typename T, typename Color>
-std::unique_ptr<const painter::Shape<N, T, Color>> make_shape(
+class MeshCache final : public std::enable_shared_from_this<MeshCache<N, T, Color>>
+{
+        const std::size_t max_memory_size_;
+
+        std::vector<MeshKey<N>> keys_;
+        std::shared_ptr<const painter::Shape<N, T, Color>> mesh_;
+        std::weak_ptr<const painter::Shape<N, T, Color>> weak_mesh_;
+        unsigned long long generation_ = 0;
+        std::mutex mutex_;
+
+        [[nodiscard]] bool matches(const std::vector<std::shared_ptr<const model::mesh::MeshObject<N>>>& objects) const
+        {
+                if (keys_.size() != objects.size())
+                {
+                        return false;
+                }
+                for (std::size_t i = 0; i < objects.size(); ++i)
+                {
+                        if (!keys_[i].matches(model::mesh::Reading(*objects[i])))
+                        {
+                                return false;
+                        }
+                }
+                return true;
+        }
+
+        void erase(const unsigned long long generation)
+        {
+                // the mesh is destroyed without the lock
+                std::shared_ptr<const painter::Shape<N, T, Color>> mesh;
+                {
+                        const std::lock_guard lg(mutex_);
+                        if (generation != generation_)
+                        {
+                                return;
+                        }
+                        keys_.clear();
+                        mesh = std::move(mesh_);
+                        weak_mesh_.reset();
+                }
+        }
+
+public:
+        explicit MeshCache(const std::size_t max_memory_size)
+                : max_memory_size_(max_memory_size)
+        {
+        }
+
+        MeshCache(const MeshCache&) = delete;
+        MeshCache& operator=(const MeshCache&) = delete;
+        MeshCache(MeshCache&&) = delete;
+        MeshCache& operator=(MeshCache&&) = delete;
+
+        // The objects must not be locked by the calling thread
+        [[nodiscard]] std::shared_ptr<const painter::Shape<N, T, Color>> find(
+                const std::vector<std::shared_ptr<const model::mesh::MeshObject<N>>>& objects)
+        {
+                // the mesh of other objects is evicted before
+                // the new mesh is created
+                std::shared_ptr<const painter::Shape<N, T, Color>> mesh;
+                {
+                        const std::lock_guard lg(mutex_);
+                        if (matches(objects))
+                        {
+                                return mesh_ ? mesh_ : weak_mesh_.lock();
+                        }
+                        keys_.clear();
+                        mesh = std::move(mesh_);
+                        weak_mesh_.reset();
+                }
+                return nullptr;
+        }
+
+        // The keys are read from the objects before the mesh is created
+        void insert(
+                const std::vector<std::shared_ptr<const model::mesh::MeshObject<N>>>& objects,
+                std::vector<MeshKey<N>>&& keys,
+                std::shared_ptr<const painter::Shape<N, T, Color>> mesh,
+                const std::size_t memory_size)
+        {
+                unsigned long long generation;
+                {
+                        const std::lock_guard lg(mutex_);
+                        keys_ = std::move(keys);
+                        weak_mesh_ = mesh;
+                        std::swap(mesh_, mesh);
+                        if (memory_size > max_memory_size_)
+                        {
+                                mesh_.reset();
+                        }
+                        generation = ++generation_;
+                }
+
+                for (const std::shared_ptr<const model::mesh::MeshObject<N>>& object : objects)
+                {
+                        object->attach_eviction(this, &MeshCache::erase, generation);
+                }
+        }
+};
+
+// The memory size of the facets, vertices and BVH nodes
+// without the references of spatial splits
+template <std::size_t N, typename T>
+[[nodiscard]] std::size_t mesh_memory_size(
+        const std::size_t facet_count,
+        const std::size_t vertex_count,
+        const painter::shapes::MeshLayout layout,
+        const painter::shapes::MeshBvhNodes bvh_nodes)
+{
+        return facet_count
+                       * (painter::shapes::mesh_facet_size<N, T>(layout)
+                          + painter::shapes::mesh_bvh_leaf_size<N, T>(bvh_nodes))
+               + vertex_count * sizeof(numerical::Vector<N, T>);
+}
+
+template <std::size_t N, typename T, typename Color>
+std::shared_ptr<const painter::Shape<N, T, Color>> make_mesh(
         const std::vector<std::shared_ptr<const model::mesh::MeshObject<N>>>& objects,
-        const std::optional<numerical::Vector<N + 1, T>>& clip_plane_equation,
+        std::size_t* const memory_size,
         progress::RatioList* const progress_list)
 {
         constexpr bool WRITE_LOG = true;
@@ -178,14 +364,53 @@ std::unique_ptr<const painter::Shape<N, T, Color>> make_shape(
         std::vector<const model::mesh::MeshObject<N>*> meshes;
         meshes.reserve(objects.size());
 
+        std::size_t facet_count = 0;
+        std::size_t vertex_count = 0;
         for (const std::shared_ptr<const model::mesh::MeshObject<N>>& object : objects)
         {
                 meshes.push_back(object.get());
+                const model::mesh::Reading reading(*object);
+                facet_count += reading.mesh().facets.size();
+                vertex_count += reading.mesh().vertices.size();
         }
 
+        const painter::shapes::MeshLayout layout = (facet_count >= COMPACT_MESH_FACET_COUNT)
+                                                           ? painter::shapes::MeshLayout::COMPACT
+                                                           : painter::shapes::MeshLayout::PLANES;
+
+        const painter::shapes::MeshBvh bvh = (facet_count < SPATIAL_SPLIT_MESH_FACET_COUNT)
+                                                     ? painter::shapes::MeshBvh::SPATIAL_SPLITS
+                                                     : painter::shapes::MeshBvh::OBJECT_SPLITS;
+
+        const painter::shapes::MeshBvhNodes bvh_nodes = (facet_count >= COMPACT_MESH_FACET_COUNT)
+                                                                ? painter::shapes::MeshBvhNodes::QUANTIZED
+                                                                : painter::shapes::MeshBvhNodes::FULL;
+
+        *memory_size = mesh_memory_size<N, T>(facet_count, vertex_count, layout, bvh_nodes);
+
         progress::Ratio progress(progress_list);
 
-        return painter::shapes::create_mesh<N, T, Color>(meshes, clip_plane_equation, WRITE_LOG, &progress);
+        return painter::shapes::create_mesh<N, T, Color>(meshes, layout, bvh, bvh_nodes, WRITE_LOG, &progress);
+}
+
+template <std::size_t N, typename T, typename Color>
+std::unique_ptr<const painter::Shape<N, T, Color>> make_shape(
+        const std::vector<std::shared_ptr<const model::mesh::MeshObject<N>>>& objects,
+        progress::RatioList* const progress_list)
+{
+        static const std::shared_ptr<MeshCache<N, T, Color>> cache =
+                std::make_shared<MeshCache<N, T, Color>>(physical_memory_size() / MESH_CACHE_MEMORY_DIVISOR);
+
+        std::shared_ptr<const painter::Shape<N, T, Color>> mesh = cache->find(objects);
+        if (!mesh)
+        {
+                std::vector<MeshKey<N>> keys = mesh_keys(objects);
+                std::size_t memory_size;
+                mesh = make_mesh<N, T, Color>(objects, &memory_size, progress_list);
+                cache->insert(objects, std::move(keys), mesh, memory_size);
+        }
+
+        return painter::shapes::create_shared(std::move(mesh));
 }
 
 template <std::size_t N, typename T, typename Color>
@@ -206,7 +431,7 @@ painter::scenes::StorageScene<N, T, Color> make_scene(
         if (parameters.cornell_box)
         {
                 return painter::scenes::create_cornell_box_scene(
-                        std::move(shape), light, background_light,
+                        std::move(shape), light, background_light, clip_plane_equation,
                         {dimension_parameters.width, dimension_parameters.height}, &progress);
         }
 
@@ -228,14 +453,14 @@ painter::scenes::StorageScene<N, T, Color> make_scene(
         const Color& background_light,
         const gui::dialogs::PainterParameters& parameters,
         const gui::dialogs::PainterParametersNd& dimension_parameters,
-        const std::optional<numerical::Vector<N + 1, T>>& /*clip_plane_equation*/)
+        const std::optional<numerical::Vector<N + 1, T>>& clip_plane_equation)
 {
         progress::Ratio progress(nullptr);
 
         if (parameters.cornell_box)
         {
                 return painter::scenes::create_cornell_box_scene(
-                        std::move(shape), light, background_light,
+                        std::move(shape), light, background_light, clip_plane_equation,
                         make_array_value<int, N - 1>(dimension_parameters.max_size), &progress);
         }
 
@@ -258,8 +483,7 @@ void thread_function(
 {
         const auto clip_plane_equation = make_clip_plane_equation<N, T>(clip_plane);
 
-        std::unique_ptr<const painter::Shape<N, T, Color>> shape =
-                make_shape<N, T, Color>(objects, clip_plane_equation, progress_list);
+        std::unique_ptr<const painter::Shape<N, T, Color>> shape = make_shape<N, T, Color>(objects, progress_list);
 
         if (!shape)
         {
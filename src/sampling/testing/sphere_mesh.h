@@ -107,7 +107,7 @@ class SphereMesh final
 public:
         SphereMesh(const unsigned facet_min_count, progress::Ratio* const progress)
                 : sphere_(facet_min_count),
-                  bvh_(sphere_.bvh_objects(), progress)
+                  bvh_(sphere_.bvh_objects(), geometry::accelerators::BvhNodeFormat::FULL, progress)
         {
         }
 